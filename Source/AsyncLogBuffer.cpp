@@ -0,0 +1,282 @@
+#include "pch.hpp"
+#include "AsyncLogBuffer.h"
+#include <bit>
+#include <system_error>
+
+namespace
+{
+	constexpr size_t g_MinSlotCount = 16;
+	constexpr size_t g_StagingSize = 64 * 1024;
+
+	// How many times a producer retries when the buffer is full and someone else is draining it, the message is dropped after that
+	constexpr size_t g_MaxWriteAttempts = 100000;
+}
+
+namespace xSE
+{
+	bool AsyncLogBuffer::TryEnqueue(std::span<const std::byte> data)
+	{
+		const uint64_t mask = m_SlotCount - 1;
+		const size_t count = (data.size() + SlotSize - 1) / SlotSize;
+
+		// Slots are released by the consumer strictly in order, so if the last slot we need is free, all the previous ones are free too
+		uint64_t position = m_EnqueuePosition.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			const uint64_t lastPosition = position + count - 1;
+			const uint64_t sequence = m_Slots[lastPosition & mask].Sequence.load(std::memory_order_acquire);
+			const auto difference = static_cast<int64_t>(sequence - lastPosition);
+
+			if (difference == 0)
+			{
+				if (m_EnqueuePosition.compare_exchange_weak(position, position + count, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (difference < 0)
+			{
+				return false;
+			}
+			else
+			{
+				position = m_EnqueuePosition.load(std::memory_order_relaxed);
+			}
+		}
+
+		for (size_t i = 0; i < count; i++)
+		{
+			Slot& slot = m_Slots[(position + i) & mask];
+			const size_t offset = i * SlotSize;
+			const size_t length = std::min(SlotSize, data.size() - offset);
+
+			std::memcpy(slot.Data, data.data() + offset, length);
+			slot.Length = static_cast<uint32_t>(length);
+			slot.Sequence.store(position + i + 1, std::memory_order_release);
+		}
+		return true;
+	}
+	void AsyncLogBuffer::NotifyIfNeeded()
+	{
+		const uint64_t used = m_EnqueuePosition.load(std::memory_order_relaxed) - m_DequeuePosition.load(std::memory_order_relaxed);
+		if (used >= m_SlotCount / 2)
+		{
+			m_WakeCondition.notify_one();
+		}
+	}
+
+	bool AsyncLogBuffer::AcquireDrainLock(Clock::duration timeout) noexcept
+	{
+		const auto deadline = Clock::now() + timeout;
+		while (!TryAcquireDrainLock())
+		{
+			if (Clock::now() >= deadline)
+			{
+				return false;
+			}
+			std::this_thread::yield();
+		}
+		return true;
+	}
+	bool AsyncLogBuffer::DoDrain()
+	{
+		bool result = true;
+		auto WriteStaging = [&]()
+		{
+			if (!m_Staging.empty())
+			{
+				if (m_Sink && !m_Sink(m_Staging))
+				{
+					result = false;
+				}
+				m_Staging.clear();
+			}
+		};
+
+		// Stops at the first slot that isn't published yet, even if there are published ones after it
+		const uint64_t mask = m_SlotCount - 1;
+		uint64_t position = m_DequeuePosition.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			Slot& slot = m_Slots[position & mask];
+			if (slot.Sequence.load(std::memory_order_acquire) != position + 1)
+			{
+				break;
+			}
+
+			if (m_Staging.size() + slot.Length > m_Staging.capacity())
+			{
+				WriteStaging();
+			}
+			m_Staging.insert(m_Staging.end(), slot.Data, slot.Data + slot.Length);
+
+			slot.Sequence.store(position + m_SlotCount, std::memory_order_release);
+			m_DequeuePosition.store(++position, std::memory_order_relaxed);
+		}
+		WriteStaging();
+
+		return result;
+	}
+
+	void AsyncLogBuffer::ThreadEntry()
+	{
+		while (!m_StopRequested)
+		{
+			{
+				std::unique_lock lock(m_WakeLock);
+				m_WakeCondition.wait_for(lock, m_FlushInterval, [&]()
+				{
+					return m_StopRequested || m_EnqueuePosition - m_DequeuePosition >= m_SlotCount / 2;
+				});
+			}
+
+			if (TryAcquireDrainLock())
+			{
+				DoDrain();
+				ReleaseDrainLock();
+			}
+		}
+		m_ThreadFinished = true;
+	}
+
+	AsyncLogBuffer::AsyncLogBuffer(Sink sink, size_t slotCount)
+		:m_SlotCount(std::bit_ceil(std::max(slotCount, g_MinSlotCount))), m_Sink(std::move(sink))
+	{
+		m_Slots = std::make_unique<Slot[]>(m_SlotCount);
+		for (size_t i = 0; i < m_SlotCount; i++)
+		{
+			m_Slots[i].Sequence.store(i, std::memory_order_relaxed);
+		}
+		m_Staging.reserve(g_StagingSize);
+	}
+	AsyncLogBuffer::~AsyncLogBuffer()
+	{
+		Shutdown();
+	}
+
+	bool AsyncLogBuffer::Start(Clock::duration flushInterval)
+	{
+		if (m_IsAsync || m_Thread.joinable())
+		{
+			return m_IsAsync;
+		}
+
+		try
+		{
+			m_FlushInterval = flushInterval;
+			m_Thread = std::thread(&AsyncLogBuffer::ThreadEntry, this);
+			m_IsAsync = true;
+
+			return true;
+		}
+		catch (const std::system_error&)
+		{
+			return false;
+		}
+	}
+	void AsyncLogBuffer::Write(std::span<const std::byte> data)
+	{
+		if (data.empty())
+		{
+			return;
+		}
+
+		if (!m_IsAsync)
+		{
+			// Anything still queued must go first
+			if (AcquireDrainLock(std::chrono::seconds(1)))
+			{
+				DoDrain();
+				if (m_Sink)
+				{
+					m_Sink(data);
+				}
+				ReleaseDrainLock();
+			}
+			else
+			{
+				m_DroppedCount++;
+			}
+			return;
+		}
+
+		// Anything that wouldn't fit even into a half of an empty buffer is cut
+		const size_t maxSize = (m_SlotCount / 2) * SlotSize;
+		if (data.size() > maxSize)
+		{
+			data = data.first(maxSize);
+			m_TruncatedCount++;
+		}
+
+		for (size_t attempt = 0; ; attempt++)
+		{
+			if (TryEnqueue(data))
+			{
+				NotifyIfNeeded();
+				return;
+			}
+
+			// The buffer is full. Drain it from here if the background thread isn't doing that already: it might be falling behind
+			// or not running at all yet, new threads can't start until the loader lock is released.
+			if (TryAcquireDrainLock())
+			{
+				m_InlineDrainCount++;
+				DoDrain();
+				ReleaseDrainLock();
+			}
+			else if (attempt >= g_MaxWriteAttempts)
+			{
+				m_DroppedCount++;
+				return;
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+	bool AsyncLogBuffer::Flush(Clock::duration timeout)
+	{
+		if (AcquireDrainLock(timeout))
+		{
+			const bool result = DoDrain();
+			ReleaseDrainLock();
+
+			return result;
+		}
+		return false;
+	}
+	void AsyncLogBuffer::Shutdown(Clock::duration timeout)
+	{
+		if (m_Thread.joinable())
+		{
+			m_StopRequested = true;
+			m_WakeCondition.notify_all();
+		}
+
+		// Take over as the consumer, all further writes are going to be synchronous. If the lock can't be taken in time,
+		// the thread is gone without releasing it (the process is being terminated), so proceed anyway.
+		AcquireDrainLock(timeout);
+		m_IsAsync = false;
+		DoDrain();
+		ReleaseDrainLock();
+
+		if (m_Thread.joinable())
+		{
+			const auto deadline = Clock::now() + timeout;
+			while (!m_ThreadFinished && Clock::now() < deadline)
+			{
+				std::this_thread::yield();
+			}
+			m_Thread.detach();
+		}
+	}
+	void AsyncLogBuffer::SetSink(Sink sink)
+	{
+		// Same as in 'Shutdown', the old sink gets everything queued so far
+		AcquireDrainLock(std::chrono::seconds(1));
+		DoDrain();
+		m_Sink = std::move(sink);
+		ReleaseDrainLock();
+	}
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <memory>
+#include <functional>
+#include <span>
+#include <vector>
+
+// Bounded multi-producer queue for log output, written to the sink by a background thread. Doesn't depend
+// on Windows headers or KxFramework, the caller provides the sink and decides when to start and stop it.
+namespace xSE
+{
+	class AsyncLogBuffer final
+	{
+		public:
+			using Sink = std::function<bool(std::span<const std::byte>)>;
+			using Clock = std::chrono::steady_clock;
+
+			static constexpr size_t SlotSize = 256;
+			static constexpr size_t DefaultSlotCount = 2048;
+
+		private:
+			// Messages longer than a slot occupy several consecutive slots, so they stay contiguous in the output
+			struct alignas(64) Slot final
+			{
+				std::atomic<uint64_t> Sequence = 0;
+				uint32_t Length = 0;
+				std::byte Data[SlotSize] = {};
+			};
+
+		private:
+			std::unique_ptr<Slot[]> m_Slots;
+			size_t m_SlotCount = 0;
+			Sink m_Sink;
+			std::vector<std::byte> m_Staging;
+
+			alignas(64) std::atomic<uint64_t> m_EnqueuePosition = 0;
+			alignas(64) std::atomic<uint64_t> m_DequeuePosition = 0;
+
+			// Whoever holds this flag is the (only) consumer: the background thread or a producer that found the buffer full
+			alignas(64) std::atomic<bool> m_DrainLock = false;
+
+			std::thread m_Thread;
+			std::mutex m_WakeLock;
+			std::condition_variable m_WakeCondition;
+			Clock::duration m_FlushInterval = std::chrono::milliseconds(50);
+			std::atomic<bool> m_IsAsync = false;
+			std::atomic<bool> m_StopRequested = false;
+			std::atomic<bool> m_ThreadFinished = false;
+
+			std::atomic<size_t> m_DroppedCount = 0;
+			std::atomic<size_t> m_TruncatedCount = 0;
+			std::atomic<size_t> m_InlineDrainCount = 0;
+
+		private:
+			bool TryEnqueue(std::span<const std::byte> data);
+			void NotifyIfNeeded();
+
+			bool TryAcquireDrainLock() noexcept
+			{
+				return !m_DrainLock.exchange(true, std::memory_order_acquire);
+			}
+			bool AcquireDrainLock(Clock::duration timeout) noexcept;
+			void ReleaseDrainLock() noexcept
+			{
+				m_DrainLock.store(false, std::memory_order_release);
+			}
+			bool DoDrain();
+
+			void ThreadEntry();
+
+		public:
+			AsyncLogBuffer(Sink sink, size_t slotCount = DefaultSlotCount);
+			AsyncLogBuffer(const AsyncLogBuffer&) = delete;
+			~AsyncLogBuffer();
+
+		public:
+			bool IsAsync() const noexcept
+			{
+				return m_IsAsync;
+			}
+			size_t GetCapacity() const noexcept
+			{
+				return m_SlotCount * SlotSize;
+			}
+			size_t GetDroppedCount() const noexcept
+			{
+				return m_DroppedCount;
+			}
+			size_t GetTruncatedCount() const noexcept
+			{
+				return m_TruncatedCount;
+			}
+			size_t GetInlineDrainCount() const noexcept
+			{
+				return m_InlineDrainCount;
+			}
+
+			// Until 'Start' is called (and after 'Shutdown') messages are written to the sink synchronously
+			bool Start(Clock::duration flushInterval = std::chrono::milliseconds(50));
+			void Write(std::span<const std::byte> data);
+
+			// Writes everything queued so far, gives up if another consumer doesn't finish within the timeout
+			bool Flush(Clock::duration timeout = std::chrono::milliseconds(250));
+
+			// Stops the background thread without joining it (this is usually called from 'DllMain'), drains the queue
+			// and switches to the synchronous mode. If the thread doesn't let go in time the queue is drained anyway,
+			// which is only safe when the process is being terminated and the thread is already gone.
+			void Shutdown(Clock::duration timeout = std::chrono::milliseconds(250));
+			void SetSink(Sink sink);
+
+			AsyncLogBuffer& operator=(const AsyncLogBuffer&) = delete;
+	};
+}
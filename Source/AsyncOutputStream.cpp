@@ -0,0 +1,49 @@
+#include "pch.hpp"
+#include "AsyncOutputStream.h"
+
+namespace xSE
+{
+	bool AsyncOutputStream::WriteToTarget(std::span<const std::byte> data)
+	{
+		// Qualified calls, the virtual 'Write' of this class would put the data back to the queue
+		while (!data.empty())
+		{
+			OutputStreamDelegate::Write(data.data(), data.size());
+
+			const size_t written = OutputStreamDelegate::LastWrite().ToBytes();
+			if (written == 0 || written > data.size())
+			{
+				return false;
+			}
+			data = data.subspan(written);
+		}
+		return true;
+	}
+
+	AsyncOutputStream::AsyncOutputStream(std::unique_ptr<kxf::IOutputStream> stream, size_t slotCount)
+		:OutputStreamDelegate(std::move(stream))
+	{
+		m_Buffer = std::make_shared<AsyncLogBuffer>([this](std::span<const std::byte> data)
+		{
+			return WriteToTarget(data);
+		}, slotCount);
+	}
+	AsyncOutputStream::~AsyncOutputStream()
+	{
+		m_Buffer->Shutdown();
+		m_Buffer->SetSink({});
+		OutputStreamDelegate::Flush();
+	}
+
+	kxf::IOutputStream& AsyncOutputStream::Write(const void* buffer, size_t size)
+	{
+		m_Buffer->Write({static_cast<const std::byte*>(buffer), size});
+		m_LastWrite.store(size, std::memory_order_relaxed);
+
+		return *this;
+	}
+	bool AsyncOutputStream::Flush()
+	{
+		return m_Buffer->Flush() && OutputStreamDelegate::Flush();
+	}
+}
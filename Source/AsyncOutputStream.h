@@ -0,0 +1,45 @@
+#pragma once
+#include "Framework.hpp"
+#include "AsyncLogBuffer.h"
+#include <kxf/IO/StreamDelegate.h>
+#include <atomic>
+
+namespace xSE
+{
+	// Output stream for the log file which queues writes to 'AsyncLogBuffer' instead of writing them to the file right away.
+	// The buffer can outlive the stream (it's shared with the preload handler), but it won't write anything after the stream is gone.
+	class AsyncOutputStream final: public kxf::OutputStreamDelegate
+	{
+		private:
+			std::shared_ptr<AsyncLogBuffer> m_Buffer;
+
+			// Every logging thread writes it, the value is only meaningful to the thread which has just written
+			std::atomic<size_t> m_LastWrite = 0;
+
+		private:
+			bool WriteToTarget(std::span<const std::byte> data);
+
+		public:
+			AsyncOutputStream(std::unique_ptr<kxf::IOutputStream> stream, size_t slotCount = AsyncLogBuffer::DefaultSlotCount);
+			AsyncOutputStream(const AsyncOutputStream&) = delete;
+			~AsyncOutputStream();
+
+		public:
+			const std::shared_ptr<AsyncLogBuffer>& GetBuffer() const noexcept
+			{
+				return m_Buffer;
+			}
+
+		public:
+			// IOutputStream
+			kxf::DataSize LastWrite() const override
+			{
+				return kxf::DataSize::FromBytes(m_LastWrite.load(std::memory_order_relaxed));
+			}
+			kxf::IOutputStream& Write(const void* buffer, size_t size) override;
+			bool Flush() override;
+
+		public:
+			AsyncOutputStream& operator=(const AsyncOutputStream&) = delete;
+	};
+}
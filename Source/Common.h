@@ -10,4 +10,7 @@ namespace xSE::LogCategory
 	KX_DefineLogCategory(ImportAddressHook);
 	KX_DefineLogCategory(CurrentModule);
 	KX_DefineLogCategory(HostProcess);
+	KX_DefineLogCategory(Dependencies);
+	KX_DefineLogCategory(ExportCalls);
+	KX_DefineLogCategory(Exceptions);
 }
@@ -12,11 +12,11 @@ BOOL APIENTRY DllMain(HMODULE handle, DWORD event, LPVOID lpReserved)
 			return FALSE;
 		}
 
-		return handler.OnDLLMain(handle, event) ? TRUE : FALSE;
+		return handler.OnDLLMain(handle, event, lpReserved) ? TRUE : FALSE;
 	}
 	else if (auto instance = xSE::PreloadHandler::GetInstance())
 	{
-		return instance->OnDLLMain(handle, event) ? TRUE : FALSE;
+		return instance->OnDLLMain(handle, event, lpReserved) ? TRUE : FALSE;
 	}
 	return FALSE;
 }
@@ -1,5 +1,6 @@
 #include "pch.hpp"
 #include "Detour.h"
+#include "ImportIndex.h"
 
 #include "Nukem Detours/Detours.h"
 #if _WIN64
@@ -18,12 +19,107 @@ using NukemDetoursOpt = Detours::X86Option;
 
 #endif
 
+namespace
+{
+	struct ModuleImports final
+	{
+		xSE::PE::ImageReader Image;
+		xSE::PE::ImportIndex Index;
+	};
+
+	std::mutex g_ModuleImportsLock;
+	std::map<HMODULE, std::unique_ptr<ModuleImports>> g_ModuleImports;
+
+	const xSE::PE::ImportIndex* GetImportIndex(HMODULE module)
+	{
+		std::lock_guard lock(g_ModuleImportsLock);
+
+		auto& imports = g_ModuleImports[module];
+		if (!imports)
+		{
+			auto base = reinterpret_cast<const std::byte*>(module);
+			const auto dosHeader = reinterpret_cast<const IMAGE_DOS_HEADER*>(base);
+			const auto ntHeaders = reinterpret_cast<const IMAGE_NT_HEADERS*>(base + dosHeader->e_lfanew);
+
+			imports = std::make_unique<ModuleImports>();
+			imports->Image = xSE::PE::ImageReader({base, ntHeaders->OptionalHeader.SizeOfImage}, xSE::PE::Layout::Image);
+			imports->Index = xSE::PE::ImportIndex(imports->Image);
+		}
+		return &imports->Index;
+	}
+	DWORD GetWritableProtection(void* address) noexcept
+	{
+		// Some executables have the import address table in an executable section, it has to stay executable
+		MEMORY_BASIC_INFORMATION info = {};
+		if (::VirtualQuery(address, &info, sizeof(info)) != 0)
+		{
+			constexpr DWORD executable = PAGE_EXECUTE|PAGE_EXECUTE_READ|PAGE_EXECUTE_READWRITE|PAGE_EXECUTE_WRITECOPY;
+			if (info.Protect & executable)
+			{
+				return PAGE_EXECUTE_READWRITE;
+			}
+		}
+		return PAGE_READWRITE;
+	}
+}
+
+namespace xSE::Detour
+{
+	bool PatchIAT(HMODULE module, IATPatch& patch) noexcept
+	{
+		if (!module)
+		{
+			module = ::GetModuleHandleW(nullptr);
+		}
+		patch.Original = nullptr;
+
+		try
+		{
+			auto rva = GetImportIndex(module)->FindSlot(patch.LibraryName, patch.FunctionName);
+			if (!rva)
+			{
+				return false;
+			}
+			auto slot = reinterpret_cast<void**>(reinterpret_cast<uintptr_t>(module) + *rva);
+
+			DWORD oldProtection = 0;
+			if (!::VirtualProtect(slot, sizeof(void*), GetWritableProtection(slot), &oldProtection))
+			{
+				return false;
+			}
+
+			bool replaced = true;
+			if (patch.Expected)
+			{
+				patch.Original = ::InterlockedCompareExchangePointer(slot, patch.Function, patch.Expected);
+				replaced = patch.Original == patch.Expected;
+			}
+			else
+			{
+				patch.Original = ::InterlockedExchangePointer(slot, patch.Function);
+			}
+			::VirtualProtect(slot, sizeof(void*), oldProtection, &oldProtection);
+
+			return replaced;
+		}
+		catch (...)
+		{
+			return false;
+		}
+	}
+}
+
 namespace xSE::Detour::Private
 {
 	uintptr_t FunctionIAT(uintptr_t func, const char* libraryName, const char* functionName) noexcept
 	{
-		uintptr_t base = reinterpret_cast<uintptr_t>(::GetModuleHandleW(nullptr));
-		return NukemDetoursBase::IATHook(base, libraryName, functionName, func);
+		IATPatch patch;
+		patch.LibraryName = libraryName;
+		patch.FunctionName = functionName;
+		patch.Function = reinterpret_cast<void*>(func);
+
+		PatchIAT(nullptr, patch);
+		return reinterpret_cast<uintptr_t>(patch.Original);
 	}
 	uintptr_t FunctionFromModule(HMODULE moduleBase, uintptr_t func, uintptr_t offset) noexcept
 	{
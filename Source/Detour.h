@@ -9,6 +9,29 @@ namespace xSE::Detour::Private
 
 namespace xSE::Detour
 {
+	struct IATPatch final
+	{
+		const char* LibraryName = nullptr;
+		const char* FunctionName = nullptr;
+		void* Function = nullptr;
+
+		// If set, the slot is only replaced if it still holds this value (compared and exchanged atomically)
+		void* Expected = nullptr;
+
+		// Previous value of the slot, null if the function isn't imported by the module
+		void* Original = nullptr;
+	};
+
+	// Replaces an import address table entry of the given module (the executable if null). The import directory of every module
+	// is indexed once. Returns false if the function isn't imported or, for a patch with 'Expected' set, if the slot held something
+	// else ('Original' tells what it was).
+	bool PatchIAT(HMODULE module, IATPatch& patch) noexcept;
+
+	inline void* FunctionIAT(void* func, const char* libraryName, const char* functionName) noexcept
+	{
+		return reinterpret_cast<void*>(Private::FunctionIAT(reinterpret_cast<uintptr_t>(func), libraryName, functionName));
+	}
+
 	template<class T> requires(std::is_function_v<T>)
 	T* FunctionIAT(T* func, const char* libraryName, const char* functionName) noexcept
 	{
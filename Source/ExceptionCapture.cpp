@@ -0,0 +1,194 @@
+#include "pch.hpp"
+#include "ExceptionCapture.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	constexpr std::string_view g_RegisterNames64[] =
+	{
+		"RAX", "RBX", "RCX", "RDX", "RSI", "RDI", "RBP", "RSP",
+		"R8", "R9", "R10", "R11", "R12", "R13", "R14", "R15",
+		"RIP", "EFLAGS"
+	};
+	constexpr std::string_view g_RegisterNames32[] =
+	{
+		"EAX", "EBX", "ECX", "EDX", "ESI", "EDI", "EBP", "ESP",
+		"EIP", "EFLAGS"
+	};
+	static_assert(std::size(g_RegisterNames64) <= xSE::ExceptionSnapshot::MaxRegisters);
+
+	template<class... Args>
+	void Append(std::string& result, const char* format, Args... args)
+	{
+		char buffer[128] = {};
+		const int length = std::snprintf(buffer, std::size(buffer), format, args...);
+		if (length > 0)
+		{
+			result.append(buffer, std::min<size_t>(length, std::size(buffer) - 1));
+		}
+	}
+}
+
+namespace xSE
+{
+	std::span<const std::string_view> ExceptionSnapshot::GetRegisterNames(CPUArchitecture architecture) noexcept
+	{
+		if (architecture == CPUArchitecture::x64)
+		{
+			return g_RegisterNames64;
+		}
+		return g_RegisterNames32;
+	}
+	void ExceptionSnapshot::SetModule(std::string_view name, uint64_t offset) noexcept
+	{
+		const size_t length = std::min(name.size(), MaxModuleName - 1);
+		std::memcpy(ModuleName, name.data(), length);
+		ModuleName[length] = '\0';
+		ModuleOffset = offset;
+	}
+	void ExceptionSnapshot::CopyStack(uint64_t stackAddress, const void* data, size_t size) noexcept
+	{
+		StackAddress = stackAddress;
+		StackSize = static_cast<uint32_t>(std::min(size, MaxStackSize));
+		std::memcpy(Stack, data, StackSize);
+	}
+
+	std::string FormatExceptionSnapshot(const ExceptionSnapshot& snapshot)
+	{
+		const bool is64Bit = snapshot.Architecture == CPUArchitecture::x64;
+		const int pointerWidth = is64Bit ? 16 : 8;
+
+		std::string result;
+		Append(result, "Exception #%" PRIu64 " on thread %" PRIu32 ": code 0x%08" PRIX32 ", flags 0x%08" PRIX32 ", address 0x%0*" PRIX64,
+			   snapshot.Sequence,
+			   snapshot.ThreadID,
+			   snapshot.Code,
+			   snapshot.Flags,
+			   pointerWidth, snapshot.Address
+		);
+		if (snapshot.ModuleName[0] != '\0')
+		{
+			Append(result, " (%.*s+0x%" PRIX64 ")", static_cast<int>(ExceptionSnapshot::MaxModuleName), snapshot.ModuleName, snapshot.ModuleOffset);
+		}
+		if (snapshot.NestedRecord != 0)
+		{
+			Append(result, ", nested record 0x%0*" PRIX64, pointerWidth, snapshot.NestedRecord);
+		}
+
+		const size_t parameterCount = std::min<size_t>(snapshot.ParameterCount, ExceptionSnapshot::MaxParameters);
+		if (parameterCount != 0)
+		{
+			result += "\nParameters:";
+			for (size_t i = 0; i < parameterCount; i++)
+			{
+				Append(result, " 0x%" PRIX64, snapshot.Parameters[i]);
+			}
+		}
+
+		result += "\nRegisters:";
+		const auto registerNames = ExceptionSnapshot::GetRegisterNames(snapshot.Architecture);
+		for (size_t i = 0; i < registerNames.size(); i++)
+		{
+			Append(result, "%s%.*s=0x%0*" PRIX64, i % 6 == 0 ? "\n\t" : ", ", static_cast<int>(registerNames[i].size()), registerNames[i].data(), pointerWidth, snapshot.Registers[i]);
+		}
+
+		// Pointer-sized words, four per line, so return addresses are easy to spot
+		const size_t wordSize = is64Bit ? sizeof(uint64_t) : sizeof(uint32_t);
+		const size_t stackSize = std::min<size_t>(snapshot.StackSize, ExceptionSnapshot::MaxStackSize) / wordSize * wordSize;
+		Append(result, "\nStack at 0x%0*" PRIX64 ", %zu bytes:", pointerWidth, snapshot.StackAddress, stackSize);
+		for (size_t offset = 0; offset < stackSize; offset += wordSize)
+		{
+			uint64_t word = 0;
+			std::memcpy(&word, snapshot.Stack + offset, wordSize);
+
+			if (offset % (wordSize * 4) == 0)
+			{
+				Append(result, "\n\t+%04zX:", offset);
+			}
+			Append(result, " %0*" PRIX64, pointerWidth, word);
+		}
+		return result;
+	}
+
+	ExceptionCapture::ExceptionCapture(size_t slotCount)
+		:m_SlotCount(std::max<size_t>(slotCount, 1))
+	{
+		m_States = std::make_unique<std::atomic<SlotState>[]>(m_SlotCount);
+		m_Snapshots = std::make_unique<ExceptionSnapshot[]>(m_SlotCount);
+		for (size_t i = 0; i < m_SlotCount; i++)
+		{
+			m_States[i].store(SlotState::Free, std::memory_order_relaxed);
+		}
+	}
+
+	ExceptionSnapshot* ExceptionCapture::Acquire() noexcept
+	{
+		// Start from the slot after the last taken one, so the slots are reused evenly
+		const uint64_t sequence = m_NextSequence.fetch_add(1, std::memory_order_relaxed);
+		for (size_t i = 0; i < m_SlotCount; i++)
+		{
+			const size_t index = static_cast<size_t>((sequence + i) % m_SlotCount);
+
+			SlotState expected = SlotState::Free;
+			if (m_States[index].compare_exchange_strong(expected, SlotState::Writing, std::memory_order_acquire, std::memory_order_relaxed))
+			{
+				ExceptionSnapshot& snapshot = m_Snapshots[index];
+				snapshot = {};
+				snapshot.Sequence = sequence;
+
+				return &snapshot;
+			}
+		}
+
+		m_DroppedCount.fetch_add(1, std::memory_order_relaxed);
+		return nullptr;
+	}
+	void ExceptionCapture::Commit(ExceptionSnapshot& snapshot) noexcept
+	{
+		const size_t index = static_cast<size_t>(&snapshot - m_Snapshots.get());
+		m_States[index].store(SlotState::Ready, std::memory_order_release);
+	}
+
+	size_t ExceptionCapture::Flush(const std::function<void(const ExceptionSnapshot&)>& func)
+	{
+		std::lock_guard lock(m_FlushLock);
+
+		std::vector<size_t> ready;
+		for (size_t i = 0; i < m_SlotCount; i++)
+		{
+			SlotState expected = SlotState::Ready;
+			if (m_States[i].compare_exchange_strong(expected, SlotState::Reading, std::memory_order_acquire, std::memory_order_relaxed))
+			{
+				ready.push_back(i);
+			}
+		}
+		std::ranges::sort(ready, std::less{}, [&](size_t index)
+		{
+			return m_Snapshots[index].Sequence;
+		});
+
+		// The slots are freed even if the function throws, the snapshots are lost then
+		size_t processed = 0;
+		try
+		{
+			for (; processed < ready.size(); processed++)
+			{
+				std::invoke(func, m_Snapshots[ready[processed]]);
+				m_States[ready[processed]].store(SlotState::Free, std::memory_order_release);
+			}
+		}
+		catch (...)
+		{
+			for (; processed < ready.size(); processed++)
+			{
+				m_States[ready[processed]].store(SlotState::Free, std::memory_order_release);
+			}
+			throw;
+		}
+		return ready.size();
+	}
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <functional>
+
+// Fixed-size exception snapshots, taken without allocating in the handler and formatted later at a flush point.
+namespace xSE
+{
+	enum class CPUArchitecture: uint32_t
+	{
+		x86,
+		x64
+	};
+
+	struct ExceptionSnapshot final
+	{
+		static constexpr size_t MaxParameters = 15;
+		static constexpr size_t MaxRegisters = 18;
+		static constexpr size_t MaxStackSize = 512;
+		static constexpr size_t MaxModuleName = 64;
+
+		// Order in which the snapshots were taken, assigned by 'ExceptionCapture'
+		uint64_t Sequence = 0;
+		uint32_t ThreadID = 0;
+		CPUArchitecture Architecture = CPUArchitecture::x64;
+
+		// Exception record
+		uint32_t Code = 0;
+		uint32_t Flags = 0;
+		uint64_t Address = 0;
+		uint64_t NestedRecord = 0;
+		uint32_t ParameterCount = 0;
+		uint64_t Parameters[MaxParameters] = {};
+
+		// Module containing the exception address, resolved at the time of the exception. Empty if it's not known.
+		char ModuleName[MaxModuleName] = {};
+		uint64_t ModuleOffset = 0;
+
+		// In the order of 'GetRegisterNames' for the architecture
+		uint64_t Registers[MaxRegisters] = {};
+
+		// Raw stack contents starting from the stack pointer
+		uint64_t StackAddress = 0;
+		uint32_t StackSize = 0;
+		std::byte Stack[MaxStackSize] = {};
+
+		static std::span<const std::string_view> GetRegisterNames(CPUArchitecture architecture) noexcept;
+
+		// Truncates the name to fit 'MaxModuleName' with the terminating null
+		void SetModule(std::string_view name, uint64_t offset) noexcept;
+
+		// Copies up to 'MaxStackSize' bytes, the whole range must be readable
+		void CopyStack(uint64_t stackAddress, const void* data, size_t size) noexcept;
+	};
+
+	// Multi-line description of the snapshot: the exception record, registers and a hex dump of the stack
+	std::string FormatExceptionSnapshot(const ExceptionSnapshot& snapshot);
+
+	class ExceptionCapture final
+	{
+		public:
+			static constexpr size_t DefaultSlotCount = 64;
+
+		private:
+			enum class SlotState: uint32_t
+			{
+				Free,
+				Writing,
+				Ready,
+				Reading
+			};
+
+		private:
+			std::unique_ptr<std::atomic<SlotState>[]> m_States;
+			std::unique_ptr<ExceptionSnapshot[]> m_Snapshots;
+			size_t m_SlotCount = 0;
+
+			std::atomic<uint64_t> m_NextSequence = 0;
+			std::atomic<size_t> m_DroppedCount = 0;
+			std::mutex m_FlushLock;
+
+		public:
+			ExceptionCapture(size_t slotCount = DefaultSlotCount);
+			ExceptionCapture(const ExceptionCapture&) = delete;
+
+		public:
+			size_t GetSlotCount() const noexcept
+			{
+				return m_SlotCount;
+			}
+			size_t GetDroppedCount() const noexcept
+			{
+				return m_DroppedCount.load(std::memory_order_relaxed);
+			}
+
+			// Returns a cleared snapshot to fill, or null if all the slots are waiting for a flush (the exception is counted as dropped).
+			// Every acquired snapshot must be passed to 'Commit'. Doesn't allocate or block, safe to call from an exception handler.
+			ExceptionSnapshot* Acquire() noexcept;
+			void Commit(ExceptionSnapshot& snapshot) noexcept;
+
+			// Passes the committed snapshots to the function in the order they were taken and frees their slots
+			size_t Flush(const std::function<void(const ExceptionSnapshot&)>& func);
+
+		public:
+			ExceptionCapture& operator=(const ExceptionCapture&) = delete;
+	};
+}
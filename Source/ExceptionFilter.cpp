@@ -0,0 +1,87 @@
+#include "pch.hpp"
+#include "ExceptionFilter.h"
+
+namespace xSE
+{
+	bool ExceptionFilter::Rule::Matches(uint32_t code, std::string_view moduleName) const noexcept
+	{
+		if (code < FirstCode || code > LastCode)
+		{
+			return false;
+		}
+		if (ModuleName.empty())
+		{
+			return true;
+		}
+
+		// Module names are ASCII in practice, so simple case folding is enough
+		return std::ranges::equal(ModuleName, moduleName, [](char left, char right)
+		{
+			auto toLower = [](char c)
+			{
+				return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+			};
+			return toLower(left) == toLower(right);
+		});
+	}
+
+	bool ExceptionFilter::CheckRateLimit(const Rule& rule, RuleState& state) noexcept
+	{
+		if (rule.RateLimit == 0)
+		{
+			return true;
+		}
+
+		// Fixed one second windows. Whoever moves the window start resets the counter, a few exceptions
+		// racing with that can get through or be suppressed, which doesn't matter for a log.
+		const Clock::rep now = Clock::now().time_since_epoch().count();
+		Clock::rep windowStart = state.WindowStart.load(std::memory_order_relaxed);
+		if (now - windowStart >= std::chrono::duration_cast<Clock::duration>(std::chrono::seconds(1)).count())
+		{
+			if (state.WindowStart.compare_exchange_strong(windowStart, now, std::memory_order_relaxed))
+			{
+				state.WindowCount.store(0, std::memory_order_relaxed);
+			}
+		}
+		return state.WindowCount.fetch_add(1, std::memory_order_relaxed) < rule.RateLimit;
+	}
+
+	ExceptionFilter::ExceptionFilter(std::vector<Rule> rules)
+		:m_Rules(std::move(rules))
+	{
+		m_States = std::make_unique<RuleState[]>(m_Rules.size());
+		m_HasModuleRules = std::ranges::any_of(m_Rules, [](const Rule& rule)
+		{
+			return !rule.ModuleName.empty();
+		});
+	}
+
+	bool ExceptionFilter::ShouldCapture(uint32_t code, std::string_view moduleName) noexcept
+	{
+		for (size_t i = 0; i < m_Rules.size(); i++)
+		{
+			const Rule& rule = m_Rules[i];
+			if (rule.Matches(code, moduleName))
+			{
+				RuleState& state = m_States[i];
+				state.Matched.fetch_add(1, std::memory_order_relaxed);
+
+				if (rule.Action == FilterAction::Ignore || !CheckRateLimit(rule, state))
+				{
+					state.Suppressed.fetch_add(1, std::memory_order_relaxed);
+					return false;
+				}
+				return true;
+			}
+		}
+		return true;
+	}
+	void ExceptionFilter::EnumStatistics(const std::function<void(const RuleStatistics&)>& func) const
+	{
+		for (size_t i = 0; i < m_Rules.size(); i++)
+		{
+			const RuleState& state = m_States[i];
+			std::invoke(func, RuleStatistics{m_Rules[i], state.Matched.load(std::memory_order_relaxed), state.Suppressed.load(std::memory_order_relaxed)});
+		}
+	}
+}
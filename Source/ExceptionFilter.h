@@ -0,0 +1,100 @@
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+
+// First-chance exception filter rules, evaluated before anything is captured.
+namespace xSE
+{
+	class ExceptionFilter final
+	{
+		public:
+			using Clock = std::chrono::steady_clock;
+
+			enum class FilterAction
+			{
+				Capture,
+				Ignore
+			};
+			struct Rule final
+			{
+				uint32_t FirstCode = 0;
+				uint32_t LastCode = 0;
+
+				// Base name of the module the exception has to be raised in (case-insensitive), any module matches if empty.
+				// Matched by name rather than by address, so the module doesn't have to be loaded when the filter is built.
+				std::string ModuleName;
+
+				FilterAction Action = FilterAction::Ignore;
+
+				// Captured exceptions per second for 'FilterAction::Capture', zero for no limit
+				uint32_t RateLimit = 0;
+
+				// Used only for reporting
+				std::string Description;
+
+				bool Matches(uint32_t code, std::string_view moduleName) const noexcept;
+			};
+			struct RuleStatistics final
+			{
+				const Rule& Definition;
+				uint64_t Matched = 0;
+				uint64_t Suppressed = 0;
+			};
+
+		private:
+			struct alignas(64) RuleState final
+			{
+				std::atomic<uint64_t> Matched = 0;
+				std::atomic<uint64_t> Suppressed = 0;
+				std::atomic<Clock::rep> WindowStart = 0;
+				std::atomic<uint32_t> WindowCount = 0;
+			};
+
+		private:
+			std::vector<Rule> m_Rules;
+			std::unique_ptr<RuleState[]> m_States;
+			bool m_HasModuleRules = false;
+
+		private:
+			bool CheckRateLimit(const Rule& rule, RuleState& state) noexcept;
+
+		public:
+			ExceptionFilter() = default;
+			ExceptionFilter(std::vector<Rule> rules);
+			ExceptionFilter(const ExceptionFilter&) = delete;
+			ExceptionFilter(ExceptionFilter&&) noexcept = default;
+
+		public:
+			bool IsEmpty() const noexcept
+			{
+				return m_Rules.empty();
+			}
+			size_t GetRuleCount() const noexcept
+			{
+				return m_Rules.size();
+			}
+
+			// Whether any rule is limited to a module, otherwise the module name passed to 'ShouldCapture' doesn't matter
+			bool HasModuleRules() const noexcept
+			{
+				return m_HasModuleRules;
+			}
+
+			// The first matching rule decides, exceptions not matched by any rule are captured. The module name is empty
+			// if the exception address doesn't belong to any module. Doesn't allocate or block.
+			bool ShouldCapture(uint32_t code, std::string_view moduleName) noexcept;
+
+			// Matched and suppressed counts of every rule, in the rule order
+			void EnumStatistics(const std::function<void(const RuleStatistics&)>& func) const;
+
+		public:
+			ExceptionFilter& operator=(const ExceptionFilter&) = delete;
+			ExceptionFilter& operator=(ExceptionFilter&&) noexcept = default;
+	};
+}
@@ -0,0 +1,114 @@
+#include "pch.hpp"
+#include "ExceptionStatistics.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace
+{
+	uint64_t HashKey(const xSE::ExceptionStatistics::Key& key) noexcept
+	{
+		// FNV-1a over the code, the offset and the module name
+		uint64_t hash = 14695981039346656037ull;
+		auto append = [&](const void* data, size_t size)
+		{
+			for (size_t i = 0; i < size; i++)
+			{
+				hash ^= static_cast<const uint8_t*>(data)[i];
+				hash *= 1099511628211ull;
+			}
+		};
+		append(&key.Code, sizeof(key.Code));
+		append(&key.ModuleOffset, sizeof(key.ModuleOffset));
+
+		const std::string_view name = key.GetModuleName();
+		append(name.data(), name.size());
+
+		// Zero marks an entry without a hash yet
+		return hash != 0 ? hash : 1;
+	}
+}
+
+namespace xSE
+{
+	void ExceptionStatistics::Key::SetModule(std::string_view name, uint64_t offset) noexcept
+	{
+		const size_t length = std::min(name.size(), MaxModuleName - 1);
+		std::memcpy(ModuleName, name.data(), length);
+		std::memset(ModuleName + length, 0, MaxModuleName - length);
+		ModuleOffset = offset;
+	}
+	std::string_view ExceptionStatistics::Key::GetModuleName() const noexcept
+	{
+		return {ModuleName, ::strnlen(ModuleName, MaxModuleName)};
+	}
+	bool ExceptionStatistics::Key::operator==(const Key& other) const noexcept
+	{
+		return Code == other.Code && ModuleOffset == other.ModuleOffset && GetModuleName() == other.GetModuleName();
+	}
+
+	ExceptionStatistics::ExceptionStatistics(size_t tableSize)
+		:m_TableMask(std::bit_ceil(std::max<size_t>(tableSize, 1)) - 1)
+	{
+		m_Entries = std::make_unique<Entry[]>(m_TableMask + 1);
+	}
+
+	auto ExceptionStatistics::Record(const Key& key) noexcept -> RecordResult
+	{
+		m_TotalCount.fetch_add(1, std::memory_order_relaxed);
+
+		// Linear probing, entries are never removed so a key always stays at the first place it was inserted to
+		const uint64_t hash = HashKey(key);
+		for (size_t i = 0; i <= m_TableMask; i++)
+		{
+			Entry& entry = m_Entries[(hash + i) & m_TableMask];
+
+			EntryState state = entry.State.load(std::memory_order_acquire);
+			if (state == EntryState::Empty)
+			{
+				if (entry.State.compare_exchange_strong(state, EntryState::Initializing, std::memory_order_acquire))
+				{
+					entry.Definition = key;
+					entry.Count.store(1, std::memory_order_relaxed);
+					entry.Hash.store(hash, std::memory_order_relaxed);
+					entry.State.store(EntryState::Ready, std::memory_order_release);
+
+					m_KeyCount.fetch_add(1, std::memory_order_relaxed);
+					return RecordResult::First;
+				}
+			}
+
+			// Another thread is inserting into this entry, it's only a few stores away from being ready
+			while (state == EntryState::Initializing)
+			{
+				state = entry.State.load(std::memory_order_acquire);
+			}
+
+			if (entry.Hash.load(std::memory_order_relaxed) == hash && entry.Definition == key)
+			{
+				entry.Count.fetch_add(1, std::memory_order_relaxed);
+				return RecordResult::Repeated;
+			}
+		}
+
+		m_OverflowCount.fetch_add(1, std::memory_order_relaxed);
+		return RecordResult::Overflow;
+	}
+	auto ExceptionStatistics::Summarize() const -> std::vector<Summary>
+	{
+		std::vector<Summary> summaries;
+		summaries.reserve(GetKeyCount());
+
+		for (size_t i = 0; i <= m_TableMask; i++)
+		{
+			const Entry& entry = m_Entries[i];
+			if (entry.State.load(std::memory_order_acquire) == EntryState::Ready)
+			{
+				summaries.emplace_back(Summary{entry.Definition, entry.Count.load(std::memory_order_relaxed)});
+			}
+		}
+
+		std::ranges::sort(summaries, std::greater{}, &Summary::Count);
+		return summaries;
+	}
+}
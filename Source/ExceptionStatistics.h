@@ -0,0 +1,98 @@
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Exception counters keyed by the code, module and offset, in a fixed-size table which is updated without allocating.
+namespace xSE
+{
+	class ExceptionStatistics final
+	{
+		public:
+			static constexpr size_t DefaultTableSize = 1024;
+			static constexpr size_t MaxModuleName = 64;
+
+			enum class RecordResult
+			{
+				First,
+				Repeated,
+
+				// The table is full, the exception is only counted in 'GetOverflowCount'
+				Overflow
+			};
+			struct Key final
+			{
+				uint32_t Code = 0;
+
+				// Offset from the module base, or the absolute address if the module isn't known
+				uint64_t ModuleOffset = 0;
+				char ModuleName[MaxModuleName] = {};
+
+				void SetModule(std::string_view name, uint64_t offset) noexcept;
+				std::string_view GetModuleName() const noexcept;
+
+				bool operator==(const Key& other) const noexcept;
+			};
+			struct Summary final
+			{
+				Key Definition;
+				uint64_t Count = 0;
+			};
+
+		private:
+			enum class EntryState: uint32_t
+			{
+				Empty,
+				Initializing,
+				Ready
+			};
+			struct Entry final
+			{
+				std::atomic<EntryState> State = EntryState::Empty;
+				std::atomic<uint64_t> Hash = 0;
+				std::atomic<uint64_t> Count = 0;
+				Key Definition;
+			};
+
+		private:
+			std::unique_ptr<Entry[]> m_Entries;
+			size_t m_TableMask = 0;
+
+			std::atomic<size_t> m_KeyCount = 0;
+			std::atomic<uint64_t> m_TotalCount = 0;
+			std::atomic<uint64_t> m_OverflowCount = 0;
+
+		public:
+			// Table size is rounded up to a power of two
+			ExceptionStatistics(size_t tableSize = DefaultTableSize);
+			ExceptionStatistics(const ExceptionStatistics&) = delete;
+
+		public:
+			size_t GetTableSize() const noexcept
+			{
+				return m_TableMask + 1;
+			}
+			size_t GetKeyCount() const noexcept
+			{
+				return m_KeyCount.load(std::memory_order_relaxed);
+			}
+			uint64_t GetTotalCount() const noexcept
+			{
+				return m_TotalCount.load(std::memory_order_relaxed);
+			}
+			uint64_t GetOverflowCount() const noexcept
+			{
+				return m_OverflowCount.load(std::memory_order_relaxed);
+			}
+
+			RecordResult Record(const Key& key) noexcept;
+
+			// Counters of all the recorded keys at the moment of the call, the most frequent first
+			std::vector<Summary> Summarize() const;
+
+		public:
+			ExceptionStatistics& operator=(const ExceptionStatistics&) = delete;
+	};
+}
@@ -0,0 +1,82 @@
+#include "pch.hpp"
+#include "ExportBinder.h"
+
+namespace xSE::PE
+{
+	std::optional<ExportEntry> ExportBinder::FindByOrdinal(const ExportBindRequest& request, int64_t ordinalDelta) const noexcept
+	{
+		if (request.Ordinal == 0)
+		{
+			return {};
+		}
+
+		const int64_t index = static_cast<int64_t>(request.Ordinal) + ordinalDelta - m_OrdinalBase;
+		if (index < 0 || index >= static_cast<int64_t>(m_FunctionNames.size()) || m_FunctionNames[index] != request.Name)
+		{
+			return {};
+		}
+
+		if (auto entry = m_Image.FindExport(m_OrdinalBase + static_cast<uint32_t>(index)))
+		{
+			entry->Name = m_FunctionNames[index];
+			return entry;
+		}
+		return {};
+	}
+
+	ExportBinder::ExportBinder(ImageReader& image)
+		:m_Image(image), m_OrdinalBase(image.GetExportOrdinalBase())
+	{
+		m_FunctionNames.resize(m_Image.GetExportFunctionCount());
+		m_Image.EnumExports([&](const ExportEntry& entry) noexcept
+		{
+			m_FunctionNames[entry.Ordinal - m_OrdinalBase] = entry.Name;
+			return true;
+		});
+	}
+
+	ExportBindStatistics ExportBinder::Bind(std::span<const ExportBindRequest> requests, std::span<uint32_t> rvas)
+	{
+		ExportBindStatistics statistics;
+		int64_t ordinalDelta = 0;
+
+		for (size_t i = 0; i < requests.size() && i < rvas.size(); i++)
+		{
+			const ExportBindRequest& request = requests[i];
+
+			auto entry = FindByOrdinal(request, ordinalDelta);
+			const bool isBoundByOrdinal = entry.has_value();
+			if (!entry)
+			{
+				entry = m_Image.FindExport(request.Name);
+				if (entry && request.Ordinal != 0)
+				{
+					ordinalDelta = static_cast<int64_t>(entry->Ordinal) - request.Ordinal;
+				}
+			}
+
+			rvas[i] = 0;
+			if (!entry)
+			{
+				statistics.Unresolved++;
+			}
+			else if (entry->IsForwarded)
+			{
+				statistics.Forwarded++;
+			}
+			else
+			{
+				rvas[i] = entry->RVA;
+				if (isBoundByOrdinal)
+				{
+					statistics.ByOrdinal++;
+				}
+				else
+				{
+					statistics.ByName++;
+				}
+			}
+		}
+		return statistics;
+	}
+}
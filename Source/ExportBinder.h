@@ -0,0 +1,45 @@
+#pragma once
+#include "PortableExecutable.h"
+#include <vector>
+
+// Resolves a list of expected exports against an export directory in one pass.
+namespace xSE::PE
+{
+	struct ExportBindRequest final
+	{
+		std::string_view Name;
+
+		// Expected ordinal, zero if unknown
+		uint32_t Ordinal = 0;
+	};
+	struct ExportBindStatistics final
+	{
+		size_t ByOrdinal = 0;
+		size_t ByName = 0;
+		size_t Forwarded = 0;
+		size_t Unresolved = 0;
+	};
+
+	class ExportBinder final
+	{
+		private:
+			ImageReader& m_Image;
+			uint32_t m_OrdinalBase = 0;
+
+			// Name of every function in the export address table, empty for the ones exported only by ordinal
+			std::vector<std::string_view> m_FunctionNames;
+
+		private:
+			std::optional<ExportEntry> FindByOrdinal(const ExportBindRequest& request, int64_t ordinalDelta) const noexcept;
+
+		public:
+			ExportBinder(ImageReader& image);
+
+		public:
+			// Writes RVA of every request into 'rvas' (which must be the same size as 'requests'). The expected ordinal is tried first
+			// and is accepted only if the name there matches, otherwise the name is looked up. If the names turn out to be shifted
+			// relative to the expected ordinals, the shift is remembered for the remaining requests. Forwarded and missing exports
+			// get zero RVA, the caller has to resolve them through the system loader.
+			ExportBindStatistics Bind(std::span<const ExportBindRequest> requests, std::span<uint32_t> rvas);
+	};
+}
@@ -0,0 +1,196 @@
+#include "pch.hpp"
+#include "ExportCallStatistics.h"
+#include <algorithm>
+#include <bit>
+
+namespace
+{
+	std::atomic<uint64_t> g_NextInstanceID = 1;
+
+	// Thread data of the last instance used on this thread, valid only while that instance exists
+	thread_local void* t_ThreadData = nullptr;
+	thread_local uint64_t t_ThreadDataInstanceID = 0;
+
+	// Counters are only ever written by their own thread, so a plain increment is enough. They're atomic only to be read safely by 'Summarize'.
+	void Increment(std::atomic<uint64_t>& value, uint64_t delta = 1) noexcept
+	{
+		value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+	}
+	size_t GetHistogramBucket(uint64_t nanoseconds) noexcept
+	{
+		return std::min<size_t>(std::bit_width(nanoseconds), xSE::ExportCallStatistics::HistogramSize - 1);
+	}
+}
+
+namespace xSE
+{
+	auto ExportCallStatistics::Summary::GetMeanTime() const noexcept -> Clock::duration
+	{
+		return Samples != 0 ? TotalTime / static_cast<Clock::rep>(Samples) : Clock::duration::zero();
+	}
+	auto ExportCallStatistics::Summary::GetPercentile(double percentile) const noexcept -> Clock::duration
+	{
+		const auto target = static_cast<uint64_t>(std::clamp(percentile, 0.0, 1.0) * static_cast<double>(Samples));
+
+		uint64_t count = 0;
+		for (size_t i = 0; i < Histogram.size(); i++)
+		{
+			count += Histogram[i];
+			if (count != 0 && count >= target)
+			{
+				// The last bucket is open-ended, the maximum is the best estimate for it
+				if (i + 1 == Histogram.size())
+				{
+					return MaxTime;
+				}
+				return std::min<Clock::duration>(std::chrono::nanoseconds(uint64_t(1) << i), MaxTime);
+			}
+		}
+		return MaxTime;
+	}
+
+	ExportCallStatistics::ThreadData* ExportCallStatistics::FindThreadData() const noexcept
+	{
+		// The pointer may be left from a destroyed instance, so it's only looked at if the ID matches
+		if (t_ThreadDataInstanceID == m_InstanceID)
+		{
+			return static_cast<ThreadData*>(t_ThreadData);
+		}
+		return nullptr;
+	}
+	ExportCallStatistics::ThreadData* ExportCallStatistics::GetThreadData() noexcept
+	{
+		if (ThreadData* threadData = FindThreadData())
+		{
+			return threadData;
+		}
+
+		try
+		{
+			auto newThreadData = std::make_unique<ThreadData>();
+			newThreadData->ExportCounters = std::make_unique<Counters[]>(m_ExportCount);
+
+			std::lock_guard lock(m_ThreadsLock);
+			ThreadData* threadData = m_Threads.emplace_back(std::move(newThreadData)).get();
+			t_ThreadData = threadData;
+			t_ThreadDataInstanceID = m_InstanceID;
+
+			return threadData;
+		}
+		catch (...)
+		{
+			return nullptr;
+		}
+	}
+
+	void ExportCallStatistics::DiscardAbandonedCalls(ThreadData& threadData, uintptr_t frameAddress) noexcept
+	{
+		// A call which is still in progress is in an outer frame, which is higher in the stack
+		while (threadData.PendingCount != 0 && threadData.PendingCalls[threadData.PendingCount - 1].FrameAddress <= frameAddress)
+		{
+			threadData.PendingCount--;
+		}
+	}
+
+	ExportCallStatistics::ExportCallStatistics(size_t exportCount, size_t sampleInterval)
+		:m_InstanceID(g_NextInstanceID.fetch_add(1, std::memory_order_relaxed)), m_ExportCount(exportCount), m_SampleMask(std::bit_ceil(std::max<uint64_t>(sampleInterval, 1)) - 1)
+	{
+	}
+
+	size_t ExportCallStatistics::GetThreadCount() const
+	{
+		std::lock_guard lock(m_ThreadsLock);
+		return m_Threads.size();
+	}
+
+	size_t ExportCallStatistics::BeginCall(size_t index, uintptr_t frameAddress) noexcept
+	{
+		ThreadData* threadData = GetThreadData();
+		if (!threadData || index >= m_ExportCount)
+		{
+			return 0;
+		}
+
+		Counters& counters = threadData->ExportCounters[index];
+		const uint64_t callIndex = counters.Calls.load(std::memory_order_relaxed);
+		Increment(counters.Calls);
+
+		if ((callIndex & m_SampleMask) == 0)
+		{
+			DiscardAbandonedCalls(*threadData, frameAddress);
+			if (threadData->PendingCount < MaxPendingCalls)
+			{
+				PendingCall& call = threadData->PendingCalls[threadData->PendingCount++];
+				call.Index = index;
+				call.FrameAddress = frameAddress;
+
+				// Taken last so the bookkeeping above isn't counted
+				call.StartTime = Clock::now();
+
+				// Position on the pending calls stack, starting from one
+				return threadData->PendingCount;
+			}
+		}
+		return 0;
+	}
+	void ExportCallStatistics::EndCall(size_t token, uintptr_t frameAddress) noexcept
+	{
+		const auto endTime = Clock::now();
+		ThreadData* threadData = FindThreadData();
+
+		// The call could have been discarded already if its frame was mistaken for an abandoned one, then there's nothing to record
+		if (!threadData || token == 0 || token > threadData->PendingCount || threadData->PendingCalls[token - 1].FrameAddress != frameAddress)
+		{
+			return;
+		}
+
+		// Anything above it on the pending stack belongs to deeper frames which have been unwound without returning
+		const PendingCall& call = threadData->PendingCalls[token - 1];
+		threadData->PendingCount = token - 1;
+
+		Counters& counters = threadData->ExportCounters[call.Index];
+		const auto nanoseconds = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - call.StartTime).count());
+
+		Increment(counters.Samples);
+		Increment(counters.TotalNanoseconds, nanoseconds);
+		Increment(counters.Histogram[GetHistogramBucket(nanoseconds)]);
+		if (nanoseconds > counters.MaxNanoseconds.load(std::memory_order_relaxed))
+		{
+			counters.MaxNanoseconds.store(nanoseconds, std::memory_order_relaxed);
+		}
+	}
+
+	std::vector<ExportCallStatistics::Summary> ExportCallStatistics::Summarize() const
+	{
+		std::vector<Summary> summaries(m_ExportCount);
+		for (size_t i = 0; i < m_ExportCount; i++)
+		{
+			summaries[i].Index = i;
+		}
+
+		std::lock_guard lock(m_ThreadsLock);
+		for (const auto& threadData: m_Threads)
+		{
+			for (size_t i = 0; i < m_ExportCount; i++)
+			{
+				const Counters& counters = threadData->ExportCounters[i];
+				Summary& summary = summaries[i];
+
+				summary.Calls += counters.Calls.load(std::memory_order_relaxed);
+				summary.Samples += counters.Samples.load(std::memory_order_relaxed);
+				summary.TotalTime += std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(counters.TotalNanoseconds.load(std::memory_order_relaxed)));
+				summary.MaxTime = std::max<Clock::duration>(summary.MaxTime, std::chrono::nanoseconds(counters.MaxNanoseconds.load(std::memory_order_relaxed)));
+				for (size_t j = 0; j < HistogramSize; j++)
+				{
+					summary.Histogram[j] += counters.Histogram[j].load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		std::erase_if(summaries, [](const Summary& summary)
+		{
+			return summary.Calls == 0;
+		});
+		return summaries;
+	}
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include <cstdint>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Per-thread call counters and sampled latency histograms for the forwarded exports.
+namespace xSE
+{
+	class ExportCallStatistics final
+	{
+		public:
+			using Clock = std::chrono::steady_clock;
+
+			// Bucket 0 holds calls shorter than 1 ns, bucket N holds [2^(N-1), 2^N) ns and the last one everything longer
+			static constexpr size_t HistogramSize = 24;
+
+			// Sampled calls currently in progress on one thread, further nested calls aren't sampled
+			static constexpr size_t MaxPendingCalls = 32;
+
+			struct Summary final
+			{
+				size_t Index = 0;
+				uint64_t Calls = 0;
+				uint64_t Samples = 0;
+				Clock::duration TotalTime = {};
+				Clock::duration MaxTime = {};
+				std::array<uint64_t, HistogramSize> Histogram = {};
+
+				Clock::duration GetMeanTime() const noexcept;
+
+				// Upper bound of the histogram bucket containing the given percentile, in [0, 1] range
+				Clock::duration GetPercentile(double percentile) const noexcept;
+			};
+
+		private:
+			// Aligned like the thread data, so the arrays of two threads never share a cache line
+			struct alignas(64) Counters final
+			{
+				std::atomic<uint64_t> Calls = 0;
+				std::atomic<uint64_t> Samples = 0;
+				std::atomic<uint64_t> TotalNanoseconds = 0;
+				std::atomic<uint64_t> MaxNanoseconds = 0;
+				std::atomic<uint64_t> Histogram[HistogramSize] = {};
+			};
+			struct PendingCall final
+			{
+				size_t Index = 0;
+				uintptr_t FrameAddress = 0;
+				Clock::time_point StartTime;
+			};
+			struct alignas(64) ThreadData final
+			{
+				std::unique_ptr<Counters[]> ExportCounters;
+				PendingCall PendingCalls[MaxPendingCalls];
+				size_t PendingCount = 0;
+			};
+
+		private:
+			// Identifies the thread data of this instance, unlike its address it's never reused by another instance
+			uint64_t m_InstanceID = 0;
+			size_t m_ExportCount = 0;
+			uint64_t m_SampleMask = 0;
+
+			mutable std::mutex m_ThreadsLock;
+			std::vector<std::unique_ptr<ThreadData>> m_Threads;
+
+		private:
+			ThreadData* FindThreadData() const noexcept;
+			ThreadData* GetThreadData() noexcept;
+			void DiscardAbandonedCalls(ThreadData& threadData, uintptr_t frameAddress) noexcept;
+
+		public:
+			// Sample interval is rounded up to a power of two, one call out of that many (per thread and export) is timed
+			ExportCallStatistics(size_t exportCount, size_t sampleInterval);
+			ExportCallStatistics(const ExportCallStatistics&) = delete;
+
+		public:
+			size_t GetExportCount() const noexcept
+			{
+				return m_ExportCount;
+			}
+			size_t GetSampleInterval() const noexcept
+			{
+				return static_cast<size_t>(m_SampleMask + 1);
+			}
+			size_t GetThreadCount() const;
+
+			// Counts the call. If it's chosen to be timed, returns a non-zero token which has to be passed to 'EndCall' along with
+			// the same frame address once the function returns. The frame address is the stack pointer of the caller's frame,
+			// a frame deeper in the stack must have a lower address.
+			size_t BeginCall(size_t index, uintptr_t frameAddress) noexcept;
+
+			// Records the time of the timed call. Calls started after it on this thread which never returned (abandoned by exceptions
+			// or 'longjmp') are discarded, as are the ones found at or below the frame of a new timed call. Unknown tokens are ignored.
+			void EndCall(size_t token, uintptr_t frameAddress) noexcept;
+
+			// Totals across all threads, only for the exports which were called at least once
+			std::vector<Summary> Summarize() const;
+
+		public:
+			ExportCallStatistics& operator=(const ExportCallStatistics&) = delete;
+	};
+}
@@ -0,0 +1,117 @@
+#include "pch.hpp"
+#include "ImportIndex.h"
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+	char ToLower(char c) noexcept
+	{
+		return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+	}
+	std::string ToLower(std::string_view value)
+	{
+		std::string result(value);
+		std::ranges::transform(result, result.begin(), [](char c)
+		{
+			return ToLower(c);
+		});
+		return result;
+	}
+
+	// Stored names are already in lower case, the name being looked up is converted as it's compared
+	bool LessNoCase(std::string_view left, std::string_view right) noexcept
+	{
+		return std::ranges::lexicographical_compare(left, right, std::less{}, [](char c)
+		{
+			return ToLower(c);
+		}, [](char c)
+		{
+			return ToLower(c);
+		});
+	}
+	bool EqualsNoCase(std::string_view left, std::string_view right) noexcept
+	{
+		return std::ranges::equal(left, right, std::equal_to{}, [](char c)
+		{
+			return ToLower(c);
+		}, [](char c)
+		{
+			return ToLower(c);
+		});
+	}
+}
+
+namespace xSE::PE
+{
+	auto ImportIndex::GetKey(const Entry& entry) noexcept -> Key
+	{
+		return {entry.ModuleIndex, entry.Name, entry.Ordinal};
+	}
+}
+
+namespace xSE::PE
+{
+	std::optional<uint32_t> ImportIndex::FindModule(std::string_view moduleName) const noexcept
+	{
+		auto it = std::ranges::lower_bound(m_ModuleNames, moduleName, [](std::string_view left, std::string_view right)
+		{
+			return LessNoCase(left, right);
+		});
+		if (it != m_ModuleNames.end() && EqualsNoCase(*it, moduleName))
+		{
+			return static_cast<uint32_t>(it - m_ModuleNames.begin());
+		}
+		return {};
+	}
+	std::optional<uint32_t> ImportIndex::FindSlot(std::string_view moduleName, std::string_view name, uint32_t ordinal) const
+	{
+		const auto moduleIndex = FindModule(moduleName);
+		if (!moduleIndex)
+		{
+			return {};
+		}
+
+		auto it = std::ranges::lower_bound(m_Entries, Key(*moduleIndex, name, ordinal), std::less{}, &ImportIndex::GetKey);
+		if (it != m_Entries.end() && it->ModuleIndex == *moduleIndex && it->Name == name && it->Ordinal == ordinal)
+		{
+			return it->SlotRVA;
+		}
+		return {};
+	}
+
+	ImportIndex::ImportIndex(const ImageReader& image)
+	{
+		// Modules are sorted by name, so the entries of one module are adjacent after the final sort
+		std::vector<std::string> moduleNames;
+		image.EnumImportedModules([&](std::string_view name)
+		{
+			moduleNames.emplace_back(ToLower(name));
+			return true;
+		});
+		std::ranges::sort(moduleNames);
+		moduleNames.erase(std::ranges::unique(moduleNames).begin(), moduleNames.end());
+		m_ModuleNames = std::move(moduleNames);
+
+		// Imports come grouped by their descriptor, so the module is looked up only when it changes
+		std::string_view currentModule;
+		uint32_t currentModuleIndex = 0;
+		image.EnumImports([&](const ImportEntry& entry)
+		{
+			if (entry.ModuleName.data() != currentModule.data())
+			{
+				currentModule = entry.ModuleName;
+				currentModuleIndex = FindModule(entry.ModuleName).value_or(std::numeric_limits<uint32_t>::max());
+			}
+
+			if (currentModuleIndex != std::numeric_limits<uint32_t>::max())
+			{
+				m_Entries.push_back({currentModuleIndex, entry.Name, entry.Ordinal, entry.SlotRVA});
+			}
+			return true;
+		});
+
+		// A function imported more than once keeps its first slot, same as the loader would bind the first descriptor
+		std::ranges::stable_sort(m_Entries, std::less{}, &ImportIndex::GetKey);
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include "PortableExecutable.h"
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Import address table slots of a module, sorted by the imported module and function names.
+namespace xSE::PE
+{
+	class ImportIndex final
+	{
+		private:
+			struct Entry final
+			{
+				uint32_t ModuleIndex = 0;
+				std::string_view Name;
+				uint32_t Ordinal = 0;
+				uint32_t SlotRVA = 0;
+			};
+			using Key = std::tuple<uint32_t, std::string_view, uint32_t>;
+
+		private:
+			// Module names are compared case-insensitively, so they are stored in lower case. Sorted, the index in this list identifies the module.
+			std::vector<std::string> m_ModuleNames;
+
+			// Sorted by module name, then by function name, then by ordinal. Function names point into the image data.
+			std::vector<Entry> m_Entries;
+
+		private:
+			static Key GetKey(const Entry& entry) noexcept;
+
+			std::optional<uint32_t> FindModule(std::string_view moduleName) const noexcept;
+			std::optional<uint32_t> FindSlot(std::string_view moduleName, std::string_view name, uint32_t ordinal) const;
+
+		public:
+			ImportIndex() = default;
+			ImportIndex(const ImageReader& image);
+
+		public:
+			bool IsEmpty() const noexcept
+			{
+				return m_Entries.empty();
+			}
+			size_t GetModuleCount() const noexcept
+			{
+				return m_ModuleNames.size();
+			}
+			size_t GetEntryCount() const noexcept
+			{
+				return m_Entries.size();
+			}
+
+			// RVA of the import address table slot for the function imported from the given module
+			std::optional<uint32_t> FindSlot(std::string_view moduleName, std::string_view functionName) const
+			{
+				return functionName.empty() ? std::nullopt : FindSlot(moduleName, functionName, 0);
+			}
+			std::optional<uint32_t> FindSlot(std::string_view moduleName, uint32_t ordinal) const
+			{
+				return FindSlot(moduleName, {}, ordinal);
+			}
+	};
+}
@@ -0,0 +1,59 @@
+#include "pch.hpp"
+#include "MappedFile.h"
+
+namespace xSE
+{
+	bool MappedFile::Open(const kxf::FSPath& path) noexcept
+	{
+		Close();
+
+		const kxf::String fullPath = path.GetFullPath();
+		m_FileHandle = ::CreateFileW(fullPath.wc_str(), GENERIC_READ, FILE_SHARE_READ|FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL|FILE_FLAG_RANDOM_ACCESS, nullptr);
+		if (m_FileHandle == INVALID_HANDLE_VALUE)
+		{
+			m_FileHandle = nullptr;
+			return false;
+		}
+
+		LARGE_INTEGER size = {};
+		if (!::GetFileSizeEx(m_FileHandle, &size) || size.QuadPart <= 0 || static_cast<uint64_t>(size.QuadPart) > std::numeric_limits<size_t>::max())
+		{
+			// Empty files can't be mapped and anything larger than the address space isn't a valid image anyway
+			Close();
+			return false;
+		}
+
+		m_MappingHandle = ::CreateFileMappingW(m_FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (m_MappingHandle)
+		{
+			m_View = ::MapViewOfFile(m_MappingHandle, FILE_MAP_READ, 0, 0, 0);
+			if (m_View)
+			{
+				m_Size = static_cast<size_t>(size.QuadPart);
+				return true;
+			}
+		}
+
+		Close();
+		return false;
+	}
+	void MappedFile::Close() noexcept
+	{
+		if (m_View)
+		{
+			::UnmapViewOfFile(m_View);
+			m_View = nullptr;
+		}
+		if (m_MappingHandle)
+		{
+			::CloseHandle(m_MappingHandle);
+			m_MappingHandle = nullptr;
+		}
+		if (m_FileHandle)
+		{
+			::CloseHandle(m_FileHandle);
+			m_FileHandle = nullptr;
+		}
+		m_Size = 0;
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "Framework.hpp"
+#include <span>
+
+namespace xSE
+{
+	// Read-only view of a file. Only the pages that are actually touched are read from the disk,
+	// which makes it much cheaper than loading a library as a resource just to look at its headers.
+	class MappedFile final
+	{
+		private:
+			void* m_FileHandle = nullptr;
+			void* m_MappingHandle = nullptr;
+			const void* m_View = nullptr;
+			size_t m_Size = 0;
+
+		public:
+			MappedFile() noexcept = default;
+			MappedFile(const kxf::FSPath& path) noexcept
+			{
+				Open(path);
+			}
+			MappedFile(const MappedFile&) = delete;
+			~MappedFile() noexcept
+			{
+				Close();
+			}
+
+		public:
+			bool IsOpened() const noexcept
+			{
+				return m_View != nullptr;
+			}
+			std::span<const std::byte> GetView() const noexcept
+			{
+				return {static_cast<const std::byte*>(m_View), m_Size};
+			}
+
+			bool Open(const kxf::FSPath& path) noexcept;
+			void Close() noexcept;
+
+		public:
+			explicit operator bool() const noexcept
+			{
+				return IsOpened();
+			}
+			bool operator!() const noexcept
+			{
+				return !IsOpened();
+			}
+
+			MappedFile& operator=(const MappedFile&) = delete;
+	};
+}
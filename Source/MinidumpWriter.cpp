@@ -0,0 +1,239 @@
+#include "pch.hpp"
+#include "MinidumpWriter.h"
+#include "PluginListStream.h"
+#include <cwchar>
+#pragma comment(lib, "DbgHelp.lib")
+
+namespace
+{
+	// How long the faulting thread waits for the dump. The watchdog can get stuck if the faulting thread holds
+	// the loader lock, the exception is passed on after this anyway.
+	constexpr DWORD g_WriteTimeout = 60000;
+
+	struct WriteCallbackContext final
+	{
+		uint64_t MaxSize = 0;
+		bool SizeExceeded = false;
+	};
+
+	BOOL CALLBACK OnMinidumpCallback(void* context, const MINIDUMP_CALLBACK_INPUT* input, MINIDUMP_CALLBACK_OUTPUT* output)
+	{
+		auto& callbackContext = *static_cast<WriteCallbackContext*>(context);
+		switch (input->CallbackType)
+		{
+			case IoStartCallback:
+			{
+				// Take over the writes so the size can be checked as the dump is streamed to the file
+				output->Status = S_FALSE;
+				break;
+			}
+			case IoWriteAllCallback:
+			{
+				const auto& io = input->Io;
+				if (callbackContext.MaxSize != 0 && io.Offset + io.BufferBytes > callbackContext.MaxSize)
+				{
+					callbackContext.SizeExceeded = true;
+					output->Status = E_FAIL;
+					break;
+				}
+
+				LARGE_INTEGER offset = {};
+				offset.QuadPart = static_cast<LONGLONG>(io.Offset);
+
+				DWORD written = 0;
+				const bool success = ::SetFilePointerEx(io.Handle, offset, nullptr, FILE_BEGIN) && ::WriteFile(io.Handle, io.Buffer, io.BufferBytes, &written, nullptr) && written == io.BufferBytes;
+				output->Status = success ? S_OK : E_FAIL;
+				break;
+			}
+			case IoFinishCallback:
+			{
+				output->Status = S_OK;
+				break;
+			}
+		}
+		return TRUE;
+	}
+}
+
+namespace xSE
+{
+	DWORD WINAPI MinidumpWriter::WatchdogProc(void* context)
+	{
+		auto& writer = *static_cast<MinidumpWriter*>(context);
+		while (::WaitForSingleObject(writer.m_RequestEvent, INFINITE) == WAIT_OBJECT_0 && !writer.m_IsStopping)
+		{
+			writer.m_RequestResult = writer.DoWrite();
+			::SetEvent(writer.m_CompleteEvent);
+		}
+		return 0;
+	}
+	bool MinidumpWriter::DoWrite() noexcept
+	{
+		// Formatted on the stack, the heap can be in any state if the exception came from it
+		SYSTEMTIME time = {};
+		::GetLocalTime(&time);
+
+		wchar_t filePath[MAX_PATH + 64] = {};
+		std::swprintf(filePath, std::size(filePath), L"%s %04u-%02u-%02u %02u-%02u-%02u %u.dmp", m_FilePathBase, time.wYear, time.wMonth, time.wDay, time.wHour, time.wMinute, time.wSecond, m_RequestThreadID);
+
+		HANDLE file = ::CreateFileW(filePath, GENERIC_READ|GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		// The plugin list is left out if it's being replaced right now
+		const bool withUserStream = m_StreamLock.try_lock_for(std::chrono::seconds(1));
+		bool sizeExceeded = false;
+		bool result = WriteToFile(file, m_Options.Type, withUserStream, sizeExceeded);
+		if (!result && sizeExceeded && m_Options.Type != MiniDumpNormal)
+		{
+			LARGE_INTEGER offset = {};
+			::SetFilePointerEx(file, offset, nullptr, FILE_BEGIN);
+			::SetEndOfFile(file);
+
+			result = WriteToFile(file, MiniDumpNormal, withUserStream, sizeExceeded);
+		}
+		if (withUserStream)
+		{
+			m_StreamLock.unlock();
+		}
+		::CloseHandle(file);
+
+		if (!result)
+		{
+			::DeleteFileW(filePath);
+		}
+		return result;
+	}
+	bool MinidumpWriter::WriteToFile(HANDLE file, MINIDUMP_TYPE type, bool withUserStream, bool& sizeExceeded) noexcept
+	{
+		MINIDUMP_EXCEPTION_INFORMATION exceptionInfo = {};
+		exceptionInfo.ThreadId = m_RequestThreadID;
+		exceptionInfo.ExceptionPointers = &m_RequestException;
+		exceptionInfo.ClientPointers = FALSE;
+
+		MINIDUMP_USER_STREAM userStream = {};
+		userStream.Type = PluginListStream::StreamType;
+		userStream.BufferSize = static_cast<ULONG>(m_PluginStream.size());
+		userStream.Buffer = m_PluginStream.data();
+
+		MINIDUMP_USER_STREAM_INFORMATION userStreams = {};
+		userStreams.UserStreamCount = withUserStream && !m_PluginStream.empty() ? 1 : 0;
+		userStreams.UserStreamArray = &userStream;
+
+		WriteCallbackContext callbackContext;
+		callbackContext.MaxSize = m_Options.MaxSize;
+
+		MINIDUMP_CALLBACK_INFORMATION callback = {};
+		callback.CallbackRoutine = OnMinidumpCallback;
+		callback.CallbackParam = &callbackContext;
+
+		const bool result = ::MiniDumpWriteDump(::GetCurrentProcess(), ::GetCurrentProcessId(), file, type, &exceptionInfo, &userStreams, &callback);
+		sizeExceeded = callbackContext.SizeExceeded;
+		return result;
+	}
+
+	bool MinidumpWriter::Start(Options options)
+	{
+		if (m_Thread)
+		{
+			return true;
+		}
+
+		m_Options = std::move(options);
+		const kxf::String filePathBase = (m_Options.Directory / "xSE PluginPreloader").GetFullPath();
+		if (filePathBase.length() + 1 > std::size(m_FilePathBase))
+		{
+			return false;
+		}
+		std::wcsncpy(m_FilePathBase, filePathBase.wc_str(), std::size(m_FilePathBase) - 1);
+
+		m_RequestEvent = ::CreateEventW(nullptr, FALSE, FALSE, nullptr);
+		m_CompleteEvent = ::CreateEventW(nullptr, FALSE, FALSE, nullptr);
+		if (m_RequestEvent && m_CompleteEvent)
+		{
+			// Threads don't start running until the loader lock is released, but it can be created from 'DllMain'
+			m_Thread = ::CreateThread(nullptr, 0, WatchdogProc, this, 0, nullptr);
+		}
+
+		if (!m_Thread)
+		{
+			Stop();
+			return false;
+		}
+		return true;
+	}
+	void MinidumpWriter::Stop() noexcept
+	{
+		if (m_Thread)
+		{
+			// Threads are already gone when the process is exiting, otherwise the watchdog exits as soon as it wakes up.
+			// It doesn't wait long because the thread can't finish exiting while we're holding the loader lock.
+			m_IsStopping = true;
+			::SetEvent(m_RequestEvent);
+			::WaitForSingleObject(m_Thread, 1000);
+
+			::CloseHandle(m_Thread);
+			m_Thread = nullptr;
+		}
+		if (m_RequestEvent)
+		{
+			::CloseHandle(m_RequestEvent);
+			m_RequestEvent = nullptr;
+		}
+		if (m_CompleteEvent)
+		{
+			::CloseHandle(m_CompleteEvent);
+			m_CompleteEvent = nullptr;
+		}
+	}
+
+	void MinidumpWriter::SetPluginStream(std::vector<std::byte> stream)
+	{
+		std::lock_guard lock(m_StreamLock);
+		m_PluginStream = std::move(stream);
+	}
+	bool MinidumpWriter::Write(const EXCEPTION_POINTERS& exceptionInfo) noexcept
+	{
+		if (!m_Thread || m_WrittenCount.load(std::memory_order_relaxed) >= m_Options.MaxCount)
+		{
+			return false;
+		}
+
+		bool expected = false;
+		if (!m_IsBusy.compare_exchange_strong(expected, true, std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		bool result = false;
+		if (m_WrittenCount.load(std::memory_order_relaxed) < m_Options.MaxCount)
+		{
+			m_RequestThreadID = ::GetCurrentThreadId();
+			m_RequestRecord = *exceptionInfo.ExceptionRecord;
+			m_RequestContext = *exceptionInfo.ContextRecord;
+			m_RequestException.ExceptionRecord = &m_RequestRecord;
+			m_RequestException.ContextRecord = &m_RequestContext;
+			m_RequestResult = false;
+
+			::SetEvent(m_RequestEvent);
+			if (::WaitForSingleObject(m_CompleteEvent, g_WriteTimeout) == WAIT_OBJECT_0)
+			{
+				result = m_RequestResult;
+				if (result)
+				{
+					m_WrittenCount.fetch_add(1, std::memory_order_relaxed);
+				}
+			}
+			else
+			{
+				// The watchdog is still busy with this request, don't let anyone else in
+				return false;
+			}
+		}
+
+		m_IsBusy.store(false, std::memory_order_release);
+		return result;
+	}
+}
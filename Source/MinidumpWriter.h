@@ -0,0 +1,87 @@
+#pragma once
+#include "Framework.hpp"
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <DbgHelp.h>
+
+namespace xSE
+{
+	// Writes minidumps from a watchdog thread started in advance. The faulting thread only passes its exception
+	// to the watchdog and waits, so it doesn't need any stack, heap or locks of its own to get a dump written.
+	class MinidumpWriter final
+	{
+		public:
+			struct Options final
+			{
+				kxf::FSPath Directory;
+				MINIDUMP_TYPE Type = MiniDumpNormal;
+
+				// If the dump of the selected type would be bigger, a 'MiniDumpNormal' one is written instead. Zero for no limit.
+				uint64_t MaxSize = 0;
+
+				// Dumps written per session
+				size_t MaxCount = 1;
+			};
+
+		private:
+			Options m_Options;
+			wchar_t m_FilePathBase[MAX_PATH] = {};
+
+			HANDLE m_Thread = nullptr;
+			HANDLE m_RequestEvent = nullptr;
+			HANDLE m_CompleteEvent = nullptr;
+			std::atomic<bool> m_IsBusy = false;
+			std::atomic<bool> m_IsStopping = false;
+			std::atomic<size_t> m_WrittenCount = 0;
+
+			// Current request, copied by the faulting thread before it signals the watchdog. The watchdog can outlive
+			// the wait if it times out, so it must not point into the faulting thread's stack.
+			DWORD m_RequestThreadID = 0;
+			EXCEPTION_RECORD m_RequestRecord = {};
+			CONTEXT m_RequestContext = {};
+			EXCEPTION_POINTERS m_RequestException = {};
+			bool m_RequestResult = false;
+
+			// Serialized user stream, replaced as the plugins are loaded
+			std::timed_mutex m_StreamLock;
+			std::vector<std::byte> m_PluginStream;
+
+		private:
+			static DWORD WINAPI WatchdogProc(void* context);
+			bool DoWrite() noexcept;
+			bool WriteToFile(HANDLE file, MINIDUMP_TYPE type, bool withUserStream, bool& sizeExceeded) noexcept;
+
+		public:
+			MinidumpWriter() noexcept = default;
+			MinidumpWriter(const MinidumpWriter&) = delete;
+			~MinidumpWriter()
+			{
+				Stop();
+			}
+
+		public:
+			bool IsRunning() const noexcept
+			{
+				return m_Thread != nullptr;
+			}
+			// Only the dumps which were written successfully
+			size_t GetWrittenCount() const noexcept
+			{
+				return m_WrittenCount.load(std::memory_order_relaxed);
+			}
+
+			bool Start(Options options);
+			void Stop() noexcept;
+
+			// Stored for the 'PluginListStream' user stream of the following dumps
+			void SetPluginStream(std::vector<std::byte> stream);
+
+			// Called from the exception handler on the faulting thread, blocks until the dump is written or the watchdog times out.
+			// Only one dump is written at a time, exceptions on other threads in the meantime are skipped.
+			bool Write(const EXCEPTION_POINTERS& exceptionInfo) noexcept;
+
+		public:
+			MinidumpWriter& operator=(const MinidumpWriter&) = delete;
+	};
+}
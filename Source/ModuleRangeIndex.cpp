@@ -0,0 +1,81 @@
+#include "pch.hpp"
+#include "ModuleRangeIndex.h"
+#include <algorithm>
+
+namespace xSE
+{
+	const ModuleRange* ModuleRangeIndex::DoFind(const Snapshot& snapshot, uint64_t address) const noexcept
+	{
+		// The last module starting at or below the address is the only candidate, the ranges don't overlap
+		auto it = std::ranges::upper_bound(snapshot, address, std::less{}, &ModuleRange::Begin);
+		if (it != snapshot.begin() && std::prev(it)->Contains(address))
+		{
+			return &*std::prev(it);
+		}
+		return nullptr;
+	}
+	void ModuleRangeIndex::Publish(Snapshot snapshot)
+	{
+		std::ranges::sort(snapshot, std::less{}, &ModuleRange::Begin);
+
+		auto newSnapshot = std::make_unique<const Snapshot>(std::move(snapshot));
+		m_Current.exchange(newSnapshot.get(), std::memory_order_seq_cst);
+		if (m_CurrentOwner)
+		{
+			m_Retired.emplace_back(std::move(m_CurrentOwner));
+		}
+		m_CurrentOwner = std::move(newSnapshot);
+
+		// A reader which comes after the swap can only see the new snapshot, so nobody can be using the retired ones
+		// if there are no readers right now. Otherwise they'll be freed on one of the next changes.
+		if (m_ReaderCount.load(std::memory_order_seq_cst) == 0)
+		{
+			m_Retired.clear();
+		}
+	}
+
+	ModuleRangeIndex::~ModuleRangeIndex()
+	{
+		m_Current = nullptr;
+	}
+
+	size_t ModuleRangeIndex::GetModuleCount() const noexcept
+	{
+		std::lock_guard lock(m_WriteLock);
+		return m_CurrentOwner ? m_CurrentOwner->size() : 0;
+	}
+
+	void ModuleRangeIndex::Reset(std::vector<ModuleRange> modules)
+	{
+		std::lock_guard lock(m_WriteLock);
+		Publish(std::move(modules));
+	}
+	void ModuleRangeIndex::Add(ModuleRange module)
+	{
+		std::lock_guard lock(m_WriteLock);
+
+		Snapshot snapshot = m_CurrentOwner ? *m_CurrentOwner : Snapshot();
+		std::erase_if(snapshot, [&](const ModuleRange& item)
+		{
+			return item.Begin == module.Begin;
+		});
+		snapshot.emplace_back(std::move(module));
+
+		Publish(std::move(snapshot));
+	}
+	bool ModuleRangeIndex::Remove(uint64_t begin)
+	{
+		std::lock_guard lock(m_WriteLock);
+
+		Snapshot snapshot = m_CurrentOwner ? *m_CurrentOwner : Snapshot();
+		if (std::erase_if(snapshot, [&](const ModuleRange& item)
+		{
+			return item.Begin == begin;
+		}) != 0)
+		{
+			Publish(std::move(snapshot));
+			return true;
+		}
+		return false;
+	}
+}
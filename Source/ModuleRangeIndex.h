@@ -0,0 +1,86 @@
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include <type_traits>
+
+// Lock-free lookup of the module containing an address, over an immutable snapshot replaced on every change.
+namespace xSE
+{
+	struct ModuleRange final
+	{
+		uint64_t Begin = 0;
+		uint64_t End = 0;
+		std::string Name;
+
+		bool Contains(uint64_t address) const noexcept
+		{
+			return address >= Begin && address < End;
+		}
+	};
+
+	class ModuleRangeIndex final
+	{
+		private:
+			using Snapshot = std::vector<ModuleRange>;
+
+		private:
+			std::atomic<const Snapshot*> m_Current = nullptr;
+			mutable std::atomic<size_t> m_ReaderCount = 0;
+
+			// Snapshots replaced while someone could still be reading them, freed once there are no readers
+			mutable std::mutex m_WriteLock;
+			std::unique_ptr<const Snapshot> m_CurrentOwner;
+			std::vector<std::unique_ptr<const Snapshot>> m_Retired;
+
+		private:
+			const ModuleRange* DoFind(const Snapshot& snapshot, uint64_t address) const noexcept;
+			void Publish(Snapshot snapshot);
+
+		public:
+			ModuleRangeIndex() = default;
+			ModuleRangeIndex(const ModuleRangeIndex&) = delete;
+			~ModuleRangeIndex();
+
+		public:
+			size_t GetModuleCount() const noexcept;
+
+			// Replaces all modules at once
+			void Reset(std::vector<ModuleRange> modules);
+
+			// A module with the same base address replaces the existing one
+			void Add(ModuleRange module);
+			bool Remove(uint64_t begin);
+
+			// Calls the function with the module containing the address, the reference is valid only inside the call.
+			// Returns false without calling it if the address doesn't belong to any module.
+			template<class TFunc>
+			bool Find(uint64_t address, TFunc&& func) const noexcept(std::is_nothrow_invocable_v<TFunc, const ModuleRange&>)
+			{
+				// Writers free replaced snapshots only when this count is zero right after the swap
+				m_ReaderCount.fetch_add(1, std::memory_order_seq_cst);
+
+				bool found = false;
+				if (const Snapshot* snapshot = m_Current.load(std::memory_order_seq_cst))
+				{
+					if (const ModuleRange* module = DoFind(*snapshot, address))
+					{
+						found = true;
+						std::invoke(func, *module);
+					}
+				}
+
+				m_ReaderCount.fetch_sub(1, std::memory_order_release);
+				return found;
+			}
+
+		public:
+			ModuleRangeIndex& operator=(const ModuleRangeIndex&) = delete;
+	};
+}
@@ -0,0 +1,204 @@
+#include "pch.hpp"
+#include "PluginDependencyGraph.h"
+#include <queue>
+#include <functional>
+#include <algorithm>
+#include <limits>
+
+namespace xSE
+{
+	std::string PluginDependencyGraph::NormalizeName(std::string_view moduleName)
+	{
+		// Module names in import tables are ASCII and the loader compares them case-insensitively
+		std::string name(moduleName);
+		for (char& c: name)
+		{
+			if (c >= 'A' && c <= 'Z')
+			{
+				c = static_cast<char>(c - 'A' + 'a');
+			}
+		}
+		return name;
+	}
+
+	void PluginDependencyGraph::Build()
+	{
+		for (size_t i = 0; i < m_Nodes.size(); i++)
+		{
+			Node& node = m_Nodes[i];
+			node.Dependencies.clear();
+
+			for (const std::string& importName: node.Imports)
+			{
+				if (auto it = m_NodeIndex.find(NormalizeName(importName)); it != m_NodeIndex.end() && it->second != i)
+				{
+					if (std::ranges::find(node.Dependencies, it->second) == node.Dependencies.end())
+					{
+						node.Dependencies.emplace_back(it->second);
+					}
+				}
+			}
+		}
+		m_IsBuilt = true;
+	}
+	std::vector<std::vector<size_t>> PluginDependencyGraph::FindStronglyConnectedComponents() const
+	{
+		// Tarjan's algorithm, components are produced in reverse topological order (dependencies first)
+		constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+		std::vector<std::vector<size_t>> components;
+		std::vector<size_t> indices(m_Nodes.size(), npos);
+		std::vector<size_t> lowLinks(m_Nodes.size(), 0);
+		std::vector<bool> onStack(m_Nodes.size(), false);
+		std::vector<size_t> stack;
+		size_t nextIndex = 0;
+
+		std::function<void(size_t)> Visit = [&](size_t node)
+		{
+			indices[node] = nextIndex;
+			lowLinks[node] = nextIndex;
+			nextIndex++;
+
+			stack.push_back(node);
+			onStack[node] = true;
+
+			for (size_t dependency: m_Nodes[node].Dependencies)
+			{
+				if (indices[dependency] == npos)
+				{
+					Visit(dependency);
+					lowLinks[node] = std::min(lowLinks[node], lowLinks[dependency]);
+				}
+				else if (onStack[dependency])
+				{
+					lowLinks[node] = std::min(lowLinks[node], indices[dependency]);
+				}
+			}
+
+			if (lowLinks[node] == indices[node])
+			{
+				auto& component = components.emplace_back();
+				size_t item = npos;
+				do
+				{
+					item = stack.back();
+					stack.pop_back();
+					onStack[item] = false;
+					component.push_back(item);
+				}
+				while (item != node);
+
+				std::ranges::sort(component);
+			}
+		};
+
+		for (size_t i = 0; i < m_Nodes.size(); i++)
+		{
+			if (indices[i] == npos)
+			{
+				Visit(i);
+			}
+		}
+		return components;
+	}
+
+	size_t PluginDependencyGraph::AddNode(std::string_view moduleName, std::vector<std::string> imports)
+	{
+		const size_t index = m_Nodes.size();
+
+		Node& node = m_Nodes.emplace_back();
+		node.Name = moduleName;
+		node.Imports = std::move(imports);
+
+		// If the same module name is added twice, the first one is the one the loader is going to pick
+		m_NodeIndex.try_emplace(NormalizeName(moduleName), index);
+		m_IsBuilt = false;
+
+		return index;
+	}
+	const std::vector<size_t>& PluginDependencyGraph::GetDependencies(size_t index)
+	{
+		if (!m_IsBuilt)
+		{
+			Build();
+		}
+		return m_Nodes[index].Dependencies;
+	}
+
+	PluginDependencyGraph::SortResult PluginDependencyGraph::Sort()
+	{
+		if (!m_IsBuilt)
+		{
+			Build();
+		}
+
+		SortResult result;
+		result.Order.reserve(m_Nodes.size());
+
+		// Collapse cycles into single components so the rest of the graph can be ordered normally
+		const auto components = FindStronglyConnectedComponents();
+		std::vector<size_t> componentOf(m_Nodes.size(), 0);
+		for (size_t i = 0; i < components.size(); i++)
+		{
+			for (size_t node: components[i])
+			{
+				componentOf[node] = i;
+			}
+			if (components[i].size() > 1)
+			{
+				result.Cycles.emplace_back(components[i]);
+			}
+		}
+
+		std::vector<std::vector<size_t>> dependents(components.size());
+		std::vector<size_t> pendingCount(components.size(), 0);
+		for (size_t i = 0; i < components.size(); i++)
+		{
+			std::vector<size_t> dependencies;
+			for (size_t node: components[i])
+			{
+				for (size_t dependency: m_Nodes[node].Dependencies)
+				{
+					const size_t dependencyComponent = componentOf[dependency];
+					if (dependencyComponent != i && std::ranges::find(dependencies, dependencyComponent) == dependencies.end())
+					{
+						dependencies.push_back(dependencyComponent);
+						dependents[dependencyComponent].push_back(i);
+					}
+				}
+			}
+			pendingCount[i] = dependencies.size();
+		}
+
+		// Kahn's algorithm, ties are broken by the lowest original node index to keep the order stable.
+		// Components are sorted, so their first node is the lowest one.
+		auto CompareComponents = [&](size_t left, size_t right)
+		{
+			return components[left].front() > components[right].front();
+		};
+		std::priority_queue<size_t, std::vector<size_t>, decltype(CompareComponents)> ready(CompareComponents);
+
+		for (size_t i = 0; i < components.size(); i++)
+		{
+			if (pendingCount[i] == 0)
+			{
+				ready.push(i);
+			}
+		}
+		while (!ready.empty())
+		{
+			const size_t component = ready.top();
+			ready.pop();
+
+			result.Order.insert(result.Order.end(), components[component].begin(), components[component].end());
+			for (size_t dependent: dependents[component])
+			{
+				if (--pendingCount[dependent] == 0)
+				{
+					ready.push(dependent);
+				}
+			}
+		}
+		return result;
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+
+// Load order resolution for plugins based on their import tables.
+namespace xSE
+{
+	class PluginDependencyGraph final
+	{
+		public:
+			struct SortResult final
+			{
+				// Node indices in the order they should be loaded, every node is listed exactly once
+				std::vector<size_t> Order;
+
+				// Groups of nodes that import each other, members of a group keep their original relative order
+				std::vector<std::vector<size_t>> Cycles;
+			};
+
+		public:
+			static std::string NormalizeName(std::string_view moduleName);
+
+		private:
+			struct Node final
+			{
+				std::string Name;
+				std::vector<std::string> Imports;
+				std::vector<size_t> Dependencies;
+			};
+
+		private:
+			std::vector<Node> m_Nodes;
+			std::unordered_map<std::string, size_t> m_NodeIndex;
+			bool m_IsBuilt = false;
+
+		private:
+			void Build();
+			std::vector<std::vector<size_t>> FindStronglyConnectedComponents() const;
+
+		public:
+			// Node name is a module file name ('Plugin.dll'), imports are module names as listed in the import table.
+			// Imports that don't match any node are ignored, these are resolved by the system loader as usual.
+			size_t AddNode(std::string_view moduleName, std::vector<std::string> imports);
+
+			size_t GetCount() const noexcept
+			{
+				return m_Nodes.size();
+			}
+			const std::string& GetName(size_t index) const noexcept
+			{
+				return m_Nodes[index].Name;
+			}
+			const std::vector<size_t>& GetDependencies(size_t index);
+
+			// Dependencies are placed before their dependents, otherwise the original order is preserved
+			SortResult Sort();
+	};
+}
@@ -0,0 +1,114 @@
+#include "pch.hpp"
+#include "PluginListStream.h"
+
+namespace
+{
+	constexpr size_t g_HeaderSize = 16;
+	constexpr size_t g_EntryHeaderSize = 24;
+
+	size_t GetPaddedSize(size_t size) noexcept
+	{
+		return (size + 3) & ~size_t(3);
+	}
+
+	template<class T>
+	void WriteValue(std::vector<std::byte>& buffer, T value)
+	{
+		for (size_t i = 0; i < sizeof(T); i++)
+		{
+			buffer.push_back(static_cast<std::byte>(static_cast<uint64_t>(value) >> (i * 8)));
+		}
+	}
+
+	template<class T>
+	bool ReadValue(std::span<const std::byte>& data, T& value) noexcept
+	{
+		if (data.size() < sizeof(T))
+		{
+			return false;
+		}
+
+		uint64_t result = 0;
+		for (size_t i = 0; i < sizeof(T); i++)
+		{
+			result |= static_cast<uint64_t>(data[i]) << (i * 8);
+		}
+		value = static_cast<T>(result);
+		data = data.subspan(sizeof(T));
+		return true;
+	}
+}
+
+namespace xSE
+{
+	std::vector<std::byte> PluginListStream::Encode(std::span<const Entry> entries)
+	{
+		size_t size = g_HeaderSize;
+		for (const Entry& entry: entries)
+		{
+			size += g_EntryHeaderSize + GetPaddedSize(entry.Name.size());
+		}
+
+		std::vector<std::byte> buffer;
+		buffer.reserve(size);
+
+		WriteValue<uint32_t>(buffer, Signature);
+		WriteValue<uint32_t>(buffer, Version);
+		WriteValue<uint32_t>(buffer, static_cast<uint32_t>(entries.size()));
+		WriteValue<uint32_t>(buffer, 0);
+
+		for (const Entry& entry: entries)
+		{
+			WriteValue<uint32_t>(buffer, static_cast<uint32_t>(entry.State));
+			WriteValue<uint64_t>(buffer, static_cast<uint64_t>(entry.LoadTime.count()));
+			WriteValue<uint64_t>(buffer, static_cast<uint64_t>(entry.InitializeTime.count()));
+			WriteValue<uint32_t>(buffer, static_cast<uint32_t>(entry.Name.size()));
+
+			const auto name = std::as_bytes(std::span(entry.Name));
+			buffer.insert(buffer.end(), name.begin(), name.end());
+			buffer.resize(buffer.size() + GetPaddedSize(name.size()) - name.size(), std::byte(0));
+		}
+		return buffer;
+	}
+	std::optional<std::vector<PluginListStream::Entry>> PluginListStream::Decode(std::span<const std::byte> data)
+	{
+		uint32_t signature = 0;
+		uint32_t version = 0;
+		uint32_t count = 0;
+		uint32_t reserved = 0;
+		if (!ReadValue(data, signature) || !ReadValue(data, version) || !ReadValue(data, count) || !ReadValue(data, reserved))
+		{
+			return {};
+		}
+		if (signature != Signature || version != Version || count > data.size() / g_EntryHeaderSize)
+		{
+			return {};
+		}
+
+		std::vector<Entry> entries;
+		entries.reserve(count);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			uint32_t state = 0;
+			uint64_t loadTime = 0;
+			uint64_t initializeTime = 0;
+			uint32_t nameLength = 0;
+			if (!ReadValue(data, state) || !ReadValue(data, loadTime) || !ReadValue(data, initializeTime) || !ReadValue(data, nameLength))
+			{
+				return {};
+			}
+			if (state > static_cast<uint32_t>(LoadState::FailedInitialize) || GetPaddedSize(nameLength) > data.size())
+			{
+				return {};
+			}
+
+			Entry& entry = entries.emplace_back();
+			entry.State = static_cast<LoadState>(state);
+			entry.LoadTime = std::chrono::nanoseconds(static_cast<int64_t>(loadTime));
+			entry.InitializeTime = std::chrono::nanoseconds(static_cast<int64_t>(initializeTime));
+			entry.Name.assign(reinterpret_cast<const char*>(data.data()), nameLength);
+			data = data.subspan(GetPaddedSize(nameLength));
+		}
+		return entries;
+	}
+}
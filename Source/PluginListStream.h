@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <chrono>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+// Minidump user stream with the plugins known to the preloader and their load status.
+namespace xSE
+{
+	class PluginListStream final
+	{
+		public:
+			// User stream types have to be above 'LastReservedStream' (0xFFFF)
+			static constexpr uint32_t StreamType = 0x78534550;
+
+			// 'xSPL' and the format version in the header
+			static constexpr uint32_t Signature = 0x4C505378;
+			static constexpr uint32_t Version = 1;
+
+			enum class LoadState: uint32_t
+			{
+				Loading,
+				Loaded,
+				Initialized,
+				FailedLoad,
+				FailedInitialize
+			};
+			struct Entry final
+			{
+				std::string Name;
+				LoadState State = LoadState::Loading;
+				std::chrono::nanoseconds LoadTime = {};
+				std::chrono::nanoseconds InitializeTime = {};
+
+				bool operator==(const Entry&) const = default;
+			};
+
+		public:
+			// Header: signature, version, entry count and a reserved field, all 32-bit.
+			// Entry: state (32-bit), load and initialization times in nanoseconds (64-bit), name length in bytes (32-bit)
+			// and the UTF-8 name without a terminator, padded with zeros to a multiple of four bytes.
+			static std::vector<std::byte> Encode(std::span<const Entry> entries);
+
+			// Returns nothing if the data is truncated or isn't a stream of a known version
+			static std::optional<std::vector<Entry>> Decode(std::span<const std::byte> data);
+	};
+}
@@ -0,0 +1,249 @@
+#include "pch.hpp"
+#include "PluginScanIndex.h"
+#include <iterator>
+
+namespace
+{
+	constexpr uint32_t g_IndexMagic = 0x49455378; // 'xSEI'
+	// Bump when the probe results change their meaning or layout, older indexes are discarded then
+	constexpr uint32_t g_IndexFormatVersion = 3;
+
+	namespace ProbeFlag
+	{
+		constexpr uint32_t IsValidImage = 1 << 0;
+		constexpr uint32_t HasPreloadFunction = 1 << 1;
+		constexpr uint32_t HasInitializeFunction = 1 << 2;
+	}
+
+	uint32_t PackResult(const xSE::PluginProbeResult& result) noexcept
+	{
+		uint32_t flags = 0;
+		flags |= result.IsValidImage ? ProbeFlag::IsValidImage : 0u;
+		flags |= result.HasPreloadFunction ? ProbeFlag::HasPreloadFunction : 0u;
+		flags |= result.HasInitializeFunction ? ProbeFlag::HasInitializeFunction : 0u;
+
+		return flags;
+	}
+	xSE::PluginProbeResult UnpackResult(uint32_t flags) noexcept
+	{
+		xSE::PluginProbeResult result;
+		result.IsValidImage = flags & ProbeFlag::IsValidImage;
+		result.HasPreloadFunction = flags & ProbeFlag::HasPreloadFunction;
+		result.HasInitializeFunction = flags & ProbeFlag::HasInitializeFunction;
+
+		return result;
+	}
+
+	class BufferWriter final
+	{
+		private:
+			std::vector<std::byte>& m_Buffer;
+
+		public:
+			BufferWriter(std::vector<std::byte>& buffer) noexcept
+				:m_Buffer(buffer)
+			{
+			}
+
+		public:
+			template<class T>
+			void Write(const T& value)
+			{
+				std::ranges::copy(std::as_bytes(std::span(&value, 1)), std::back_inserter(m_Buffer));
+			}
+			void Write(std::string_view value)
+			{
+				Write(static_cast<uint32_t>(value.size()));
+				std::ranges::copy(std::as_bytes(std::span(value)), std::back_inserter(m_Buffer));
+			}
+	};
+	class BufferReader final
+	{
+		private:
+			std::span<const std::byte> m_Data;
+			size_t m_Offset = 0;
+
+		public:
+			BufferReader(std::span<const std::byte> data) noexcept
+				:m_Data(data)
+			{
+			}
+
+		public:
+			template<class T>
+			bool Read(T& value) noexcept
+			{
+				if (m_Data.size() - m_Offset >= sizeof(T))
+				{
+					std::memcpy(&value, m_Data.data() + m_Offset, sizeof(T));
+					m_Offset += sizeof(T);
+					return true;
+				}
+				return false;
+			}
+			bool Read(std::string& value)
+			{
+				uint32_t length = 0;
+				if (Read(length) && m_Data.size() - m_Offset >= length)
+				{
+					value.assign(reinterpret_cast<const char*>(m_Data.data() + m_Offset), length);
+					m_Offset += length;
+					return true;
+				}
+				return false;
+			}
+			bool IsEnd() const noexcept
+			{
+				return m_Offset == m_Data.size();
+			}
+	};
+}
+
+namespace xSE
+{
+	std::optional<PluginProbeResult> PluginScanIndex::Find(std::string_view path, const FileStamp& stamp)
+	{
+		if (auto it = m_Entries.find(std::string(path)); it != m_Entries.end() && it->second.Stamp == stamp)
+		{
+			it->second.Used = true;
+			m_HitCount++;
+
+			return it->second.Result;
+		}
+
+		m_MissCount++;
+		return {};
+	}
+	void PluginScanIndex::Update(std::string_view path, const FileStamp& stamp, const PluginProbeResult& result)
+	{
+		Entry& entry = m_Entries[std::string(path)];
+		if (entry.Stamp != stamp || entry.Result != result || !entry.Used)
+		{
+			m_Modified = true;
+		}
+
+		entry.Stamp = stamp;
+		entry.Result = result;
+		entry.Used = true;
+	}
+	void PluginScanIndex::Discard(std::string_view path)
+	{
+		if (m_Entries.erase(std::string(path)) != 0)
+		{
+			m_Modified = true;
+		}
+	}
+	bool PluginScanIndex::IsModified() const noexcept
+	{
+		// Entries nobody asked for belong to files which are no longer there
+		return m_Modified || std::ranges::any_of(m_Entries, [](const auto& item)
+		{
+			return !item.second.Used;
+		});
+	}
+	void PluginScanIndex::Clear() noexcept
+	{
+		m_Modified = !m_Entries.empty();
+		m_Entries.clear();
+		m_HitCount = 0;
+		m_MissCount = 0;
+	}
+
+	bool PluginScanIndex::Deserialize(std::span<const std::byte> data)
+	{
+		m_Entries.clear();
+		m_Modified = true;
+
+		BufferReader reader(data);
+		uint32_t magic = 0;
+		uint32_t formatVersion = 0;
+		std::string signature;
+		uint32_t count = 0;
+
+		if (!reader.Read(magic) || magic != g_IndexMagic || !reader.Read(formatVersion) || formatVersion != g_IndexFormatVersion)
+		{
+			return false;
+		}
+		if (!reader.Read(signature) || signature != m_Signature || !reader.Read(count))
+		{
+			return false;
+		}
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			std::string path;
+			Entry entry;
+			uint32_t flags = 0;
+			uint32_t importCount = 0;
+			if (!reader.Read(path) || !reader.Read(entry.Stamp.Size) || !reader.Read(entry.Stamp.LastWriteTime) || !reader.Read(flags) || !reader.Read(importCount))
+			{
+				m_Entries.clear();
+				return false;
+			}
+
+			entry.Result = UnpackResult(flags);
+			for (uint32_t j = 0; j < importCount; j++)
+			{
+				if (!reader.Read(entry.Result.ImportedModules.emplace_back()))
+				{
+					m_Entries.clear();
+					return false;
+				}
+			}
+			m_Entries.insert_or_assign(std::move(path), entry);
+		}
+
+		if (!reader.IsEnd())
+		{
+			m_Entries.clear();
+			return false;
+		}
+
+		m_Modified = false;
+		return true;
+	}
+	std::vector<std::byte> PluginScanIndex::Serialize() const
+	{
+		// Sized up front, so the buffer is allocated once
+		size_t count = 0;
+		size_t size = sizeof(g_IndexMagic) + sizeof(g_IndexFormatVersion) + sizeof(uint32_t) + m_Signature.size() + sizeof(uint32_t);
+		for (const auto& [path, entry]: m_Entries)
+		{
+			if (entry.Used)
+			{
+				count++;
+				size += sizeof(uint32_t) + path.size() + sizeof(FileStamp) + sizeof(uint32_t) * 2;
+				for (const std::string& moduleName: entry.Result.ImportedModules)
+				{
+					size += sizeof(uint32_t) + moduleName.size();
+				}
+			}
+		}
+
+		std::vector<std::byte> buffer;
+		buffer.reserve(size);
+		BufferWriter writer(buffer);
+
+		writer.Write(g_IndexMagic);
+		writer.Write(g_IndexFormatVersion);
+		writer.Write(std::string_view(m_Signature));
+		writer.Write(static_cast<uint32_t>(count));
+
+		for (const auto& [path, entry]: m_Entries)
+		{
+			if (entry.Used)
+			{
+				writer.Write(std::string_view(path));
+				writer.Write(entry.Stamp.Size);
+				writer.Write(entry.Stamp.LastWriteTime);
+				writer.Write(PackResult(entry.Result));
+				writer.Write(static_cast<uint32_t>(entry.Result.ImportedModules.size()));
+				for (const std::string& moduleName: entry.Result.ImportedModules)
+				{
+					writer.Write(std::string_view(moduleName));
+				}
+			}
+		}
+		return buffer;
+	}
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <span>
+#include <unordered_map>
+
+// Persistent cache of plugin probe results, keyed by the file stamps the handler supplies.
+namespace xSE
+{
+	struct FileStamp final
+	{
+		uint64_t Size = 0;
+		uint64_t LastWriteTime = 0;
+
+		bool operator==(const FileStamp&) const noexcept = default;
+	};
+	struct PluginProbeResult final
+	{
+		bool IsValidImage = false;
+		bool HasPreloadFunction = false;
+		bool HasInitializeFunction = false;
+		std::vector<std::string> ImportedModules;
+
+		bool operator==(const PluginProbeResult&) const noexcept = default;
+	};
+}
+
+namespace xSE
+{
+	class PluginScanIndex final
+	{
+		private:
+			struct Entry final
+			{
+				FileStamp Stamp;
+				PluginProbeResult Result;
+				bool Used = false;
+			};
+
+		private:
+			std::unordered_map<std::string, Entry> m_Entries;
+			std::string m_Signature;
+			size_t m_HitCount = 0;
+			size_t m_MissCount = 0;
+			bool m_Modified = false;
+
+		public:
+			PluginScanIndex() = default;
+			PluginScanIndex(std::string signature)
+				:m_Signature(std::move(signature))
+			{
+			}
+
+		public:
+			const std::string& GetSignature() const noexcept
+			{
+				return m_Signature;
+			}
+			size_t GetCount() const noexcept
+			{
+				return m_Entries.size();
+			}
+			size_t GetHitCount() const noexcept
+			{
+				return m_HitCount;
+			}
+			size_t GetMissCount() const noexcept
+			{
+				return m_MissCount;
+			}
+			bool IsModified() const noexcept;
+
+			// Returns the stored result only if the file stamp matches exactly
+			std::optional<PluginProbeResult> Find(std::string_view path, const FileStamp& stamp);
+			void Update(std::string_view path, const FileStamp& stamp, const PluginProbeResult& result);
+
+			// For a file which couldn't be probed: nothing is stored for it, so it's probed again on the next launch
+			void Discard(std::string_view path);
+			void Clear() noexcept;
+
+			// Loading fails (and leaves the index empty) if the data is damaged or was created with a different signature
+			bool Deserialize(std::span<const std::byte> data);
+
+			// Only entries that were requested or updated since loading are written, so removed files drop out of the index
+			std::vector<std::byte> Serialize() const;
+	};
+}
@@ -0,0 +1,336 @@
+#include "pch.hpp"
+#include "PortableExecutable.h"
+
+namespace
+{
+	constexpr uint16_t g_DOSSignature = 0x5A4D; // 'MZ'
+	constexpr uint32_t g_NTSignature = 0x00004550; // 'PE\0\0'
+	constexpr uint16_t g_OptionalHeaderMagic32 = 0x10B;
+	constexpr uint16_t g_OptionalHeaderMagic64 = 0x20B;
+
+	constexpr size_t g_FileHeaderSize = 20;
+	constexpr size_t g_SectionHeaderSize = 40;
+	constexpr size_t g_ExportDirectorySize = 40;
+
+	// Upper bound for a sane export name length, protects against runaway scans on corrupted files
+	constexpr size_t g_MaxNameLength = 4096;
+
+	int CompareNames(std::string_view left, std::string_view right) noexcept
+	{
+		// Export names are sorted by the linker as a plain byte sequence (as 'strcmp' does)
+		return left.compare(right);
+	}
+}
+
+namespace xSE::PE
+{
+	bool ImageReader::ParseHeaders() noexcept
+	{
+		if (ReadAt<uint16_t>(0) != g_DOSSignature)
+		{
+			return false;
+		}
+
+		const auto ntHeadersOffset = ReadAt<uint32_t>(0x3C);
+		if (!ntHeadersOffset || ReadAt<uint32_t>(*ntHeadersOffset) != g_NTSignature)
+		{
+			return false;
+		}
+
+		// File header
+		const size_t fileHeaderOffset = *ntHeadersOffset + sizeof(uint32_t);
+		const auto machine = ReadAt<uint16_t>(fileHeaderOffset);
+		const auto sectionCount = ReadAt<uint16_t>(fileHeaderOffset + 2);
+		const auto optionalHeaderSize = ReadAt<uint16_t>(fileHeaderOffset + 16);
+		if (!machine || !sectionCount || !optionalHeaderSize)
+		{
+			return false;
+		}
+		m_Machine = *machine;
+		m_SectionCount = *sectionCount;
+
+		// Optional header
+		const size_t optionalHeaderOffset = fileHeaderOffset + g_FileHeaderSize;
+		const auto magic = ReadAt<uint16_t>(optionalHeaderOffset);
+		if (magic == g_OptionalHeaderMagic64)
+		{
+			m_Is64Bit = true;
+		}
+		else if (magic != g_OptionalHeaderMagic32)
+		{
+			return false;
+		}
+
+		const auto sizeOfHeaders = ReadAt<uint32_t>(optionalHeaderOffset + 60);
+		const size_t directoryCountOffset = optionalHeaderOffset + (m_Is64Bit ? 108 : 92);
+		const auto directoryCount = ReadAt<uint32_t>(directoryCountOffset);
+		if (!sizeOfHeaders || !directoryCount)
+		{
+			return false;
+		}
+		m_SizeOfHeaders = *sizeOfHeaders;
+		m_DirectoryCount = std::min<size_t>(*directoryCount, MaxDirectoryCount);
+
+		const size_t directoriesOffset = directoryCountOffset + sizeof(uint32_t);
+		for (size_t i = 0; i < m_DirectoryCount; i++)
+		{
+			auto rva = ReadAt<uint32_t>(directoriesOffset + i * 8);
+			auto size = ReadAt<uint32_t>(directoriesOffset + i * 8 + 4);
+			if (!rva || !size)
+			{
+				return false;
+			}
+			m_Directories[i] = {*rva, *size};
+		}
+
+		// Section table follows the optional header regardless of the directories count
+		m_SectionTableOffset = optionalHeaderOffset + *optionalHeaderSize;
+		return m_SectionTableOffset + m_SectionCount * g_SectionHeaderSize <= m_Data.size();
+	}
+	bool ImageReader::ParseExports() noexcept
+	{
+		if (m_ExportsParsed)
+		{
+			return m_ExportDirectory.RVA != 0;
+		}
+		m_ExportsParsed = true;
+
+		const DataDirectory directory = GetDirectory(DirectoryID::Export);
+		if (!directory)
+		{
+			return false;
+		}
+
+		const auto offset = RVAToOffset(directory.RVA, g_ExportDirectorySize);
+		if (!offset)
+		{
+			return false;
+		}
+
+		const auto ordinalBase = ReadAt<uint32_t>(*offset + 16);
+		const auto functionCount = ReadAt<uint32_t>(*offset + 20);
+		const auto nameCount = ReadAt<uint32_t>(*offset + 24);
+		const auto functionsRVA = ReadAt<uint32_t>(*offset + 28);
+		const auto namesRVA = ReadAt<uint32_t>(*offset + 32);
+		const auto nameOrdinalsRVA = ReadAt<uint32_t>(*offset + 36);
+		if (!ordinalBase || !functionCount || !nameCount || !functionsRVA || !namesRVA || !nameOrdinalsRVA)
+		{
+			return false;
+		}
+
+		// All three tables must be fully addressable, so the lookups below don't need to validate every entry
+		const auto functionsOffset = RVAToOffset(*functionsRVA, static_cast<size_t>(*functionCount) * sizeof(uint32_t));
+		const auto namesOffset = RVAToOffset(*namesRVA, static_cast<size_t>(*nameCount) * sizeof(uint32_t));
+		const auto nameOrdinalsOffset = RVAToOffset(*nameOrdinalsRVA, static_cast<size_t>(*nameCount) * sizeof(uint16_t));
+		if (!functionsOffset || (*nameCount != 0 && (!namesOffset || !nameOrdinalsOffset)))
+		{
+			return false;
+		}
+
+		m_ExportDirectory = directory;
+		m_ExportOrdinalBase = *ordinalBase;
+		m_ExportFunctionCount = *functionCount;
+		m_ExportNameCount = *nameCount;
+		m_ExportFunctionsOffset = *functionsOffset;
+		m_ExportNamesOffset = namesOffset.value_or(0);
+		m_ExportNameOrdinalsOffset = nameOrdinalsOffset.value_or(0);
+		return true;
+	}
+	std::optional<uint32_t> ImageReader::ReadExportName(uint32_t index, std::string_view& name) const noexcept
+	{
+		const auto nameRVA = ReadAt<uint32_t>(m_ExportNamesOffset + index * sizeof(uint32_t));
+		const auto functionIndex = ReadAt<uint16_t>(m_ExportNameOrdinalsOffset + index * sizeof(uint16_t));
+		if (nameRVA && functionIndex && *functionIndex < m_ExportFunctionCount)
+		{
+			name = GetStringAt(*nameRVA);
+			return *functionIndex;
+		}
+		return {};
+	}
+	ExportEntry ImageReader::MakeExportEntry(std::string_view name, uint32_t functionIndex) const noexcept
+	{
+		ExportEntry entry;
+		entry.Name = name;
+		entry.Ordinal = m_ExportOrdinalBase + functionIndex;
+		entry.RVA = ReadAt<uint32_t>(m_ExportFunctionsOffset + functionIndex * sizeof(uint32_t)).value_or(0);
+
+		// Forwarded exports point inside the export directory itself (to a 'Library.Function' string)
+		entry.IsForwarded = entry.RVA >= m_ExportDirectory.RVA && entry.RVA - m_ExportDirectory.RVA < m_ExportDirectory.Size;
+
+		return entry;
+	}
+
+	std::optional<uint32_t> ImageReader::ReadImportDescriptorName(size_t offset) const noexcept
+	{
+		const auto originalFirstThunk = ReadAt<uint32_t>(offset);
+		const auto name = ReadAt<uint32_t>(offset + 12);
+		const auto firstThunk = ReadAt<uint32_t>(offset + 16);
+		if (!originalFirstThunk || !name || !firstThunk || (*originalFirstThunk == 0 && *name == 0 && *firstThunk == 0))
+		{
+			return {};
+		}
+		return *name;
+	}
+
+	auto ImageReader::ReadImportDescriptor(size_t offset) const noexcept -> std::optional<ImportDescriptor>
+	{
+		const auto originalFirstThunk = ReadAt<uint32_t>(offset);
+		const auto name = ReadAt<uint32_t>(offset + 12);
+		const auto firstThunk = ReadAt<uint32_t>(offset + 16);
+		if (!originalFirstThunk || !name || !firstThunk || (*originalFirstThunk == 0 && *name == 0 && *firstThunk == 0))
+		{
+			return {};
+		}
+		return ImportDescriptor{*originalFirstThunk, *name, *firstThunk};
+	}
+	bool ImageReader::ReadImportThunk(uint32_t rva, ImportEntry& entry) const noexcept
+	{
+		// The high bit is the ordinal flag, otherwise the value is an RVA of the hint/name entry. The list is zero-terminated.
+		uint64_t value = 0;
+		bool isOrdinal = false;
+		if (m_Is64Bit)
+		{
+			const auto offset = RVAToOffset(rva, sizeof(uint64_t));
+			value = offset ? ReadAt<uint64_t>(*offset).value_or(0) : 0;
+			isOrdinal = value & (uint64_t(1) << 63);
+		}
+		else
+		{
+			const auto offset = RVAToOffset(rva, sizeof(uint32_t));
+			value = offset ? ReadAt<uint32_t>(*offset).value_or(0) : 0;
+			isOrdinal = value & (uint32_t(1) << 31);
+		}
+
+		if (value == 0)
+		{
+			return false;
+		}
+		else if (isOrdinal)
+		{
+			entry.Name = {};
+			entry.Ordinal = static_cast<uint32_t>(value & 0xFFFF);
+		}
+		else
+		{
+			// Skip the two bytes of the hint
+			entry.Name = GetStringAt(static_cast<uint32_t>(value) + sizeof(uint16_t));
+			entry.Ordinal = 0;
+		}
+		return true;
+	}
+
+	std::optional<size_t> ImageReader::RVAToOffset(uint32_t rva, size_t size) const noexcept
+	{
+		auto CheckBounds = [&](size_t offset) -> std::optional<size_t>
+		{
+			if (offset <= m_Data.size() && m_Data.size() - offset >= size)
+			{
+				return offset;
+			}
+			return {};
+		};
+
+		if (m_Layout == Layout::Image || rva < m_SizeOfHeaders)
+		{
+			return CheckBounds(rva);
+		}
+
+		for (size_t i = 0; i < m_SectionCount; i++)
+		{
+			const size_t headerOffset = m_SectionTableOffset + i * g_SectionHeaderSize;
+			const uint32_t virtualAddress = ReadAt<uint32_t>(headerOffset + 12).value_or(0);
+			const uint32_t rawSize = ReadAt<uint32_t>(headerOffset + 16).value_or(0);
+			const uint32_t rawOffset = ReadAt<uint32_t>(headerOffset + 20).value_or(0);
+
+			if (rva >= virtualAddress && rva - virtualAddress < rawSize)
+			{
+				// The requested range must not run past the raw data of this section
+				const size_t delta = rva - virtualAddress;
+				if (rawSize - delta < size)
+				{
+					return {};
+				}
+				return CheckBounds(static_cast<size_t>(rawOffset) + delta);
+			}
+		}
+		return {};
+	}
+	std::string_view ImageReader::GetStringAt(uint32_t rva) const noexcept
+	{
+		if (auto offset = RVAToOffset(rva, 1))
+		{
+			const char* begin = reinterpret_cast<const char*>(m_Data.data() + *offset);
+			const size_t available = std::min(m_Data.size() - *offset, g_MaxNameLength);
+
+			if (auto end = static_cast<const char*>(std::memchr(begin, '\0', available)))
+			{
+				return {begin, static_cast<size_t>(end - begin)};
+			}
+		}
+		return {};
+	}
+
+	size_t ImageReader::GetExportNameCount() noexcept
+	{
+		return ParseExports() ? m_ExportNameCount : 0;
+	}
+	size_t ImageReader::GetExportFunctionCount() noexcept
+	{
+		return ParseExports() ? m_ExportFunctionCount : 0;
+	}
+	uint32_t ImageReader::GetExportOrdinalBase() noexcept
+	{
+		return ParseExports() ? m_ExportOrdinalBase : 0;
+	}
+	std::optional<ExportEntry> ImageReader::FindExport(std::string_view name) noexcept
+	{
+		if (name.empty() || !ParseExports())
+		{
+			return {};
+		}
+
+		// The name pointer table is sorted, so we can stop after log2(n) comparisons
+		size_t first = 0;
+		size_t last = m_ExportNameCount;
+		while (first < last)
+		{
+			const size_t middle = first + (last - first) / 2;
+
+			std::string_view middleName;
+			const auto functionIndex = ReadExportName(static_cast<uint32_t>(middle), middleName);
+			if (!functionIndex)
+			{
+				return {};
+			}
+
+			const int order = CompareNames(middleName, name);
+			if (order == 0)
+			{
+				return MakeExportEntry(middleName, *functionIndex);
+			}
+			else if (order < 0)
+			{
+				first = middle + 1;
+			}
+			else
+			{
+				last = middle;
+			}
+		}
+		return {};
+	}
+	std::optional<ExportEntry> ImageReader::FindExport(uint32_t ordinal) noexcept
+	{
+		if (!ParseExports() || ordinal < m_ExportOrdinalBase || ordinal - m_ExportOrdinalBase >= m_ExportFunctionCount)
+		{
+			return {};
+		}
+
+		ExportEntry entry = MakeExportEntry({}, ordinal - m_ExportOrdinalBase);
+		if (entry.RVA == 0)
+		{
+			return {};
+		}
+		return entry;
+	}
+}
@@ -0,0 +1,296 @@
+#pragma once
+#include <cstdint>
+#include <algorithm>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <optional>
+#include <functional>
+#include <type_traits>
+
+// Minimal read-only PE parser for raw file views as well as images mapped by the system loader.
+namespace xSE::PE
+{
+	enum class Layout
+	{
+		// Raw file contents, RVAs are translated through the section table
+		File,
+
+		// Image mapped by the system loader, RVAs are offsets from the image base
+		Image
+	};
+	enum class DirectoryID: uint32_t
+	{
+		Export = 0,
+		Import = 1,
+		Resource = 2,
+		Exception = 3,
+		Security = 4,
+		BaseRelocation = 5,
+		Debug = 6,
+		Architecture = 7,
+		GlobalPointer = 8,
+		TLS = 9,
+		LoadConfig = 10,
+		BoundImport = 11,
+		IAT = 12,
+		DelayImport = 13,
+		COMDescriptor = 14
+	};
+
+	struct DataDirectory final
+	{
+		uint32_t RVA = 0;
+		uint32_t Size = 0;
+
+		explicit operator bool() const noexcept
+		{
+			return RVA != 0 && Size != 0;
+		}
+	};
+	struct ExportEntry final
+	{
+		std::string_view Name;
+		uint32_t Ordinal = 0;
+		uint32_t RVA = 0;
+		bool IsForwarded = false;
+	};
+	struct ImportEntry final
+	{
+		std::string_view ModuleName;
+
+		// Empty for the functions imported by ordinal
+		std::string_view Name;
+		uint32_t Ordinal = 0;
+
+		// Import address table slot of the function
+		uint32_t SlotRVA = 0;
+	};
+}
+
+namespace xSE::PE
+{
+	class ImageReader final
+	{
+		public:
+			static constexpr size_t MaxDirectoryCount = 16;
+			static constexpr size_t ImportDescriptorSize = 20;
+
+		private:
+			struct ImportDescriptor final
+			{
+				uint32_t LookupTableRVA = 0;
+				uint32_t NameRVA = 0;
+				uint32_t AddressTableRVA = 0;
+			};
+
+		private:
+			std::span<const std::byte> m_Data;
+			Layout m_Layout = Layout::File;
+
+			uint16_t m_Machine = 0;
+			bool m_Is64Bit = false;
+			uint32_t m_SizeOfHeaders = 0;
+			size_t m_SectionTableOffset = 0;
+			size_t m_SectionCount = 0;
+			size_t m_DirectoryCount = 0;
+			DataDirectory m_Directories[MaxDirectoryCount];
+
+			// Export directory, cached on first use
+			DataDirectory m_ExportDirectory;
+			uint32_t m_ExportOrdinalBase = 0;
+			uint32_t m_ExportFunctionCount = 0;
+			uint32_t m_ExportNameCount = 0;
+			size_t m_ExportFunctionsOffset = 0;
+			size_t m_ExportNamesOffset = 0;
+			size_t m_ExportNameOrdinalsOffset = 0;
+			bool m_ExportsParsed = false;
+
+		private:
+			template<class T>
+			std::optional<T> ReadAt(size_t offset) const noexcept
+			{
+				if (offset > m_Data.size() || m_Data.size() - offset < sizeof(T))
+				{
+					return {};
+				}
+
+				T value;
+				std::memcpy(&value, m_Data.data() + offset, sizeof(T));
+				return value;
+			}
+
+			bool ParseHeaders() noexcept;
+			std::optional<uint32_t> ReadImportDescriptorName(size_t offset) const noexcept;
+			std::optional<ImportDescriptor> ReadImportDescriptor(size_t offset) const noexcept;
+			bool ReadImportThunk(uint32_t rva, ImportEntry& entry) const noexcept;
+			bool ParseExports() noexcept;
+			std::optional<uint32_t> ReadExportName(uint32_t index, std::string_view& name) const noexcept;
+			ExportEntry MakeExportEntry(std::string_view name, uint32_t functionIndex) const noexcept;
+
+		public:
+			ImageReader() noexcept = default;
+			ImageReader(std::span<const std::byte> data, Layout layout) noexcept
+				:m_Data(data), m_Layout(layout)
+			{
+				if (!ParseHeaders())
+				{
+					m_Data = {};
+				}
+			}
+
+		public:
+			bool IsNull() const noexcept
+			{
+				return m_Data.empty();
+			}
+			Layout GetLayout() const noexcept
+			{
+				return m_Layout;
+			}
+			uint16_t GetMachine() const noexcept
+			{
+				return m_Machine;
+			}
+			bool Is64Bit() const noexcept
+			{
+				return m_Is64Bit;
+			}
+
+			DataDirectory GetDirectory(DirectoryID id) const noexcept
+			{
+				const size_t index = static_cast<size_t>(id);
+				return index < m_DirectoryCount ? m_Directories[index] : DataDirectory();
+			}
+			std::optional<size_t> RVAToOffset(uint32_t rva, size_t size = 0) const noexcept;
+			std::string_view GetStringAt(uint32_t rva) const noexcept;
+
+			// Exports
+			size_t GetExportNameCount() noexcept;
+			size_t GetExportFunctionCount() noexcept;
+			uint32_t GetExportOrdinalBase() noexcept;
+			std::optional<ExportEntry> FindExport(std::string_view name) noexcept;
+			std::optional<ExportEntry> FindExport(uint32_t ordinal) noexcept;
+			bool ContainsExport(std::string_view name) noexcept
+			{
+				return FindExport(name).has_value();
+			}
+
+			template<class TFunc>
+			size_t EnumExports(TFunc&& func) noexcept(std::is_nothrow_invocable_v<TFunc, const ExportEntry&>)
+			{
+				if (!ParseExports())
+				{
+					return 0;
+				}
+
+				size_t count = 0;
+				for (uint32_t i = 0; i < m_ExportNameCount; i++)
+				{
+					std::string_view name;
+					if (auto functionIndex = ReadExportName(i, name))
+					{
+						count++;
+						if (!std::invoke(func, MakeExportEntry(name, *functionIndex)))
+						{
+							break;
+						}
+					}
+				}
+				return count;
+			}
+
+			// Imports
+			template<class TFunc>
+			size_t EnumImportedModules(TFunc&& func) const noexcept(std::is_nothrow_invocable_v<TFunc, std::string_view>)
+			{
+				const DataDirectory directory = GetDirectory(DirectoryID::Import);
+				if (!directory)
+				{
+					return 0;
+				}
+
+				size_t count = 0;
+				for (uint32_t rva = directory.RVA; ; rva += ImportDescriptorSize)
+				{
+					const auto offset = RVAToOffset(rva, ImportDescriptorSize);
+					if (!offset)
+					{
+						break;
+					}
+
+					// The descriptors array is terminated by a zeroed entry
+					const auto nameRVA = ReadImportDescriptorName(*offset);
+					if (!nameRVA)
+					{
+						break;
+					}
+
+					// A descriptor without a name is malformed, RVA 0 would read the DOS header as a module name
+					if (std::string_view name = *nameRVA != 0 ? GetStringAt(*nameRVA) : std::string_view(); !name.empty())
+					{
+						count++;
+						if (!std::invoke(func, name))
+						{
+							break;
+						}
+					}
+				}
+				return count;
+			}
+
+			// Enumerates imported functions of all modules, the name table is required for the mapped images
+			// since the loader overwrites the import address table with the actual addresses.
+			template<class TFunc>
+			size_t EnumImports(TFunc&& func) const noexcept(std::is_nothrow_invocable_v<TFunc, const ImportEntry&>)
+			{
+				const DataDirectory directory = GetDirectory(DirectoryID::Import);
+				if (!directory)
+				{
+					return 0;
+				}
+
+				const uint32_t thunkSize = m_Is64Bit ? sizeof(uint64_t) : sizeof(uint32_t);
+				size_t count = 0;
+				for (uint32_t rva = directory.RVA; ; rva += ImportDescriptorSize)
+				{
+					const auto offset = RVAToOffset(rva, ImportDescriptorSize);
+					if (!offset)
+					{
+						break;
+					}
+
+					const auto descriptor = ReadImportDescriptor(*offset);
+					if (!descriptor)
+					{
+						break;
+					}
+
+					uint32_t lookupTableRVA = descriptor->LookupTableRVA;
+					if (lookupTableRVA == 0 && m_Layout == Layout::File)
+					{
+						lookupTableRVA = descriptor->AddressTableRVA;
+					}
+
+					ImportEntry entry;
+					entry.ModuleName = descriptor->NameRVA != 0 ? GetStringAt(descriptor->NameRVA) : std::string_view();
+					if (entry.ModuleName.empty() || lookupTableRVA == 0)
+					{
+						continue;
+					}
+
+					for (uint32_t i = 0; ReadImportThunk(lookupTableRVA + i * thunkSize, entry); i++)
+					{
+						entry.SlotRVA = descriptor->AddressTableRVA + i * thunkSize;
+
+						count++;
+						if (!std::invoke(func, entry))
+						{
+							return count;
+						}
+					}
+				}
+				return count;
+			}
+	};
+}
@@ -1,6 +1,9 @@
+// Generated by 'Tools/GenerateProxyFunctions.py' from 'DInput8.exports', don't edit manually
+#pragma once
+
 namespace xSE::PluginPreloader::Library::DInput8
 {
-	enum
+	enum Enum
 	{
 		DirectInput8Create,
 		DllCanUnloadNow,
@@ -8,4 +11,15 @@ namespace xSE::PluginPreloader::Library::DInput8
 		DllRegisterServer,
 		DllUnregisterServer
 	};
+
+	constexpr const char* FileName = "DInput8.dll";
+	constexpr size_t Count = 5;
+	constexpr const char* Names[Count] =
+	{
+		"DirectInput8Create",
+		"DllCanUnloadNow",
+		"DllGetClassObject",
+		"DllRegisterServer",
+		"DllUnregisterServer"
+	};
 };
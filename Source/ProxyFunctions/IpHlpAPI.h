@@ -1,3 +1,6 @@
+// Generated by 'Tools/GenerateProxyFunctions.py' from 'IpHlpAPI.exports', don't edit manually
+#pragma once
+
 namespace xSE::PluginPreloader::Library::IpHlpAPI
 {
 	enum Enum
@@ -265,4 +268,272 @@ namespace xSE::PluginPreloader::Library::IpHlpAPI
 		if_nametoindex,
 		register_icmp
 	};
+
+	constexpr const char* FileName = "IpHlpAPI.dll";
+	constexpr size_t Count = 262;
+	constexpr const char* Names[Count] =
+	{
+		"AddIPAddress",
+		"AllocateAndGetInterfaceInfoFromStack",
+		"AllocateAndGetIpAddrTableFromStack",
+		"CPNatfwtCreateProviderInstance",
+		"CPNatfwtDeregisterProviderInstance",
+		"CPNatfwtDestroyProviderInstance",
+		"CPNatfwtIndicateReceivedBuffers",
+		"CPNatfwtRegisterProviderInstance",
+		"CancelIPChangeNotify",
+		"CancelMibChangeNotify2",
+		"ConvertGuidToStringA",
+		"ConvertGuidToStringW",
+		"ConvertInterfaceAliasToLuid",
+		"ConvertInterfaceGuidToLuid",
+		"ConvertInterfaceIndexToLuid",
+		"ConvertInterfaceLuidToAlias",
+		"ConvertInterfaceLuidToGuid",
+		"ConvertInterfaceLuidToIndex",
+		"ConvertInterfaceLuidToNameA",
+		"ConvertInterfaceLuidToNameW",
+		"ConvertInterfaceNameToLuidA",
+		"ConvertInterfaceNameToLuidW",
+		"ConvertInterfacePhysicalAddressToLuid",
+		"ConvertIpv4MaskToLength",
+		"ConvertLengthToIpv4Mask",
+		"ConvertRemoteInterfaceAliasToLuid",
+		"ConvertRemoteInterfaceGuidToLuid",
+		"ConvertRemoteInterfaceIndexToLuid",
+		"ConvertRemoteInterfaceLuidToAlias",
+		"ConvertRemoteInterfaceLuidToGuid",
+		"ConvertRemoteInterfaceLuidToIndex",
+		"ConvertStringToGuidA",
+		"ConvertStringToGuidW",
+		"ConvertStringToInterfacePhysicalAddress",
+		"CreateAnycastIpAddressEntry",
+		"CreateIpForwardEntry",
+		"CreateIpForwardEntry2",
+		"CreateIpNetEntry",
+		"CreateIpNetEntry2",
+		"CreatePersistentTcpPortReservation",
+		"CreatePersistentUdpPortReservation",
+		"CreateProxyArpEntry",
+		"CreateSortedAddressPairs",
+		"CreateUnicastIpAddressEntry",
+		"DeleteAnycastIpAddressEntry",
+		"DeleteIPAddress",
+		"DeleteIpForwardEntry",
+		"DeleteIpForwardEntry2",
+		"DeleteIpNetEntry",
+		"DeleteIpNetEntry2",
+		"DeletePersistentTcpPortReservation",
+		"DeletePersistentUdpPortReservation",
+		"DeleteProxyArpEntry",
+		"DeleteUnicastIpAddressEntry",
+		"DisableMediaSense",
+		"EnableRouter",
+		"FlushIpNetTable",
+		"FlushIpNetTable2",
+		"FlushIpPathTable",
+		"FreeMibTable",
+		"GetAdapterIndex",
+		"GetAdapterOrderMap",
+		"GetAdaptersAddresses",
+		"GetAdaptersInfo",
+		"GetAnycastIpAddressEntry",
+		"GetAnycastIpAddressTable",
+		"GetBestInterface",
+		"GetBestInterfaceEx",
+		"GetBestRoute",
+		"GetBestRoute2",
+		"GetCurrentThreadCompartmentId",
+		"GetExtendedTcpTable",
+		"GetExtendedUdpTable",
+		"GetFriendlyIfIndex",
+		"GetIcmpStatistics",
+		"GetIcmpStatisticsEx",
+		"GetIfEntry",
+		"GetIfEntry2",
+		"GetIfStackTable",
+		"GetIfTable",
+		"GetIfTable2",
+		"GetIfTable2Ex",
+		"GetInterfaceInfo",
+		"GetInvertedIfStackTable",
+		"GetIpAddrTable",
+		"GetIpErrorString",
+		"GetIpForwardEntry2",
+		"GetIpForwardTable",
+		"GetIpForwardTable2",
+		"GetIpInterfaceEntry",
+		"GetIpInterfaceTable",
+		"GetIpNetEntry2",
+		"GetIpNetTable",
+		"GetIpNetTable2",
+		"GetIpPathEntry",
+		"GetIpPathTable",
+		"GetIpStatistics",
+		"GetIpStatisticsEx",
+		"GetMulticastIpAddressEntry",
+		"GetMulticastIpAddressTable",
+		"GetNetworkInformation",
+		"GetNetworkParams",
+		"GetNumberOfInterfaces",
+		"GetOwnerModuleFromPidAndInfo",
+		"GetOwnerModuleFromTcp6Entry",
+		"GetOwnerModuleFromTcpEntry",
+		"GetOwnerModuleFromUdp6Entry",
+		"GetOwnerModuleFromUdpEntry",
+		"GetPerAdapterInfo",
+		"GetPerTcp6ConnectionEStats",
+		"GetPerTcp6ConnectionStats",
+		"GetPerTcpConnectionEStats",
+		"GetPerTcpConnectionStats",
+		"GetRTTAndHopCount",
+		"GetSessionCompartmentId",
+		"GetTcp6Table",
+		"GetTcp6Table2",
+		"GetTcpStatistics",
+		"GetTcpStatisticsEx",
+		"GetTcpTable",
+		"GetTcpTable2",
+		"GetTeredoPort",
+		"GetUdp6Table",
+		"GetUdpStatistics",
+		"GetUdpStatisticsEx",
+		"GetUdpTable",
+		"GetUniDirectionalAdapterInfo",
+		"GetUnicastIpAddressEntry",
+		"GetUnicastIpAddressTable",
+		"Icmp6CreateFile",
+		"Icmp6ParseReplies",
+		"Icmp6SendEcho2",
+		"IcmpCloseHandle",
+		"IcmpCreateFile",
+		"IcmpParseReplies",
+		"IcmpSendEcho",
+		"IcmpSendEcho2",
+		"IcmpSendEcho2Ex",
+		"InitializeIpForwardEntry",
+		"InitializeIpInterfaceEntry",
+		"InitializeUnicastIpAddressEntry",
+		"InternalCleanupPersistentStore",
+		"InternalCreateAnycastIpAddressEntry",
+		"InternalCreateIpForwardEntry",
+		"InternalCreateIpForwardEntry2",
+		"InternalCreateIpNetEntry",
+		"InternalCreateIpNetEntry2",
+		"InternalCreateUnicastIpAddressEntry",
+		"InternalDeleteAnycastIpAddressEntry",
+		"InternalDeleteIpForwardEntry",
+		"InternalDeleteIpForwardEntry2",
+		"InternalDeleteIpNetEntry",
+		"InternalDeleteIpNetEntry2",
+		"InternalDeleteUnicastIpAddressEntry",
+		"InternalFindInterfaceByAddress",
+		"InternalGetAnycastIpAddressEntry",
+		"InternalGetAnycastIpAddressTable",
+		"InternalGetForwardIpTable2",
+		"InternalGetIfEntry2",
+		"InternalGetIfTable",
+		"InternalGetIfTable2",
+		"InternalGetIpAddrTable",
+		"InternalGetIpForwardEntry2",
+		"InternalGetIpForwardTable",
+		"InternalGetIpInterfaceEntry",
+		"InternalGetIpInterfaceTable",
+		"InternalGetIpNetEntry2",
+		"InternalGetIpNetTable",
+		"InternalGetIpNetTable2",
+		"InternalGetMulticastIpAddressEntry",
+		"InternalGetMulticastIpAddressTable",
+		"InternalGetTcp6Table2",
+		"InternalGetTcp6TableWithOwnerModule",
+		"InternalGetTcp6TableWithOwnerPid",
+		"InternalGetTcpTable",
+		"InternalGetTcpTable2",
+		"InternalGetTcpTableEx",
+		"InternalGetTcpTableWithOwnerModule",
+		"InternalGetTcpTableWithOwnerPid",
+		"InternalGetTunnelPhysicalAdapter",
+		"InternalGetUdp6TableWithOwnerModule",
+		"InternalGetUdp6TableWithOwnerPid",
+		"InternalGetUdpTable",
+		"InternalGetUdpTableEx",
+		"InternalGetUdpTableWithOwnerModule",
+		"InternalGetUdpTableWithOwnerPid",
+		"InternalGetUnicastIpAddressEntry",
+		"InternalGetUnicastIpAddressTable",
+		"InternalSetIfEntry",
+		"InternalSetIpForwardEntry",
+		"InternalSetIpForwardEntry2",
+		"InternalSetIpInterfaceEntry",
+		"InternalSetIpNetEntry",
+		"InternalSetIpNetEntry2",
+		"InternalSetIpStats",
+		"InternalSetTcpEntry",
+		"InternalSetTeredoPort",
+		"InternalSetUnicastIpAddressEntry",
+		"IpReleaseAddress",
+		"IpRenewAddress",
+		"LookupPersistentTcpPortReservation",
+		"LookupPersistentUdpPortReservation",
+		"NTPTimeToNTFileTime",
+		"NTTimeToNTPTime",
+		"NhGetGuidFromInterfaceName",
+		"NhGetInterfaceDescriptionFromGuid",
+		"NhGetInterfaceNameFromDeviceGuid",
+		"NhGetInterfaceNameFromGuid",
+		"NhpAllocateAndGetInterfaceInfoFromStack",
+		"NotifyAddrChange",
+		"NotifyIpInterfaceChange",
+		"NotifyRouteChange",
+		"NotifyRouteChange2",
+		"NotifyStableUnicastIpAddressTable",
+		"NotifyTeredoPortChange",
+		"NotifyUnicastIpAddressChange",
+		"ParseNetworkString",
+		"PfAddFiltersToInterface",
+		"PfAddGlobalFilterToInterface",
+		"PfBindInterfaceToIPAddress",
+		"PfBindInterfaceToIndex",
+		"PfCreateInterface",
+		"PfDeleteInterface",
+		"PfDeleteLog",
+		"PfGetInterfaceStatistics",
+		"PfMakeLog",
+		"PfRebindFilters",
+		"PfRemoveFilterHandles",
+		"PfRemoveFiltersFromInterface",
+		"PfRemoveGlobalFilterFromInterface",
+		"PfSetLogBuffer",
+		"PfTestPacket",
+		"PfUnBindInterface",
+		"ResolveIpNetEntry2",
+		"ResolveNeighbor",
+		"RestoreMediaSense",
+		"SendARP",
+		"SetAdapterIpAddress",
+		"SetCurrentThreadCompartmentId",
+		"SetIfEntry",
+		"SetIpForwardEntry",
+		"SetIpForwardEntry2",
+		"SetIpInterfaceEntry",
+		"SetIpNetEntry",
+		"SetIpNetEntry2",
+		"SetIpStatistics",
+		"SetIpStatisticsEx",
+		"SetIpTTL",
+		"SetNetworkInformation",
+		"SetPerTcp6ConnectionEStats",
+		"SetPerTcp6ConnectionStats",
+		"SetPerTcpConnectionEStats",
+		"SetPerTcpConnectionStats",
+		"SetSessionCompartmentId",
+		"SetTcpEntry",
+		"SetUnicastIpAddressEntry",
+		"UnenableRouter",
+		"do_echo_rep",
+		"do_echo_req",
+		"if_indextoname",
+		"if_nametoindex",
+		"register_icmp"
+	};
 };
@@ -0,0 +1,49 @@
+// Generated by 'Tools/GenerateProxyFunctions.py', don't edit manually
+// Selects the proxied library with 'xSE_PROXY_LIBRARY_<Library>' define, see 'xSEProxyLibrary' property in the project file.
+#pragma once
+
+#if xSE_PROXY_LIBRARY_DInput8
+#include "DInput8.h"
+namespace xSE::PluginPreloader
+{
+	namespace ProxyLibrary = Library::DInput8;
+}
+
+#elif xSE_PROXY_LIBRARY_IpHlpAPI
+#include "IpHlpAPI.h"
+namespace xSE::PluginPreloader
+{
+	namespace ProxyLibrary = Library::IpHlpAPI;
+}
+
+#elif xSE_PROXY_LIBRARY_WinHTTP
+#include "WinHTTP.h"
+namespace xSE::PluginPreloader
+{
+	namespace ProxyLibrary = Library::WinHTTP;
+}
+
+#elif xSE_PROXY_LIBRARY_WinMM
+#include "WinMM.h"
+namespace xSE::PluginPreloader
+{
+	namespace ProxyLibrary = Library::WinMM;
+}
+
+#elif xSE_PROXY_LIBRARY_X3DAudio17
+#include "X3DAudio17.h"
+namespace xSE::PluginPreloader
+{
+	namespace ProxyLibrary = Library::X3DAudio17;
+}
+
+#elif xSE_PROXY_LIBRARY_bink2w64
+#include "bink2w64.h"
+namespace xSE::PluginPreloader
+{
+	namespace ProxyLibrary = Library::bink2w64;
+}
+
+#else
+#error "Proxy library is not selected"
+#endif
@@ -1,3 +1,6 @@
+// Generated by 'Tools/GenerateProxyFunctions.py' from 'WinHTTP.exports', don't edit manually
+#pragma once
+
 namespace xSE::PluginPreloader::Library::WinHTTP
 {
 	enum Enum
@@ -85,4 +88,92 @@ namespace xSE::PluginPreloader::Library::WinHTTP
 		WinHttpWriteData,
 		WinHttpWriteProxySettings
 	};
+
+	constexpr const char* FileName = "WinHTTP.dll";
+	constexpr size_t Count = 82;
+	constexpr const char* Names[Count] =
+	{
+		"WinHttpSetSecureLegacyServersAppCompat",
+		"DllCanUnloadNow",
+		"DllGetClassObject",
+		"Private1",
+		"SvchostPushServiceGlobals",
+		"WinHttpAddRequestHeaders",
+		"WinHttpAddRequestHeadersEx",
+		"WinHttpAutoProxySvcMain",
+		"WinHttpCheckPlatform",
+		"WinHttpCloseHandle",
+		"WinHttpConnect",
+		"WinHttpConnectionDeletePolicyEntries",
+		"WinHttpConnectionDeleteProxyInfo",
+		"WinHttpConnectionFreeNameList",
+		"WinHttpConnectionFreeProxyInfo",
+		"WinHttpConnectionFreeProxyList",
+		"WinHttpConnectionGetNameList",
+		"WinHttpConnectionGetProxyInfo",
+		"WinHttpConnectionGetProxyList",
+		"WinHttpConnectionOnlyConvert",
+		"WinHttpConnectionOnlyReceive",
+		"WinHttpConnectionOnlySend",
+		"WinHttpConnectionSetPolicyEntries",
+		"WinHttpConnectionSetProxyInfo",
+		"WinHttpConnectionUpdateIfIndexTable",
+		"WinHttpCrackUrl",
+		"WinHttpCreateProxyResolver",
+		"WinHttpCreateUrl",
+		"WinHttpDetectAutoProxyConfigUrl",
+		"WinHttpFreeProxyResult",
+		"WinHttpFreeProxyResultEx",
+		"WinHttpFreeProxySettings",
+		"WinHttpFreeProxySettingsEx",
+		"WinHttpFreeQueryConnectionGroupResult",
+		"WinHttpGetDefaultProxyConfiguration",
+		"WinHttpGetIEProxyConfigForCurrentUser",
+		"WinHttpGetProxyForUrl",
+		"WinHttpGetProxyForUrlEx",
+		"WinHttpGetProxyForUrlEx2",
+		"WinHttpGetProxyForUrlHvsi",
+		"WinHttpGetProxyResult",
+		"WinHttpGetProxyResultEx",
+		"WinHttpGetProxySettingsEx",
+		"WinHttpGetProxySettingsResultEx",
+		"WinHttpGetProxySettingsVersion",
+		"WinHttpGetTunnelSocket",
+		"WinHttpOpen",
+		"WinHttpOpenRequest",
+		"WinHttpPacJsWorkerMain",
+		"WinHttpProbeConnectivity",
+		"WinHttpQueryAuthSchemes",
+		"WinHttpQueryConnectionGroup",
+		"WinHttpQueryDataAvailable",
+		"WinHttpQueryHeaders",
+		"WinHttpQueryHeadersEx",
+		"WinHttpQueryOption",
+		"WinHttpReadData",
+		"WinHttpReadDataEx",
+		"WinHttpReadProxySettings",
+		"WinHttpReadProxySettingsHvsi",
+		"WinHttpReceiveResponse",
+		"WinHttpRegisterProxyChangeNotification",
+		"WinHttpResetAutoProxy",
+		"WinHttpSaveProxyCredentials",
+		"WinHttpSendRequest",
+		"WinHttpSetCredentials",
+		"WinHttpSetDefaultProxyConfiguration",
+		"WinHttpSetOption",
+		"WinHttpSetProxySettingsPerUser",
+		"WinHttpSetStatusCallback",
+		"WinHttpSetTimeouts",
+		"WinHttpTimeFromSystemTime",
+		"WinHttpTimeToSystemTime",
+		"WinHttpUnregisterProxyChangeNotification",
+		"WinHttpWebSocketClose",
+		"WinHttpWebSocketCompleteUpgrade",
+		"WinHttpWebSocketQueryCloseStatus",
+		"WinHttpWebSocketReceive",
+		"WinHttpWebSocketSend",
+		"WinHttpWebSocketShutdown",
+		"WinHttpWriteData",
+		"WinHttpWriteProxySettings"
+	};
 };
@@ -1,3 +1,6 @@
+// Generated by 'Tools/GenerateProxyFunctions.py' from 'WinMM.exports', don't edit manually
+#pragma once
+
 namespace xSE::PluginPreloader::Library::WinMM
 {
 	enum Enum
@@ -184,4 +187,191 @@ namespace xSE::PluginPreloader::Library::WinMM
 		waveOutUnprepareHeader,
 		waveOutWrite
 	};
+
+	constexpr const char* FileName = "WinMM.dll";
+	constexpr size_t Count = 181;
+	constexpr const char* Names[Count] =
+	{
+		"Ordinal2",
+		"CloseDriver",
+		"DefDriverProc",
+		"DriverCallback",
+		"DrvGetModuleHandle",
+		"GetDriverModuleHandle",
+		"OpenDriver",
+		"PlaySound",
+		"PlaySoundA",
+		"PlaySoundW",
+		"SendDriverMessage",
+		"WOWAppExit",
+		"auxGetDevCapsA",
+		"auxGetDevCapsW",
+		"auxGetNumDevs",
+		"auxGetVolume",
+		"auxOutMessage",
+		"auxSetVolume",
+		"joyConfigChanged",
+		"joyGetDevCapsA",
+		"joyGetDevCapsW",
+		"joyGetNumDevs",
+		"joyGetPos",
+		"joyGetPosEx",
+		"joyGetThreshold",
+		"joyReleaseCapture",
+		"joySetCapture",
+		"joySetThreshold",
+		"mciDriverNotify",
+		"mciDriverYield",
+		"mciExecute",
+		"mciFreeCommandResource",
+		"mciGetCreatorTask",
+		"mciGetDeviceIDA",
+		"mciGetDeviceIDFromElementIDA",
+		"mciGetDeviceIDFromElementIDW",
+		"mciGetDeviceIDW",
+		"mciGetDriverData",
+		"mciGetErrorStringA",
+		"mciGetErrorStringW",
+		"mciGetYieldProc",
+		"mciLoadCommandResource",
+		"mciSendCommandA",
+		"mciSendCommandW",
+		"mciSendStringA",
+		"mciSendStringW",
+		"mciSetDriverData",
+		"mciSetYieldProc",
+		"midiConnect",
+		"midiDisconnect",
+		"midiInAddBuffer",
+		"midiInClose",
+		"midiInGetDevCapsA",
+		"midiInGetDevCapsW",
+		"midiInGetErrorTextA",
+		"midiInGetErrorTextW",
+		"midiInGetID",
+		"midiInGetNumDevs",
+		"midiInMessage",
+		"midiInOpen",
+		"midiInPrepareHeader",
+		"midiInReset",
+		"midiInStart",
+		"midiInStop",
+		"midiInUnprepareHeader",
+		"midiOutCacheDrumPatches",
+		"midiOutCachePatches",
+		"midiOutClose",
+		"midiOutGetDevCapsA",
+		"midiOutGetDevCapsW",
+		"midiOutGetErrorTextA",
+		"midiOutGetErrorTextW",
+		"midiOutGetID",
+		"midiOutGetNumDevs",
+		"midiOutGetVolume",
+		"midiOutLongMsg",
+		"midiOutMessage",
+		"midiOutOpen",
+		"midiOutPrepareHeader",
+		"midiOutReset",
+		"midiOutSetVolume",
+		"midiOutShortMsg",
+		"midiOutUnprepareHeader",
+		"midiStreamClose",
+		"midiStreamOpen",
+		"midiStreamOut",
+		"midiStreamPause",
+		"midiStreamPosition",
+		"midiStreamProperty",
+		"midiStreamRestart",
+		"midiStreamStop",
+		"mixerClose",
+		"mixerGetControlDetailsA",
+		"mixerGetControlDetailsW",
+		"mixerGetDevCapsA",
+		"mixerGetDevCapsW",
+		"mixerGetID",
+		"mixerGetLineControlsA",
+		"mixerGetLineControlsW",
+		"mixerGetLineInfoA",
+		"mixerGetLineInfoW",
+		"mixerGetNumDevs",
+		"mixerMessage",
+		"mixerOpen",
+		"mixerSetControlDetails",
+		"mmDrvInstall",
+		"mmGetCurrentTask",
+		"mmTaskBlock",
+		"mmTaskCreate",
+		"mmTaskSignal",
+		"mmTaskYield",
+		"mmioAdvance",
+		"mmioAscend",
+		"mmioClose",
+		"mmioCreateChunk",
+		"mmioDescend",
+		"mmioFlush",
+		"mmioGetInfo",
+		"mmioInstallIOProcA",
+		"mmioInstallIOProcW",
+		"mmioOpenA",
+		"mmioOpenW",
+		"mmioRead",
+		"mmioRenameA",
+		"mmioRenameW",
+		"mmioSeek",
+		"mmioSendMessage",
+		"mmioSetBuffer",
+		"mmioSetInfo",
+		"mmioStringToFOURCCA",
+		"mmioStringToFOURCCW",
+		"mmioWrite",
+		"mmsystemGetVersion",
+		"sndPlaySoundA",
+		"sndPlaySoundW",
+		"timeBeginPeriod",
+		"timeEndPeriod",
+		"timeGetDevCaps",
+		"timeGetSystemTime",
+		"timeGetTime",
+		"timeKillEvent",
+		"timeSetEvent",
+		"waveInAddBuffer",
+		"waveInClose",
+		"waveInGetDevCapsA",
+		"waveInGetDevCapsW",
+		"waveInGetErrorTextA",
+		"waveInGetErrorTextW",
+		"waveInGetID",
+		"waveInGetNumDevs",
+		"waveInGetPosition",
+		"waveInMessage",
+		"waveInOpen",
+		"waveInPrepareHeader",
+		"waveInReset",
+		"waveInStart",
+		"waveInStop",
+		"waveInUnprepareHeader",
+		"waveOutBreakLoop",
+		"waveOutClose",
+		"waveOutGetDevCapsA",
+		"waveOutGetDevCapsW",
+		"waveOutGetErrorTextA",
+		"waveOutGetErrorTextW",
+		"waveOutGetID",
+		"waveOutGetNumDevs",
+		"waveOutGetPitch",
+		"waveOutGetPlaybackRate",
+		"waveOutGetPosition",
+		"waveOutGetVolume",
+		"waveOutMessage",
+		"waveOutOpen",
+		"waveOutPause",
+		"waveOutPrepareHeader",
+		"waveOutReset",
+		"waveOutRestart",
+		"waveOutSetPitch",
+		"waveOutSetPlaybackRate",
+		"waveOutSetVolume",
+		"waveOutUnprepareHeader",
+		"waveOutWrite"
+	};
 };
@@ -1,3 +1,6 @@
+// Generated by 'Tools/GenerateProxyFunctions.py' from 'X3DAudio17.exports', don't edit manually
+#pragma once
+
 namespace xSE::PluginPreloader::Library::X3DAudio17
 {
 	enum Enum
@@ -5,4 +8,12 @@ namespace xSE::PluginPreloader::Library::X3DAudio17
 		X3DAudioCalculate,
 		X3DAudioInitialize
 	};
+
+	constexpr const char* FileName = "X3DAudio17.dll";
+	constexpr size_t Count = 2;
+	constexpr const char* Names[Count] =
+	{
+		"X3DAudioCalculate",
+		"X3DAudioInitialize"
+	};
 };
@@ -1,6 +1,9 @@
+// Generated by 'Tools/GenerateProxyFunctions.py' from 'bink2w64.exports', don't edit manually
+#pragma once
+
 namespace xSE::PluginPreloader::Library::bink2w64
 {
-	enum
+	enum Enum
 	{
 		BinkBufferBlit,
 		BinkBufferCheckWinPos,
@@ -83,4 +86,90 @@ namespace xSE::PluginPreloader::Library::bink2w64
 		BinkWaitStopAsyncThread,
 		RADTimerRead
 	};
+
+	constexpr const char* FileName = "bink2w64.dll";
+	constexpr size_t Count = 80;
+	constexpr const char* Names[Count] =
+	{
+		"BinkBufferBlit",
+		"BinkBufferCheckWinPos",
+		"BinkBufferClear",
+		"BinkBufferClose",
+		"BinkBufferGetDescription",
+		"BinkBufferGetError",
+		"BinkBufferLock",
+		"BinkBufferOpen",
+		"BinkBufferSetDirectDraw",
+		"BinkBufferSetHWND",
+		"BinkBufferSetOffset",
+		"BinkBufferSetResolution",
+		"BinkBufferSetScale",
+		"BinkBufferUnlock",
+		"BinkCheckCursor",
+		"BinkClose",
+		"BinkCloseTrack",
+		"BinkControlBackgroundIO",
+		"BinkControlPlatformFeatures",
+		"BinkCopyToBuffer",
+		"BinkCopyToBufferRect",
+		"BinkDDSurfaceType",
+		"BinkDX8SurfaceType",
+		"BinkDX9SurfaceType",
+		"BinkDoFrame",
+		"BinkDoFrameAsync",
+		"BinkDoFrameAsyncWait",
+		"BinkDoFramePlane",
+		"BinkFreeGlobals",
+		"BinkGetError",
+		"BinkGetFrameBuffersInfo",
+		"BinkGetKeyFrame",
+		"BinkGetPalette",
+		"BinkGetPlatformInfo",
+		"BinkGetRealtime",
+		"BinkGetRects",
+		"BinkGetSummary",
+		"BinkGetTrackData",
+		"BinkGetTrackID",
+		"BinkGetTrackMaxSize",
+		"BinkGetTrackType",
+		"BinkGoto",
+		"BinkIsSoftwareCursor",
+		"BinkLogoAddress",
+		"BinkNextFrame",
+		"BinkOpen",
+		"BinkOpenDirectSound",
+		"BinkOpenMiles",
+		"BinkOpenTrack",
+		"BinkOpenWaveOut",
+		"BinkOpenWithOptions",
+		"BinkOpenXAudio2",
+		"BinkPause",
+		"BinkRegisterFrameBuffers",
+		"BinkRequestStopAsyncThread",
+		"BinkRestoreCursor",
+		"BinkService",
+		"BinkSetError",
+		"BinkSetFileOffset",
+		"BinkSetFrameRate",
+		"BinkSetIO",
+		"BinkSetIOSize",
+		"BinkSetMemory",
+		"BinkSetPan",
+		"BinkSetSimulate",
+		"BinkSetSoundOnOff",
+		"BinkSetSoundSystem",
+		"BinkSetSoundSystem2",
+		"BinkSetSoundTrack",
+		"BinkSetSpeakerVolumes",
+		"BinkSetVideoOnOff",
+		"BinkSetVolume",
+		"BinkSetWillLoop",
+		"BinkShouldSkip",
+		"BinkStartAsyncThread",
+		"BinkUseTelemetry",
+		"BinkUseTmLite",
+		"BinkWait",
+		"BinkWaitStopAsyncThread",
+		"RADTimerRead"
+	};
 };
@@ -0,0 +1,289 @@
+; One forwarding thunk per proxied export, each one jumps through its own slot of 'g_OriginalFunctions'.
+; The export list comes from 'ProxyFunctions\ProxyLibrary.inc' for the library selected by 'xSEProxyLibrary' project property.
+;
+; Every export also gets a resolver entry which passes the export index to 'ProxyResolve'. When lazy binding is enabled
+; the slots initially point to these entries (through 'g_OriginalFunctionResolvers' table), so the first call looks up
+; the actual function, stores it to the slot and jumps to it. The following calls go straight to the original library.
+;
+; Likewise, the instrumented entries (from 'g_OriginalFunctionInstrumenters' table) pass the index to 'ProxyInstrumented'
+; which counts the call and calls the function from 'g_InstrumentedFunctions' from its own stack frame, so the duration of
+; the sampled calls can be measured. The caller's return address is never touched, and on x64 the frame has unwind data
+; so exceptions and stack walks pass through it. The signatures aren't known, so a fixed number of stack arguments
+; ('InstrumentedStackArgs') is copied for the call, which covers every export of the proxied libraries.
+;
+; The export list is included three times: for the code, for the resolvers table and for the instrumenters table.
+
+IFDEF RAX
+	PtrSize equ 8
+	PtrData textequ <dq>
+ELSE
+	.686
+	.model flat, C
+	PtrSize equ 4
+	PtrData textequ <dd>
+ENDIF
+
+option casemap:none
+
+IFDEF RAX
+	extern g_OriginalFunctions: qword
+ELSE
+	extern g_OriginalFunctions: dword
+ENDIF
+extern ResolveOriginalFunction: proc
+extern BeginExportCall: proc
+extern EndExportCall: proc
+public g_OriginalFunctionResolvers
+public g_OriginalFunctionInstrumenters
+
+InstrumentedStackArgs equ 16
+
+; Passes the export index to the common handler: in 'eax' for x64 and on the stack (on top of the return address) for x86
+PassExportIndex macro index, handler
+	IFDEF RAX
+		mov eax, index
+	ELSE
+		push index
+	ENDIF
+	jmp handler
+endm
+
+ProxyThunk macro name, index
+	align 16
+	name proc
+		jmp [g_OriginalFunctions + (index * PtrSize)]
+	name endp
+
+	Resolve_&name proc private
+		PassExportIndex index, ProxyResolve
+	Resolve_&name endp
+
+	Instrument_&name proc private
+		PassExportIndex index, ProxyInstrumented
+	Instrument_&name endp
+endm
+
+.code
+
+IFDEF RAX
+
+; Saves the argument registers (including the floating point ones) around the call to 'handler', which gets the export index
+; in 'ecx' and the address of the return address slot in 'rdx'. Then jumps to whatever the handler returned with the original
+; arguments and return address.
+ForwardThroughHandler macro handler
+	push rcx
+	.pushreg rcx
+	push rdx
+	.pushreg rdx
+	push r8
+	.pushreg r8
+	push r9
+	.pushreg r9
+	sub rsp, 68h
+	.allocstack 68h
+	movdqa [rsp + 20h], xmm0
+	.savexmm128 xmm0, 20h
+	movdqa [rsp + 30h], xmm1
+	.savexmm128 xmm1, 30h
+	movdqa [rsp + 40h], xmm2
+	.savexmm128 xmm2, 40h
+	movdqa [rsp + 50h], xmm3
+	.savexmm128 xmm3, 50h
+	.endprolog
+
+	mov ecx, eax
+	lea rdx, [rsp + 88h]
+	call handler
+
+	movdqa xmm0, [rsp + 20h]
+	movdqa xmm1, [rsp + 30h]
+	movdqa xmm2, [rsp + 40h]
+	movdqa xmm3, [rsp + 50h]
+	add rsp, 68h
+	pop r9
+	pop r8
+	pop rdx
+	pop rcx
+	jmp rax
+endm
+
+ProxyResolve proc private frame
+	ForwardThroughHandler ResolveOriginalFunction
+ProxyResolve endp
+
+; Frame layout after the prologue:
+;   [rsp + 00h]   Home space for the calls made from here
+;   [rsp + 20h]   Stack arguments copied for the actual function
+;   [rsp + 0A0h]  'xmm0' - 'xmm3' arguments, then the 'xmm0' return value
+;   [rsp + 0E0h]  'rcx', 'rdx', 'r8', 'r9' arguments, then the 'rax' return value
+;   [rsp + 100h]  Function to call, from 'BeginExportCall'
+;   [rsp + 110h]  Saved 'rbx', holds the token of the timed call
+;   [rsp + 118h]  Return address, followed by the caller's home space and stack arguments at [rsp + 140h]
+; 'BeginExportCall' and 'EndExportCall' get the stack pointer of this frame as its address.
+ProxyInstrumented proc private frame
+	push rbx
+	.pushreg rbx
+	sub rsp, 110h
+	.allocstack 110h
+	.endprolog
+
+	mov [rsp + 0E0h], rcx
+	mov [rsp + 0E8h], rdx
+	mov [rsp + 0F0h], r8
+	mov [rsp + 0F8h], r9
+	movdqa [rsp + 0A0h], xmm0
+	movdqa [rsp + 0B0h], xmm1
+	movdqa [rsp + 0C0h], xmm2
+	movdqa [rsp + 0D0h], xmm3
+
+	mov ecx, eax
+	mov rdx, rsp
+	lea r8, [rsp + 100h]
+	call BeginExportCall
+	mov rbx, rax
+
+	argIndex = 0
+	REPT InstrumentedStackArgs
+		mov r10, [rsp + 140h + (argIndex * 8)]
+		mov [rsp + 20h + (argIndex * 8)], r10
+		argIndex = argIndex + 1
+	ENDM
+
+	mov rcx, [rsp + 0E0h]
+	mov rdx, [rsp + 0E8h]
+	mov r8, [rsp + 0F0h]
+	mov r9, [rsp + 0F8h]
+	movdqa xmm0, [rsp + 0A0h]
+	movdqa xmm1, [rsp + 0B0h]
+	movdqa xmm2, [rsp + 0C0h]
+	movdqa xmm3, [rsp + 0D0h]
+	call qword ptr [rsp + 100h]
+
+	; Only the timed calls need to be ended, the return value in 'rax' and 'xmm0' is preserved
+	test rbx, rbx
+	jz @F
+	mov [rsp + 0E0h], rax
+	movdqa [rsp + 0A0h], xmm0
+	mov rcx, rbx
+	mov rdx, rsp
+	call EndExportCall
+	mov rax, [rsp + 0E0h]
+	movdqa xmm0, [rsp + 0A0h]
+
+	@@:
+	add rsp, 110h
+	pop rbx
+	ret
+ProxyInstrumented endp
+
+ELSE
+
+; The export index is pushed on top of the return address. Calls 'handler' with the index and the address of the return address
+; slot and then jumps to whatever it returned. WinMM and the other proxied libraries take all their arguments on the stack,
+; but 'ecx' and 'edx' are preserved anyway in case some caller passes something in them.
+ForwardThroughHandler macro handler
+	push ecx
+	push edx
+	lea eax, [esp + 12]
+	push eax
+	push dword ptr [esp + 12]
+	call handler
+	add esp, 8
+	pop edx
+	pop ecx
+	add esp, 4
+	jmp eax
+endm
+
+ProxyResolve proc private
+	ForwardThroughHandler ResolveOriginalFunction
+ProxyResolve endp
+
+; Frame layout, 'ebp' is the frame address passed to 'BeginExportCall' and 'EndExportCall':
+;   [ebp + 0Ch]  The caller's stack arguments
+;   [ebp + 08h]  Return address
+;   [ebp + 04h]  Export index
+;   [ebp - 04h]  Saved 'ebx', holds the token of the timed call
+;   [ebp - 08h]  'ecx' and 'edx' arguments
+;   [ebp - 10h]  Function to call, from 'BeginExportCall'
+;   [ebp - 50h]  Stack arguments copied for the actual function
+; The function can be either 'cdecl' or 'stdcall', so how many bytes of arguments it has popped is measured on return
+; and the return address is moved up by as much before returning to the caller. The x87 stack isn't touched, so a
+; floating point return value in 'st(0)' is passed through as well.
+ProxyInstrumented proc private
+	push ebp
+	mov ebp, esp
+	push ebx
+	push ecx
+	push edx
+	sub esp, 4
+
+	push esp
+	push ebp
+	push dword ptr [ebp + 4]
+	call BeginExportCall
+	add esp, 12
+	mov ebx, eax
+
+	sub esp, InstrumentedStackArgs * 4
+	argIndex = 0
+	REPT InstrumentedStackArgs
+		mov eax, [ebp + 0Ch + (argIndex * 4)]
+		mov [esp + (argIndex * 4)], eax
+		argIndex = argIndex + 1
+	ENDM
+
+	mov ecx, [ebp - 8]
+	mov edx, [ebp - 0Ch]
+	call dword ptr [ebp - 10h]
+
+	; Bytes popped by the function, zero for 'cdecl'
+	mov ecx, esp
+	sub ecx, ebp
+	add ecx, 10h + (InstrumentedStackArgs * 4)
+
+	; Only the timed calls need to be ended, the return value in 'eax' and 'edx' is preserved
+	test ebx, ebx
+	jz @F
+	push eax
+	push edx
+	push ecx
+	push ebp
+	push ebx
+	call EndExportCall
+	add esp, 8
+	pop ecx
+	pop edx
+	pop eax
+
+	@@:
+	mov ebx, [ebp + 8]
+	mov [ebp + 8 + ecx], ebx
+	mov ebx, [ebp - 4]
+	lea ecx, [ebp + 8 + ecx]
+	mov ebp, [ebp]
+	mov esp, ecx
+	ret
+ProxyInstrumented endp
+
+ENDIF
+
+include ProxyFunctions\ProxyLibrary.inc
+
+; Tables of the resolver and instrumented entries, in the same order as 'g_OriginalFunctions' slots
+.const
+align PtrSize
+
+ProxyThunk macro name, index
+	PtrData Resolve_&name
+endm
+g_OriginalFunctionResolvers label byte
+include ProxyFunctions\ProxyLibrary.inc
+
+ProxyThunk macro name, index
+	PtrData Instrument_&name
+endm
+g_OriginalFunctionInstrumenters label byte
+include ProxyFunctions\ProxyLibrary.inc
+
+end
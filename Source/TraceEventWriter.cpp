@@ -0,0 +1,266 @@
+#include "pch.hpp"
+#include "TraceEventWriter.h"
+#include <charconv>
+
+namespace
+{
+	constexpr size_t g_AverageNameLength = 32;
+
+	void AppendNumber(std::string& buffer, uint64_t value)
+	{
+		char digits[32] = {};
+		auto result = std::to_chars(std::begin(digits), std::end(digits), value);
+		buffer.append(digits, result.ptr);
+	}
+	void AppendMicroseconds(std::string& buffer, std::chrono::steady_clock::duration duration)
+	{
+		// Trace timestamps are in microseconds, fractional part keeps the full clock resolution
+		const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+		const uint64_t value = nanoseconds > 0 ? static_cast<uint64_t>(nanoseconds) : 0;
+
+		AppendNumber(buffer, value / 1000);
+		buffer += '.';
+
+		const uint64_t fraction = value % 1000;
+		buffer += static_cast<char>('0' + fraction / 100);
+		buffer += static_cast<char>('0' + fraction / 10 % 10);
+		buffer += static_cast<char>('0' + fraction % 10);
+	}
+	void AppendString(std::string& buffer, std::string_view value)
+	{
+		constexpr char hexDigits[] = "0123456789abcdef";
+
+		buffer += '"';
+		for (char c: value)
+		{
+			switch (c)
+			{
+				case '"':
+				{
+					buffer += "\\\"";
+					break;
+				}
+				case '\\':
+				{
+					buffer += "\\\\";
+					break;
+				}
+				case '\n':
+				{
+					buffer += "\\n";
+					break;
+				}
+				case '\r':
+				{
+					buffer += "\\r";
+					break;
+				}
+				case '\t':
+				{
+					buffer += "\\t";
+					break;
+				}
+				default:
+				{
+					// Bytes above 0x7F are left alone, names are expected to be in UTF-8 already
+					const auto byte = static_cast<unsigned char>(c);
+					if (byte < 0x20)
+					{
+						buffer += "\\u00";
+						buffer += hexDigits[byte >> 4];
+						buffer += hexDigits[byte & 0xF];
+					}
+					else
+					{
+						buffer += c;
+					}
+					break;
+				}
+			};
+		}
+		buffer += '"';
+	}
+}
+
+namespace xSE
+{
+	TraceEventWriter::TraceEventWriter(uint32_t processID)
+		:m_StartTime(Clock::now()), m_ProcessID(processID)
+	{
+	}
+	void TraceEventWriter::Enable(size_t maxEventCount)
+	{
+		std::lock_guard lock(m_Lock);
+
+		m_MaxEventCount = maxEventCount;
+		m_Events.reserve(maxEventCount);
+		m_Strings.reserve(maxEventCount * g_AverageNameLength);
+		m_IsEnabled.store(true, std::memory_order_relaxed);
+	}
+
+	TraceEventWriter::StringRef TraceEventWriter::DoAddString(std::string_view value)
+	{
+		StringRef ref;
+		ref.Offset = static_cast<uint32_t>(m_Strings.size());
+		ref.Length = static_cast<uint32_t>(value.size());
+
+		m_Strings.append(value);
+		return ref;
+	}
+	void TraceEventWriter::DoAddEvent(const Event& event)
+	{
+		if (m_Events.size() < m_MaxEventCount)
+		{
+			m_Events.emplace_back(event);
+		}
+		else
+		{
+			m_DroppedCount++;
+		}
+	}
+
+	size_t TraceEventWriter::GetCount() const noexcept
+	{
+		std::lock_guard lock(m_Lock);
+		return m_Events.size();
+	}
+	size_t TraceEventWriter::GetDroppedCount() const noexcept
+	{
+		std::lock_guard lock(m_Lock);
+		return m_DroppedCount;
+	}
+
+	TraceEventWriter::StringRef TraceEventWriter::AddString(std::string_view value)
+	{
+		std::lock_guard lock(m_Lock);
+		return DoAddString(value);
+	}
+	void TraceEventWriter::AddComplete(StringRef name, std::string_view category, Clock::time_point startTime, Clock::time_point endTime, uint32_t threadID)
+	{
+		if (!IsEnabled())
+		{
+			return;
+		}
+
+		Event event;
+		event.Name = name;
+		event.Category = category;
+		event.StartTime = startTime;
+		event.Duration = endTime - startTime;
+		event.ThreadID = threadID;
+		event.Type = Phase::Complete;
+
+		std::lock_guard lock(m_Lock);
+		DoAddEvent(event);
+	}
+	void TraceEventWriter::AddComplete(std::string_view name, std::string_view category, Clock::time_point startTime, Clock::time_point endTime, uint32_t threadID)
+	{
+		if (!IsEnabled())
+		{
+			return;
+		}
+
+		Event event;
+		event.Category = category;
+		event.StartTime = startTime;
+		event.Duration = endTime - startTime;
+		event.ThreadID = threadID;
+		event.Type = Phase::Complete;
+
+		std::lock_guard lock(m_Lock);
+		event.Name = DoAddString(name);
+		DoAddEvent(event);
+	}
+	void TraceEventWriter::AddInstant(std::string_view name, std::string_view category, uint32_t threadID)
+	{
+		if (!IsEnabled())
+		{
+			return;
+		}
+
+		Event event;
+		event.Category = category;
+		event.StartTime = Clock::now();
+		event.ThreadID = threadID;
+		event.Type = Phase::Instant;
+
+		std::lock_guard lock(m_Lock);
+		event.Name = DoAddString(name);
+		DoAddEvent(event);
+	}
+	void TraceEventWriter::SetThreadName(uint32_t threadID, std::string_view name)
+	{
+		if (!IsEnabled())
+		{
+			return;
+		}
+
+		Event event;
+		event.StartTime = m_StartTime;
+		event.ThreadID = threadID;
+		event.Type = Phase::ThreadName;
+
+		std::lock_guard lock(m_Lock);
+		event.Name = DoAddString(name);
+		DoAddEvent(event);
+	}
+
+	std::string TraceEventWriter::Serialize() const
+	{
+		std::lock_guard lock(m_Lock);
+
+		std::string buffer;
+		buffer.reserve(64 + m_Events.size() * 128 + m_Strings.size());
+		buffer += "{\"traceEvents\":[";
+
+		bool isFirst = true;
+		for (const Event& event: m_Events)
+		{
+			if (!isFirst)
+			{
+				buffer += ',';
+			}
+			isFirst = false;
+
+			const std::string_view name(m_Strings.data() + event.Name.Offset, event.Name.Length);
+			buffer += "\n{\"ph\":\"";
+			buffer += static_cast<char>(event.Type);
+			buffer += "\",\"pid\":";
+			AppendNumber(buffer, m_ProcessID);
+			buffer += ",\"tid\":";
+			AppendNumber(buffer, event.ThreadID);
+			buffer += ",\"ts\":";
+			AppendMicroseconds(buffer, event.StartTime - m_StartTime);
+
+			if (event.Type == Phase::ThreadName)
+			{
+				buffer += ",\"name\":\"thread_name\",\"args\":{\"name\":";
+				AppendString(buffer, name);
+				buffer += "}}";
+				continue;
+			}
+
+			buffer += ",\"name\":";
+			AppendString(buffer, name);
+			buffer += ",\"cat\":";
+			AppendString(buffer, event.Category);
+
+			if (event.Type == Phase::Complete)
+			{
+				buffer += ",\"dur\":";
+				AppendMicroseconds(buffer, event.Duration);
+			}
+			else if (event.Type == Phase::Instant)
+			{
+				buffer += ",\"s\":\"t\"";
+			}
+			buffer += '}';
+		}
+
+		buffer += "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":";
+		AppendNumber(buffer, m_DroppedCount);
+		buffer += "}}\n";
+
+		return buffer;
+	}
+}
@@ -0,0 +1,150 @@
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Timeline in the Chrome trace-event format (loadable in 'chrome://tracing' and Perfetto), empty until 'Enable' is called.
+namespace xSE
+{
+	class TraceEventWriter final
+	{
+		public:
+			using Clock = std::chrono::steady_clock;
+
+			// Reference to a string stored in the writer's own buffer
+			struct StringRef final
+			{
+				uint32_t Offset = 0;
+				uint32_t Length = 0;
+			};
+
+			class Scope final
+			{
+				private:
+					TraceEventWriter* m_Writer = nullptr;
+					StringRef m_Name;
+					std::string_view m_Category;
+					Clock::time_point m_StartTime;
+					uint32_t m_ThreadID = 0;
+
+				public:
+					Scope() noexcept = default;
+					Scope(TraceEventWriter& writer, std::string_view name, std::string_view category, uint32_t threadID)
+						:m_Writer(&writer), m_Name(writer.AddString(name)), m_Category(category), m_StartTime(Clock::now()), m_ThreadID(threadID)
+					{
+					}
+					Scope(Scope&& other) noexcept
+					{
+						*this = std::move(other);
+					}
+					Scope(const Scope&) = delete;
+					~Scope()
+					{
+						End();
+					}
+
+				public:
+					void End()
+					{
+						if (m_Writer)
+						{
+							m_Writer->AddComplete(m_Name, m_Category, m_StartTime, Clock::now(), m_ThreadID);
+							m_Writer = nullptr;
+						}
+					}
+
+				public:
+					Scope& operator=(Scope&& other) noexcept
+					{
+						End();
+
+						m_Writer = std::exchange(other.m_Writer, nullptr);
+						m_Name = other.m_Name;
+						m_Category = other.m_Category;
+						m_StartTime = other.m_StartTime;
+						m_ThreadID = other.m_ThreadID;
+						return *this;
+					}
+					Scope& operator=(const Scope&) = delete;
+			};
+
+		private:
+			enum class Phase: char
+			{
+				Complete = 'X',
+				Instant = 'i',
+				ThreadName = 'M'
+			};
+			struct Event final
+			{
+				StringRef Name;
+				std::string_view Category;
+				Clock::time_point StartTime;
+				Clock::duration Duration = {};
+				uint32_t ThreadID = 0;
+				Phase Type = Phase::Complete;
+			};
+
+		public:
+			static constexpr size_t DefaultMaxEventCount = 4096;
+
+		private:
+			std::atomic<bool> m_IsEnabled = false;
+			mutable std::mutex m_Lock;
+			std::vector<Event> m_Events;
+			std::string m_Strings;
+			size_t m_MaxEventCount = 0;
+			size_t m_DroppedCount = 0;
+
+			Clock::time_point m_StartTime;
+			uint32_t m_ProcessID = 0;
+
+		private:
+			StringRef DoAddString(std::string_view value);
+			void DoAddEvent(const Event& event);
+
+		public:
+			TraceEventWriter(uint32_t processID = 0);
+
+		public:
+			bool IsEnabled() const noexcept
+			{
+				return m_IsEnabled.load(std::memory_order_relaxed);
+			}
+
+			// Storage for the expected number of events is reserved up front, events above the limit are dropped
+			void Enable(size_t maxEventCount = DefaultMaxEventCount);
+
+			Clock::time_point GetStartTime() const noexcept
+			{
+				return m_StartTime;
+			}
+			size_t GetCount() const noexcept;
+			size_t GetDroppedCount() const noexcept;
+
+			// Categories aren't copied, they must be string literals or otherwise outlive the writer
+			StringRef AddString(std::string_view value);
+			void AddComplete(StringRef name, std::string_view category, Clock::time_point startTime, Clock::time_point endTime, uint32_t threadID);
+			void AddComplete(std::string_view name, std::string_view category, Clock::time_point startTime, Clock::time_point endTime, uint32_t threadID);
+			void AddInstant(std::string_view name, std::string_view category, uint32_t threadID);
+			void SetThreadName(uint32_t threadID, std::string_view name);
+
+			// Returns an empty scope if the writer isn't enabled
+			Scope BeginScope(std::string_view name, std::string_view category, uint32_t threadID)
+			{
+				if (IsEnabled())
+				{
+					return Scope(*this, name, category, threadID);
+				}
+				return {};
+			}
+
+			// JSON object format: '{"traceEvents": [...], "displayTimeUnit": "ms"}'
+			std::string Serialize() const;
+	};
+}
@@ -1,10 +0,0 @@
-.data
-extern UnconditionalJumpAddress: qword
-
-.code
-
-UnconditionalJump proc
-jmp qword ptr [UnconditionalJumpAddress]
-UnconditionalJump endp
-
-end
@@ -0,0 +1,93 @@
+#include "pch.hpp"
+#include "WatchdogThread.h"
+
+namespace xSE
+{
+	DWORD WINAPI WatchdogThread::ThreadProc(void* context)
+	{
+		auto& watchdog = *static_cast<WatchdogThread*>(context);
+		while (::WaitForSingleObject(watchdog.m_RequestEvent, INFINITE) == WAIT_OBJECT_0 && !watchdog.m_IsStopping)
+		{
+			try
+			{
+				std::invoke(watchdog.m_Function);
+			}
+			catch (...)
+			{
+			}
+
+			// Cleared only after the completion is signalled, so the next request can't mistake it for its own
+			::SetEvent(watchdog.m_CompleteEvent);
+			watchdog.m_IsBusy.store(false, std::memory_order_release);
+		}
+		return 0;
+	}
+
+	bool WatchdogThread::Start(std::function<void()> func)
+	{
+		if (m_Thread)
+		{
+			return true;
+		}
+
+		m_Function = std::move(func);
+		m_RequestEvent = ::CreateEventW(nullptr, FALSE, FALSE, nullptr);
+		m_CompleteEvent = ::CreateEventW(nullptr, FALSE, FALSE, nullptr);
+		if (m_Function && m_RequestEvent && m_CompleteEvent)
+		{
+			// Threads don't start running until the loader lock is released, but it can be created from 'DllMain'
+			m_Thread = ::CreateThread(nullptr, 0, ThreadProc, this, 0, nullptr);
+		}
+
+		if (!m_Thread)
+		{
+			Stop();
+			return false;
+		}
+		return true;
+	}
+	void WatchdogThread::Stop() noexcept
+	{
+		if (m_Thread)
+		{
+			// Same as for the minidump writer, the thread is already gone if the process is exiting
+			m_IsStopping = true;
+			::SetEvent(m_RequestEvent);
+			::WaitForSingleObject(m_Thread, 1000);
+
+			::CloseHandle(m_Thread);
+			m_Thread = nullptr;
+		}
+		if (m_RequestEvent)
+		{
+			::CloseHandle(m_RequestEvent);
+			m_RequestEvent = nullptr;
+		}
+		if (m_CompleteEvent)
+		{
+			::CloseHandle(m_CompleteEvent);
+			m_CompleteEvent = nullptr;
+		}
+	}
+
+	bool WatchdogThread::Run(std::chrono::milliseconds timeout) noexcept
+	{
+		if (!m_Thread)
+		{
+			return false;
+		}
+
+		bool expected = false;
+		if (!m_IsBusy.compare_exchange_strong(expected, true, std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		// The completion of a request which has timed out is signalled whenever it finishes, it's not ours
+		::ResetEvent(m_CompleteEvent);
+		::SetEvent(m_RequestEvent);
+
+		// The watchdog thread clears the busy flag itself once the function returns, including after a timeout
+		return ::WaitForSingleObject(m_CompleteEvent, static_cast<DWORD>(timeout.count())) == WAIT_OBJECT_0;
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include "Framework.hpp"
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+namespace xSE
+{
+	// Runs a function on a thread started in advance, on request of a thread which can't safely run it itself, such as
+	// one inside an exception handler which may be holding the heap or the logger lock. The requesting thread only
+	// signals the watchdog and waits for it with a timeout, so it can't deadlock on whatever it's holding.
+	class WatchdogThread final
+	{
+		private:
+			std::function<void()> m_Function;
+
+			HANDLE m_Thread = nullptr;
+			HANDLE m_RequestEvent = nullptr;
+			HANDLE m_CompleteEvent = nullptr;
+			std::atomic<bool> m_IsBusy = false;
+			std::atomic<bool> m_IsStopping = false;
+
+		private:
+			static DWORD WINAPI ThreadProc(void* context);
+
+		public:
+			WatchdogThread() noexcept = default;
+			WatchdogThread(const WatchdogThread&) = delete;
+			~WatchdogThread()
+			{
+				Stop();
+			}
+
+		public:
+			bool IsRunning() const noexcept
+			{
+				return m_Thread != nullptr;
+			}
+
+			bool Start(std::function<void()> func);
+			void Stop() noexcept;
+
+			// Blocks until the function has run or the timeout expires. Requests made while the function is running are skipped,
+			// this includes the time after a timeout until it actually finishes.
+			bool Run(std::chrono::milliseconds timeout) noexcept;
+
+		public:
+			WatchdogThread& operator=(const WatchdogThread&) = delete;
+	};
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <system_error>
+
+namespace xSE
+{
+	// Runs a batch of independent jobs on a bounded number of short-lived threads. Jobs are picked dynamically,
+	// so callers that store results by index get the same ordering regardless of how the work was distributed.
+	// Must not be used while holding the loader lock: new threads can't start until it's released.
+	class WorkerPool final
+	{
+		public:
+			using Clock = std::chrono::steady_clock;
+
+			struct WorkerStatistics final
+			{
+				Clock::duration BusyTime = {};
+				size_t ItemCount = 0;
+			};
+
+		public:
+			static size_t GetDefaultThreadCount() noexcept
+			{
+				return std::clamp<size_t>(std::thread::hardware_concurrency(), 1, 8);
+			}
+
+		private:
+			size_t m_ThreadCount = 1;
+			std::vector<WorkerStatistics> m_Statistics;
+			Clock::duration m_WallTime = {};
+
+		public:
+			WorkerPool(size_t threadCount = 0) noexcept
+				:m_ThreadCount(threadCount != 0 ? threadCount : GetDefaultThreadCount())
+			{
+			}
+
+		public:
+			size_t GetThreadCount() const noexcept
+			{
+				return m_ThreadCount;
+			}
+			Clock::duration GetWallTime() const noexcept
+			{
+				return m_WallTime;
+			}
+			const std::vector<WorkerStatistics>& GetStatistics() const noexcept
+			{
+				return m_Statistics;
+			}
+
+			// Calls 'func(index)' once for every index in [0, count). The calling thread takes part in the work.
+			template<class TFunc>
+			void ForEach(size_t count, TFunc&& func)
+			{
+				const auto startTime = Clock::now();
+
+				const size_t threadCount = std::clamp<size_t>(m_ThreadCount, 1, std::max<size_t>(count, 1));
+				m_Statistics.assign(threadCount, {});
+
+				std::atomic<size_t> nextIndex = 0;
+				auto Worker = [&](WorkerStatistics& statistics)
+				{
+					for (size_t index = nextIndex++; index < count; index = nextIndex++)
+					{
+						const auto itemStartTime = Clock::now();
+						std::invoke(func, index);
+
+						statistics.BusyTime += Clock::now() - itemStartTime;
+						statistics.ItemCount++;
+					}
+				};
+
+				std::vector<std::thread> threads;
+				threads.reserve(threadCount - 1);
+				for (size_t i = 1; i < threadCount; i++)
+				{
+					try
+					{
+						threads.emplace_back(Worker, std::ref(m_Statistics[i]));
+					}
+					catch (const std::system_error&)
+					{
+						// Whatever threads we've managed to start (including this one) will do all the work
+						m_Statistics.resize(threads.size() + 1);
+						break;
+					}
+				}
+				Worker(m_Statistics[0]);
+
+				for (std::thread& thread: threads)
+				{
+					thread.join();
+				}
+				m_WallTime = Clock::now() - startTime;
+			}
+	};
+}
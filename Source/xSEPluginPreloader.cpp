@@ -2,7 +2,14 @@
 #include "xSEPluginPreloader.h"
 #include "ScriptExtenderDefinesBase.h"
 #include "Application.h"
+#include "AsyncOutputStream.h"
 #include "Detour.h"
+#include "MappedFile.h"
+#include "PluginDependencyGraph.h"
+#include "PortableExecutable.h"
+#include "PluginListStream.h"
+#include "ProxyFunctions/ProxyLibrary.h"
+#include "WorkerPool.h"
 
 #include <kxf/Application/GUIApplication.h>
 #include <kxf/IO/StreamReaderWriter.h>
@@ -21,6 +28,9 @@
 #include <kxf/Utility/Container.h>
 #include <kxf/Utility/ScopeGuard.h>
 #include <wx/module.h>
+#include <Psapi.h>
+#include <Shlwapi.h>
+#pragma comment(lib, "Shlwapi.lib")
 
 namespace
 {
@@ -28,6 +38,71 @@ namespace
 
 	constexpr auto g_ConfigFileName = "xSE PluginPreloader.xml";
 	constexpr auto g_LogFileName = "xSE PluginPreloader.log";
+	constexpr auto g_ScanIndexFileName = "xSE PluginPreloader.index";
+	constexpr auto g_TraceFileName = "xSE PluginPreloader.trace.json";
+	constexpr size_t g_SlowestPluginsCount = 10;
+
+	// How long the thread which has raised a fatal exception waits for the captures and the log to be written out
+	constexpr std::chrono::milliseconds g_FatalFlushTimeout = std::chrono::seconds(5);
+
+	double ToMilliseconds(std::chrono::steady_clock::duration duration) noexcept
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+	std::optional<xSE::FileStamp> GetFileStamp(const kxf::FSPath& path)
+	{
+		WIN32_FILE_ATTRIBUTE_DATA attributes = {};
+		if (::GetFileAttributesExW(path.GetFullPath().wc_str(), GetFileExInfoStandard, &attributes))
+		{
+			xSE::FileStamp stamp;
+			stamp.Size = (static_cast<uint64_t>(attributes.nFileSizeHigh) << 32)|attributes.nFileSizeLow;
+			stamp.LastWriteTime = (static_cast<uint64_t>(attributes.ftLastWriteTime.dwHighDateTime) << 32)|attributes.ftLastWriteTime.dwLowDateTime;
+
+			return stamp;
+		}
+		return {};
+	}
+
+	// Deeper chains of broken libraries aren't useful for diagnostics and only bloat the log
+	constexpr size_t g_MaxDependencyDepth = 16;
+
+	kxf::FSPath SearchModulePath(const kxf::String& moduleName)
+	{
+		// Same search order the loader uses for modules loaded by name without any additional flags
+		std::wstring buffer(MAX_PATH, L'\0');
+		DWORD length = ::SearchPathW(nullptr, moduleName.wc_str(), nullptr, static_cast<DWORD>(buffer.size()), buffer.data(), nullptr);
+		if (length >= buffer.size())
+		{
+			buffer.resize(length);
+			length = ::SearchPathW(nullptr, moduleName.wc_str(), nullptr, static_cast<DWORD>(buffer.size()), buffer.data(), nullptr);
+		}
+
+		if (length != 0 && length < buffer.size())
+		{
+			buffer.resize(length);
+			return kxf::String(buffer.c_str());
+		}
+		return {};
+	}
+	std::optional<std::vector<kxf::String>> ReadImportedModules(const kxf::FSPath& path)
+	{
+		if (MappedFile file(path); file)
+		{
+			xSE::PE::ImageReader reader(file.GetView(), xSE::PE::Layout::File);
+			if (!reader.IsNull())
+			{
+				std::vector<kxf::String> moduleNames;
+				reader.EnumImportedModules([&](std::string_view moduleName)
+				{
+					moduleNames.emplace_back(kxf::String::FromUTF8(moduleName));
+					return true;
+				});
+				return moduleNames;
+			}
+		}
+		return {};
+	}
 
 	void LogLoadStatus(const kxf::FSPath& path, xSE::PluginStatus status)
 	{
@@ -79,6 +154,10 @@ namespace
 		{
 			return LoadMethod::ImportAddressHook;
 		}
+		else if (name == "OnModuleLoad")
+		{
+			return LoadMethod::OnModuleLoad;
+		}
 		return {};
 	}
 	std::optional<xSE::InitializationMethod> InitializationMethodFromString(const kxf::String& name)
@@ -97,6 +176,10 @@ namespace
 		{
 			return InitializationMethod::xSEPluginPreload;
 		}
+		else if (name == "Combined")
+		{
+			return InitializationMethod::Combined;
+		}
 		return {};
 	}
 	kxf::String LoadMethodToName(xSE::LoadMethod method)
@@ -117,9 +200,170 @@ namespace
 			{
 				return "ImportAddressHook";
 			}
+			case LoadMethod::OnModuleLoad:
+			{
+				return "OnModuleLoad";
+			}
 		};
 		return "Unknown";
 	}
+
+	std::optional<uint32_t> ParseExceptionCode(const kxf::String& value)
+	{
+		const std::string text = value.ToUTF8();
+		if (!text.empty())
+		{
+			char* end = nullptr;
+			const unsigned long code = std::strtoul(text.c_str(), &end, 0);
+			if (end && *end == '\0' && code <= std::numeric_limits<uint32_t>::max())
+			{
+				return static_cast<uint32_t>(code);
+			}
+		}
+		return {};
+	}
+	std::optional<MINIDUMP_TYPE> ParseMinidumpType(const kxf::String& value)
+	{
+		static constexpr std::pair<std::string_view, MINIDUMP_TYPE> types[] =
+		{
+			{"Normal", MiniDumpNormal},
+			{"WithDataSegs", MiniDumpWithDataSegs},
+			{"WithFullMemory", MiniDumpWithFullMemory},
+			{"WithHandleData", MiniDumpWithHandleData},
+			{"FilterMemory", MiniDumpFilterMemory},
+			{"ScanMemory", MiniDumpScanMemory},
+			{"WithUnloadedModules", MiniDumpWithUnloadedModules},
+			{"WithIndirectlyReferencedMemory", MiniDumpWithIndirectlyReferencedMemory},
+			{"FilterModulePaths", MiniDumpFilterModulePaths},
+			{"WithProcessThreadData", MiniDumpWithProcessThreadData},
+			{"WithPrivateReadWriteMemory", MiniDumpWithPrivateReadWriteMemory},
+			{"WithoutOptionalData", MiniDumpWithoutOptionalData},
+			{"WithFullMemoryInfo", MiniDumpWithFullMemoryInfo},
+			{"WithThreadInfo", MiniDumpWithThreadInfo},
+			{"WithCodeSegs", MiniDumpWithCodeSegs},
+			{"WithPrivateWriteCopyMemory", MiniDumpWithPrivateWriteCopyMemory},
+			{"WithTokenInformation", MiniDumpWithTokenInformation}
+		};
+
+		// Flag names without the 'MiniDump' prefix separated by '|'
+		const std::string text = value.ToUTF8();
+		uint32_t result = MiniDumpNormal;
+		for (size_t start = 0; start <= text.size();)
+		{
+			size_t end = std::min(text.find('|', start), text.size());
+
+			std::string_view name = std::string_view(text).substr(start, end - start);
+			name.remove_prefix(std::min(name.find_first_not_of(" \t"), name.size()));
+			name.remove_suffix(name.size() - std::min(name.find_last_not_of(" \t") + 1, name.size()));
+
+			auto it = std::ranges::find(types, name, &std::pair<std::string_view, MINIDUMP_TYPE>::first);
+			if (it == std::end(types))
+			{
+				return {};
+			}
+			result |= it->second;
+			start = end + 1;
+		}
+		return static_cast<MINIDUMP_TYPE>(result);
+	}
+	xSE::PluginListStream::LoadState ToLoadState(std::optional<xSE::PluginStatus> status) noexcept
+	{
+		using namespace xSE;
+
+		switch (status.value_or(static_cast<PluginStatus>(-1)))
+		{
+			case PluginStatus::Loaded:
+			{
+				return PluginListStream::LoadState::Loaded;
+			}
+			case PluginStatus::Initialized:
+			{
+				return PluginListStream::LoadState::Initialized;
+			}
+			case PluginStatus::FailedLoad:
+			{
+				return PluginListStream::LoadState::FailedLoad;
+			}
+			case PluginStatus::FailedInitialize:
+			{
+				return PluginListStream::LoadState::FailedInitialize;
+			}
+		};
+		return PluginListStream::LoadState::Loading;
+	}
+	std::vector<xSE::ExceptionFilter::Rule> GetDefaultExceptionFilterRules()
+	{
+		using xSE::ExceptionFilter;
+
+		// C++ exceptions, 'OutputDebugString' (narrow and wide) and 'SetThreadName'
+		std::vector<ExceptionFilter::Rule> rules;
+		for (uint32_t code: {0xE06D7363u, 0x40010006u, 0x4001000Au, 0x406D1388u})
+		{
+			auto& rule = rules.emplace_back();
+			rule.FirstCode = code;
+			rule.LastCode = code;
+			rule.Action = ExceptionFilter::FilterAction::Ignore;
+			rule.Description = kxf::Format("{:#010x}", code).ToUTF8();
+		}
+		return rules;
+	}
+
+	bool MatchesModuleName(const std::vector<kxf::String>& patterns, const kxf::String& name)
+	{
+		return std::ranges::any_of(patterns, [&](const kxf::String& pattern)
+		{
+			return ::PathMatchSpecW(name.wc_str(), pattern.wc_str());
+		});
+	}
+	std::vector<HMODULE> EnumLoadedModules()
+	{
+		std::vector<HMODULE> modules(256);
+		DWORD requiredSize = 0;
+		while (true)
+		{
+			const DWORD size = static_cast<DWORD>(modules.size() * sizeof(HMODULE));
+			if (!::EnumProcessModules(::GetCurrentProcess(), modules.data(), size, &requiredSize))
+			{
+				return {};
+			}
+			if (requiredSize <= size)
+			{
+				modules.resize(requiredSize / sizeof(HMODULE));
+				return modules;
+			}
+			modules.resize(requiredSize / sizeof(HMODULE));
+		}
+	}
+	std::optional<kxf::String> FindLoadedModule(const std::vector<kxf::String>& patterns)
+	{
+		HANDLE process = ::GetCurrentProcess();
+
+		for (HMODULE module: EnumLoadedModules())
+		{
+			wchar_t name[MAX_PATH] = {};
+			if (::GetModuleBaseNameW(process, module, name, static_cast<DWORD>(std::size(name))) != 0 && MatchesModuleName(patterns, name))
+			{
+				return name;
+			}
+		}
+		return {};
+	}
+	std::optional<xSE::ModuleRange> GetModuleRange(HMODULE module)
+	{
+		HANDLE process = ::GetCurrentProcess();
+
+		MODULEINFO info = {};
+		wchar_t name[MAX_PATH] = {};
+		if (::GetModuleInformation(process, module, &info, sizeof(info)) && ::GetModuleBaseNameW(process, module, name, static_cast<DWORD>(std::size(name))) != 0)
+		{
+			xSE::ModuleRange range;
+			range.Begin = reinterpret_cast<uintptr_t>(info.lpBaseOfDll);
+			range.End = range.Begin + info.SizeOfImage;
+			range.Name = kxf::String(name).ToUTF8();
+			return range;
+		}
+		return {};
+	}
 }
 
 namespace xSE::PluginPreloader
@@ -131,7 +375,13 @@ namespace xSE::PluginPreloader
 			{
 				KX_SCOPEDLOG_FUNC;
 
-				g_Instance->LoadPlugins();
+				// Only the thread which has actually loaded the plugins restores the entry. Calls arriving from now on
+				// take the passthrough path, including the ones which are already inside the hook function.
+				if (g_Instance->LoadPlugins())
+				{
+					g_Instance->m_ImportAddressHook.SetTriggered();
+					g_Instance->UnhookImportTable();
+				}
 
 				KX_SCOPEDLOG.SetSuccess();
 			}
@@ -156,8 +406,21 @@ namespace xSE::PluginPreloader
 				KX_SCOPEDLOG.SetSuccess();
 			}
 
-			template<class TRet, class... Args>
-			static TRet InvokeHook(Args&&... args)
+			template<class TSignature, class... Args>
+			static decltype(auto) InvokeHook(Args&&... args)
+			{
+				// Calls which were already on their way through the hooked entry when it was restored,
+				// or all calls after the preload if the entry couldn't be restored.
+				auto& hook = g_Instance->m_ImportAddressHook;
+				if (hook.IsTriggered())
+				{
+					return hook.CallPassthrough<TSignature>(std::forward<Args>(args)...);
+				}
+				return InvokeHookOnce<TSignature>(std::forward<Args>(args)...);
+			}
+
+			template<class TSignature, class... Args>
+			static decltype(auto) InvokeHookOnce(Args&&... args)
 			{
 				KX_SCOPEDLOG_ARGS(std::forward<Args>(args)...);
 
@@ -169,23 +432,102 @@ namespace xSE::PluginPreloader
 					HookCommonAfter(status);
 					KX_SCOPEDLOG.SetSuccess(status.IsSuccess());
 				};
-				return g_Instance->m_ImportAddressHook.CallOriginal(status, std::forward<Args>(args)...);
+				return g_Instance->m_ImportAddressHook.CallOriginal<TSignature>(status, std::forward<Args>(args)...);
 			}
 
+			// The calling convention is a part of the function type only on x86, so separate templates
+			// are needed to instantiate both of them there without clashing on x64.
+			template<class TRet, class... TArgs>
+			struct CdeclHook final
+			{
+				static TRet __cdecl HookFunc(TArgs... args)
+				{
+					return InvokeHook<TRet(__cdecl)(TArgs...)>(args...);
+				}
+			};
+
+			template<class TRet, class... TArgs>
+			struct StdcallHook final
+			{
+				static TRet __stdcall HookFunc(TArgs... args)
+				{
+					return InvokeHook<TRet(__stdcall)(TArgs...)>(args...);
+				}
+			};
+
 		public:
-			#if xSE_PLATFORM_SKSE64 || xSE_PLATFORM_F4SE
-			static void* __cdecl HookFunc(void* a1, void* a2)
+			static kxf::String GetDefaultSignature()
 			{
-				return InvokeHook<void*>(a1, a2);
+				#if xSE_PLATFORM_SKSE64 || xSE_PLATFORM_F4SE
+				return "void*(__cdecl*)(void*, void*)";
+				#elif xSE_PLATFORM_SKSE || xSE_PLATFORM_NVSE
+				return "void*(__stdcall*)()";
+				#else
+					#error "Unsupported configuration"
+				#endif
 			}
-			#elif xSE_PLATFORM_SKSE || xSE_PLATFORM_NVSE
-			static char* __stdcall HookFunc()
+
+			// Signatures of the functions which are commonly imported and called early by the host processes,
+			// spaces are ignored when comparing names. Pointer return values use 'void*' regardless of the actual type.
+			static void* GetHookFunction(const kxf::String& signature)
 			{
-				return InvokeHook<char*>();
+				std::string name = signature.ToUTF8();
+				std::erase_if(name, [](char c)
+				{
+					return c == ' ' || c == '\t';
+				});
+
+				// _initterm_e, _initterm
+				if (name == "void*(__cdecl*)(void*,void*)")
+				{
+					return reinterpret_cast<void*>(&CdeclHook<void*, void*, void*>::HookFunc);
+				}
+				else if (name == "int(__cdecl*)(void*,void*)")
+				{
+					return reinterpret_cast<void*>(&CdeclHook<int, void*, void*>::HookFunc);
+				}
+				else if (name == "void(__cdecl*)(void*,void*)")
+				{
+					return reinterpret_cast<void*>(&CdeclHook<void, void*, void*>::HookFunc);
+				}
+
+				// GetCommandLineA/W, GetProcessHeap
+				else if (name == "void*(__stdcall*)()")
+				{
+					return reinterpret_cast<void*>(&StdcallHook<void*>::HookFunc);
+				}
+
+				// GetCurrentProcessId, GetCurrentThreadId, GetTickCount
+				else if (name == "uint32_t(__stdcall*)()")
+				{
+					return reinterpret_cast<void*>(&StdcallHook<uint32_t>::HookFunc);
+				}
+
+				// GetSystemTimeAsFileTime, GetStartupInfoW, InitializeSListHead
+				else if (name == "void(__stdcall*)(void*)")
+				{
+					return reinterpret_cast<void*>(&StdcallHook<void, void*>::HookFunc);
+				}
+
+				// QueryPerformanceCounter
+				else if (name == "int(__stdcall*)(void*)")
+				{
+					return reinterpret_cast<void*>(&StdcallHook<int, void*>::HookFunc);
+				}
+
+				// GetModuleHandleA/W, EncodePointer, DecodePointer
+				else if (name == "void*(__stdcall*)(void*)")
+				{
+					return reinterpret_cast<void*>(&StdcallHook<void*, void*>::HookFunc);
+				}
+
+				// IsProcessorFeaturePresent
+				else if (name == "int(__stdcall*)(uint32_t)")
+				{
+					return reinterpret_cast<void*>(&StdcallHook<int, uint32_t>::HookFunc);
+				}
+				return nullptr;
 			}
-			#else
-				#error "Unsupported configuration"
-			#endif
 	};
 }
 
@@ -203,6 +545,14 @@ namespace xSE
 	{
 		g_Instance = nullptr;
 	}
+	LONG WINAPI PreloadHandler::UnhandledExceptionFilterProc(_EXCEPTION_POINTERS* exceptionInfo)
+	{
+		if (g_Instance && exceptionInfo)
+		{
+			return g_Instance->OnUnhandledException(*exceptionInfo);
+		}
+		return EXCEPTION_CONTINUE_SEARCH;
+	}
 	
 	kxf::String PreloadHandler::GetLibraryName()
 	{
@@ -227,19 +577,16 @@ namespace xSE
 	}
 	kxf::FSPath PreloadHandler::GetOriginalLibraryDefaultPath() const
 	{
-		#if xSE_PLATFORM_SKSE64 || xSE_PLATFORM_F4SE
-		return kxf::Shell::GetKnownDirectory(kxf::KnownDirectoryID::System) / "WinHTTP.dll";
-		#elif xSE_PLATFORM_SKSE || xSE_PLATFORM_NVSE
-		return kxf::Shell::GetKnownDirectory(kxf::KnownDirectoryID::System) / "WinMM.dll";
-		#else
-		#error "Unsupported configuration"
-		#endif
+		return kxf::Shell::GetKnownDirectory(kxf::KnownDirectoryID::System) / PluginPreloader::ProxyLibrary::FileName;
 	}
 
 	void PreloadHandler::DoLoadPlugins()
 	{
 		KX_SCOPEDLOG_FUNC;
 
+		auto traceScope = TraceScope("LoadPlugins", "Plugins");
+		const auto startTime = PluginTiming::Clock::now();
+
 		// Install exception handler and remove it after loading is done
 		InstallVectoredExceptionHandler();
 		kxf::Utility::ScopeGuard atExit = [&]()
@@ -248,56 +595,233 @@ namespace xSE
 			{
 				RemoveVectoredExceptionHandler();
 			}
+			else
+			{
+				FlushExceptionCaptures();
+			}
 		};
 
 		// Begin loading
 		kxf::FSPath pluginsDirectory = kxf::FSPath("Data") / xSE_FOLDER_NAME_W / "Plugins";
 		KX_SCOPEDLOG.Info().Format("Searching directory '{}' for plugins", pluginsDirectory.GetFullPath());
 
+		LoadScanIndex();
+
 		size_t itemsScanned = 0;
+		const std::vector<PluginCandidate> plugins = CollectPlugins(pluginsDirectory, itemsScanned);
+		for (size_t index: SortPluginsByDependencies(plugins))
+		{
+			const PluginCandidate& plugin = plugins[index];
+			if (plugin.Method == InitializationMethod::xSEPluginPreload)
+			{
+				KX_SCOPEDLOG.Info().Format("Preload directive '{}' found, trying to load the library '{}'", xSE_NAME_W "Plugin_Preload", plugin.Path.GetFullPath());
+			}
+			else
+			{
+				KX_SCOPEDLOG.Info().Format("Preload directive '{}' found, trying to load the corresponding library '{}'", plugin.Path.GetName().BeforeLast('.') + "_preload.txt", plugin.Path.GetFullPath());
+			}
+
+			PluginStatus status = DoLoadSinglePlugin(plugin.Path, plugin.Method);
+			LogLoadStatus(plugin.Path, status);
+		}
+		KX_SCOPEDLOG.Info().Format("Loading finished, {} plugins loaded, {} items scanned", m_LoadedLibraries.size(), itemsScanned);
+
+		SaveScanIndex();
+		m_DependencyCache.clear();
+
+		LogPluginTimings(PluginTiming::Clock::now() - startTime);
+		KX_SCOPEDLOG.SetSuccess();
+	}
+	std::vector<PluginCandidate> PreloadHandler::CollectPlugins(const kxf::FSPath& pluginsDirectory, size_t& itemsScanned)
+	{
+		KX_SCOPEDLOG_FUNC;
+
+		auto traceScope = TraceScope("CollectPlugins", "Plugins");
+
+		std::vector<PluginCandidate> plugins;
 		switch (*m_InitializationMethod)
 		{
 			case InitializationMethod::Standard:
 			{
+				std::vector<kxf::FSPath> libraries;
 				for (const kxf::FileItem& fileItem: m_InstallFS.EnumItems(pluginsDirectory, "*_preload.txt", kxf::FSActionFlag::LimitToFiles))
 				{
 					itemsScanned++;
 					if (fileItem.IsNormalItem())
 					{
-						const kxf::FSPath libraryPath = pluginsDirectory / fileItem.GetName().BeforeLast('_') + ".dll";
-						KX_SCOPEDLOG.Info().Format("Preload directive '{}' found, trying to load the corresponding library '{}'", fileItem.GetName(), libraryPath.GetFullPath());
-
-						PluginStatus status = DoLoadSinglePlugin(libraryPath);
-						LogLoadStatus(libraryPath, status);
+						libraries.emplace_back(pluginsDirectory / fileItem.GetName().BeforeLast('_') + ".dll");
 					}
 				}
+
+				// Nothing to decide here, but the import tables are still needed to order the plugins
+				auto probeResults = ProbePlugins(libraries);
+				for (size_t i = 0; i < libraries.size(); i++)
+				{
+					plugins.push_back({std::move(libraries[i]), InitializationMethod::Standard, std::move(probeResults[i])});
+				}
 				break;
 			}
 			case InitializationMethod::xSEPluginPreload:
 			{
-				const kxf::String routineName = xSE_NAME_W "Plugin_Preload";
+				std::vector<kxf::FSPath> libraries;
 				for (const kxf::FileItem& fileItem: m_InstallFS.EnumItems(pluginsDirectory, "*.dll", kxf::FSActionFlag::LimitToFiles))
 				{
 					itemsScanned++;
 					if (fileItem.IsNormalItem())
 					{
-						const kxf::FSPath libraryPath = pluginsDirectory / fileItem.GetName();
-						if (kxf::DynamicLibrary library(libraryPath, kxf::DynamicLibraryFlag::Resource); !library.IsNull() && library.ContainsExportedFunction(routineName))
+						libraries.emplace_back(pluginsDirectory / fileItem.GetName());
+					}
+				}
+
+				// Probing doesn't need the loader, so it's done for all candidates up front, loading itself stays serial
+				auto probeResults = ProbePlugins(libraries);
+				for (size_t i = 0; i < libraries.size(); i++)
+				{
+					if (probeResults[i].HasPreloadFunction)
+					{
+						plugins.push_back({std::move(libraries[i]), InitializationMethod::xSEPluginPreload, std::move(probeResults[i])});
+					}
+				}
+				break;
+			}
+			case InitializationMethod::Combined:
+			{
+				// Single directory pass for both kinds of plugins: libraries and '*_preload.txt' directives are matched
+				// by their base name so every plugin is loaded once even if it qualifies for both methods.
+				struct Candidate final
+				{
+					kxf::FSPath Path;
+					bool HasLibrary = false;
+					bool HasDirective = false;
+				};
+				std::vector<Candidate> candidates;
+				std::map<kxf::String, size_t> candidateIndex;
+
+				auto GetCandidate = [&](const kxf::String& baseName) -> Candidate&
+				{
+					auto [it, inserted] = candidateIndex.try_emplace(baseName.ToLower(), candidates.size());
+					if (inserted)
+					{
+						candidates.emplace_back().Path = pluginsDirectory / baseName + ".dll";
+					}
+					return candidates[it->second];
+				};
+
+				for (const kxf::FileItem& fileItem: m_InstallFS.EnumItems(pluginsDirectory, "*", kxf::FSActionFlag::LimitToFiles))
+				{
+					itemsScanned++;
+					if (fileItem.IsNormalItem())
+					{
+						const kxf::String name = fileItem.GetName();
+						const kxf::String extension = name.AfterLast('.');
+
+						if (extension.IsSameAs("dll", kxf::StringActionFlag::IgnoreCase))
+						{
+							GetCandidate(name.BeforeLast('.')).HasLibrary = true;
+						}
+						else if (extension.IsSameAs("txt", kxf::StringActionFlag::IgnoreCase) && name.BeforeLast('.').AfterLast('_').IsSameAs("preload", kxf::StringActionFlag::IgnoreCase))
 						{
-							KX_SCOPEDLOG.Info().Format("Preload directive '{}' found, trying to load the library '{}'", routineName, libraryPath.GetFullPath());
-							library.Unload();
+							GetCandidate(name.BeforeLast('_')).HasDirective = true;
+						}
+					}
+				}
+
+				std::vector<kxf::FSPath> libraries;
+				for (const Candidate& candidate: candidates)
+				{
+					if (candidate.HasLibrary || candidate.HasDirective)
+					{
+						libraries.emplace_back(candidate.Path);
+					}
+				}
+				auto probeResults = ProbePlugins(libraries);
 
-							PluginStatus status = DoLoadSinglePlugin(libraryPath);
-							LogLoadStatus(libraryPath, status);
+				for (size_t i = 0, libraryIndex = 0; i < candidates.size(); i++)
+				{
+					const Candidate& candidate = candidates[i];
+					if (!candidate.HasLibrary && !candidate.HasDirective)
+					{
+						continue;
+					}
+					PluginProbeResult& probeResult = probeResults[libraryIndex++];
+
+					// The preload function is the more specific of the two, so it wins when a plugin has both
+					if (probeResult.HasPreloadFunction)
+					{
+						if (candidate.HasDirective)
+						{
+							KX_SCOPEDLOG.Info().Format("Library '{}' has both the preload directive file and the '{}' function, only the function will be called", candidate.Path.GetFullPath(), xSE_NAME_W "Plugin_Preload");
 						}
+						plugins.push_back({candidate.Path, InitializationMethod::xSEPluginPreload, std::move(probeResult)});
+					}
+					else if (candidate.HasDirective)
+					{
+						plugins.push_back({candidate.Path, InitializationMethod::Standard, std::move(probeResult)});
 					}
 				}
 				break;
 			}
 		};
-		KX_SCOPEDLOG.Info().Format("Loading finished, {} plugins loaded, {} items scanned", m_LoadedLibraries.size(), itemsScanned);
+
+		KX_SCOPEDLOG.LogReturn(plugins.size());
+		return plugins;
+	}
+	std::vector<size_t> PreloadHandler::SortPluginsByDependencies(const std::vector<PluginCandidate>& plugins) const
+	{
+		KX_SCOPEDLOG_FUNC;
+
+		PluginDependencyGraph graph;
+		for (const PluginCandidate& plugin: plugins)
+		{
+			graph.AddNode(plugin.Path.GetName().ToUTF8(), plugin.ProbeResult.ImportedModules);
+		}
+		auto sortResult = graph.Sort();
+
+		// Log the plan only if it differs from the enumeration order or if there's something to warn about
+		for (const auto& cycle: sortResult.Cycles)
+		{
+			kxf::String names;
+			for (size_t index: cycle)
+			{
+				if (!names.IsEmpty())
+				{
+					names += ", ";
+				}
+				names += plugins[index].Path.GetName();
+			}
+			KX_SCOPEDLOG.Warning().Format("Cyclic dependency between plugins: [{}], these will be loaded in the enumeration order", names);
+		}
+
+		if (!std::ranges::is_sorted(sortResult.Order))
+		{
+			KX_SCOPEDLOG.Info().Format("Plugins load order was changed to satisfy dependencies between them:");
+			for (size_t i = 0; i < sortResult.Order.size(); i++)
+			{
+				const size_t index = sortResult.Order[i];
+
+				kxf::String dependencies;
+				for (size_t dependency: graph.GetDependencies(index))
+				{
+					if (!dependencies.IsEmpty())
+					{
+						dependencies += ", ";
+					}
+					dependencies += plugins[dependency].Path.GetName();
+				}
+
+				if (dependencies.IsEmpty())
+				{
+					KX_SCOPEDLOG.Info().Format("#{}: '{}'", i + 1, plugins[index].Path.GetName());
+				}
+				else
+				{
+					KX_SCOPEDLOG.Info().Format("#{}: '{}', depends on [{}]", i + 1, plugins[index].Path.GetName(), dependencies);
+				}
+			}
+		}
 
 		KX_SCOPEDLOG.SetSuccess();
+		return std::move(sortResult.Order);
 	}
 	void PreloadHandler::DoUnloadPlugins()
 	{
@@ -307,17 +831,24 @@ namespace xSE
 
 		KX_SCOPEDLOG.SetSuccess();
 	}
-	PluginStatus PreloadHandler::DoLoadSinglePlugin(const kxf::FSPath& path)
+	PluginStatus PreloadHandler::DoLoadSinglePlugin(const kxf::FSPath& path, InitializationMethod initializationMethod)
 	{
-		KX_SCOPEDLOG_ARGS(path.GetName());
+		KX_SCOPEDLOG_ARGS(path.GetName(), initializationMethod);
 
 		kxf::DynamicLibrary pluginLibrary;
 		PluginStatus pluginStatus = PluginStatus::FailedLoad;
+		PluginTiming& timing = GetPluginTiming(path);
+		auto traceScope = m_Trace.IsEnabled() ? TraceScope(path.GetName().ToUTF8(), "Plugins") : TraceEventWriter::Scope();
+		UpdatePluginStream(&timing);
 
 		// Load plugin library
+		const auto loadStartTime = PluginTiming::Clock::now();
 		const kxf::NtStatus loadStatus = Utility::SEHTryExcept([&]()
 		{
-			if (pluginLibrary.Load(path))
+			const bool isLoaded = pluginLibrary.Load(path);
+			timing.LoadTime = PluginTiming::Clock::now() - loadStartTime;
+
+			if (isLoaded)
 			{
 				pluginStatus = PluginStatus::Loaded;
 			}
@@ -335,9 +866,10 @@ namespace xSE
 				KX_SCOPEDLOG.Info().Format("Library is loaded, attempt to call the initialization routine");
 
 				// Call initialization routine
+				const auto initializeStartTime = PluginTiming::Clock::now();
 				const kxf::NtStatus initializeStatus = Utility::SEHTryExcept([&]()
 				{
-					switch (*m_InitializationMethod)
+					switch (initializationMethod)
 					{
 						case InitializationMethod::Standard:
 						{
@@ -382,11 +914,13 @@ namespace xSE
 						}
 						default:
 						{
-							KX_SCOPEDLOG.Critical().Format("Unknown initialization method: {}", *m_InitializationMethod);
+							KX_SCOPEDLOG.Critical().Format("Unknown initialization method: {}", initializationMethod);
 							break;
 						}
 					};
 				});
+				timing.InitializeTime = PluginTiming::Clock::now() - initializeStartTime;
+				m_Trace.AddComplete("Initialize", "Plugins", initializeStartTime, initializeStartTime + timing.InitializeTime, ::GetCurrentThreadId());
 
 				if (initializeStatus)
 				{
@@ -408,60 +942,414 @@ namespace xSE
 		else
 		{
 			pluginStatus = PluginStatus::FailedLoad;
+			timing.LoadTime = PluginTiming::Clock::now() - loadStartTime;
 			KX_SCOPEDLOG.Error().Format("Exception occurred while loading plugin library: {}", loadStatus);
 
 			OnPluginLoadFailed(path);
 		}
 
+		timing.Status = pluginStatus;
+		UpdatePluginStream();
+		m_Trace.AddComplete("Load", "Plugins", loadStartTime, loadStartTime + timing.LoadTime, ::GetCurrentThreadId());
+		KX_SCOPEDLOG.Info().Format("Load time: {:.3f} ms, initialization time: {:.3f} ms", ToMilliseconds(timing.LoadTime), ToMilliseconds(timing.InitializeTime));
+
 		KX_SCOPEDLOG.LogReturn(pluginStatus, pluginStatus == PluginStatus::Loaded || pluginStatus == PluginStatus::Initialized);
 		return pluginStatus;
 	}
-	void PreloadHandler::OnPluginLoadFailed(const kxf::FSPath& path)
+	std::vector<PluginProbeResult> PreloadHandler::ProbePlugins(const std::vector<kxf::FSPath>& paths)
 	{
-		KX_SCOPEDLOG_ARGS(path.GetName());
+		KX_SCOPEDLOG_FUNC;
 
-		const kxf::NtStatus status = Utility::SEHTryExcept([&]()
-		{
-			KX_SCOPEDLOG.Info().Format("Trying to read library dependencies list");
+		std::vector<PluginProbeResult> results(paths.size());
+		std::vector<uint8_t> failed(paths.size(), false);
+		std::vector<size_t> pending;
+		std::vector<std::optional<FileStamp>> stamps(paths.size());
 
-			kxf::DynamicLibrary library(path, kxf::DynamicLibraryFlag::Resource);
-			if (library)
+		// Unchanged files are resolved with a single attributes query, only new or modified files are opened
+		std::vector<std::string> keys(paths.size());
+		for (size_t i = 0; i < paths.size(); i++)
+		{
+			if (m_UseScanIndex)
 			{
-				KX_SCOPEDLOG.Info().Format("Dependency module names:");
-				library.EnumDependencyModuleNames([&](kxf::String moduleName)
+				const kxf::FSPath fullPath = m_InstallFS.ResolvePath(paths[i]);
+				keys[i] = fullPath.GetFullPath().ToUTF8();
+				stamps[i] = GetFileStamp(fullPath);
+
+				if (stamps[i])
 				{
-					kxf::DynamicLibrary dependencyModule(moduleName, kxf::DynamicLibraryFlag::Resource);
-					if (dependencyModule)
+					if (auto result = m_ScanIndex.Find(keys[i], *stamps[i]))
 					{
-						KX_SCOPEDLOG.Info().Format("Module name '{}' loaded successfully as a resource from '{}'", moduleName, dependencyModule.GetFilePath().GetFullPath());
+						results[i] = *result;
+						continue;
 					}
-					else
-					{
-						auto lastError = kxf::Win32Error::GetLastError();
-						KX_SCOPEDLOG.Warning().Format("Couldn't load the dependency library as a resource: {}", moduleName, lastError);
+				}
+			}
+			pending.emplace_back(i);
+		}
 
-						// Try to look for recursive dependencies if the file exists but couldn't be loaded
-						if (lastError != ERROR_FILE_NOT_FOUND && lastError != ERROR_PATH_NOT_FOUND)
-						{
-							OnPluginLoadFailed(moduleName);
-						}
-					}
-					return kxf::CallbackCommand::Continue;
-				});
+		// New threads can't start while we're inside 'DllMain', so the parallel stage is only possible
+		// when the loading is triggered from the import address hook.
+		const bool canUseThreads = *m_LoadMethod == LoadMethod::ImportAddressHook;
+		WorkerPool workerPool(canUseThreads ? m_ProbeThreadCount : 1);
+		std::vector<PluginTiming::Clock::duration> probeTimes(pending.size());
+		workerPool.ForEach(pending.size(), [&](size_t index)
+		{
+			const size_t pathIndex = pending[index];
+			const auto startTime = PluginTiming::Clock::now();
+
+			if (auto result = DoProbePlugin(paths[pathIndex]))
+			{
+				results[pathIndex] = std::move(*result);
 			}
 			else
 			{
-				KX_SCOPEDLOG.Warning().Format("Couldn't load the library as a resource for diagnostics: {}", kxf::Win32Error::GetLastError());
+				failed[pathIndex] = true;
+			}
+			probeTimes[index] = PluginTiming::Clock::now() - startTime;
+			if (m_Trace.IsEnabled())
+			{
+				m_Trace.AddComplete(paths[pathIndex].GetName().ToUTF8(), "Probe", startTime, startTime + probeTimes[index], ::GetCurrentThreadId());
+			}
+		});
+		for (size_t i = 0; i < pending.size(); i++)
+		{
+			GetPluginTiming(paths[pending[i]]).ProbeTime = probeTimes[i];
+		}
+
+		if (!pending.empty())
+		{
+			KX_SCOPEDLOG.Info().Format("Probed {} of {} libraries in {} ms using {} threads", pending.size(), paths.size(), std::chrono::duration_cast<std::chrono::milliseconds>(workerPool.GetWallTime()).count(), workerPool.GetStatistics().size());
+
+			const auto wallTime = workerPool.GetWallTime();
+			for (size_t i = 0; i < workerPool.GetStatistics().size(); i++)
+			{
+				const auto& statistics = workerPool.GetStatistics()[i];
+				const double utilization = wallTime.count() != 0 ? 100.0 * statistics.BusyTime.count() / wallTime.count() : 0.0;
+
+				KX_SCOPEDLOG.Info().Format("Probe worker #{}: {} libraries, busy {} ms ({:.1f}%)", i, statistics.ItemCount, std::chrono::duration_cast<std::chrono::milliseconds>(statistics.BusyTime).count(), utilization);
+			}
+		}
+
+		if (m_UseScanIndex)
+		{
+			for (size_t i: pending)
+			{
+				// A file we couldn't read isn't known not to be a plugin, so nothing is cached for it
+				if (failed[i])
+				{
+					m_ScanIndex.Discard(keys[i]);
+				}
+				else if (stamps[i])
+				{
+					m_ScanIndex.Update(keys[i], *stamps[i], results[i]);
+				}
+			}
+		}
+
+		KX_SCOPEDLOG.SetSuccess();
+		return results;
+	}
+	std::optional<PluginProbeResult> PreloadHandler::DoProbePlugin(const kxf::FSPath& path) const
+	{
+		// Read the export and import tables directly from the file instead of loading the library as a resource,
+		// the library is going to be loaded for real right after this anyway if it turns out to be a plugin.
+		PluginProbeResult result;
+		bool isOpened = false;
+		const kxf::NtStatus status = Utility::SEHTryExcept([&]()
+		{
+			if (MappedFile file(m_InstallFS.ResolvePath(path)); file)
+			{
+				isOpened = true;
+				PE::ImageReader reader(file.GetView(), PE::Layout::File);
+				if (!reader.IsNull())
+				{
+					result.IsValidImage = true;
+					result.HasPreloadFunction = reader.ContainsExport(xSE_NAME_A "Plugin_Preload");
+					result.HasInitializeFunction = reader.ContainsExport("Initialize");
+					reader.EnumImportedModules([&](std::string_view moduleName)
+					{
+						result.ImportedModules.emplace_back(moduleName);
+						return true;
+					});
+				}
 			}
 		});
 
 		if (!status)
+		{
+			// Most likely 'EXCEPTION_IN_PAGE_ERROR', the file got truncated or became unavailable while we were reading it
+			kxf::Log::WarningCategory(path.GetName(), "Exception occurred while reading the library headers: {}", status);
+			return {};
+		}
+		if (!isOpened)
+		{
+			// Locked by another process or empty, either way we don't know what it is yet
+			kxf::Log::WarningCategory(path.GetName(), "Unable to open the library for reading");
+			return {};
+		}
+		return result;
+	}
+	PluginTiming& PreloadHandler::GetPluginTiming(const kxf::FSPath& path)
+	{
+		PluginTiming& timing = m_PluginTimings[path.GetFullPath().ToLower()];
+		if (!timing.Path)
+		{
+			timing.Path = path;
+		}
+		return timing;
+	}
+	void PreloadHandler::LogPluginTimings(PluginTiming::Clock::duration totalTime) const
+	{
+		KX_SCOPEDLOG_FUNC;
+
+		// Only libraries we've tried to load are of interest, the table also has entries for every probed file
+		std::vector<const PluginTiming*> plugins;
+		PluginTiming sum;
+		for (const auto& [key, timing]: m_PluginTimings)
+		{
+			if (timing.Status)
+			{
+				plugins.emplace_back(&timing);
+			}
+			sum.ProbeTime += timing.ProbeTime;
+			sum.LoadTime += timing.LoadTime;
+			sum.InitializeTime += timing.InitializeTime;
+		}
+
+		// Probing may run in parallel, so its time is the sum over all the worker threads and can exceed the total time
+		KX_SCOPEDLOG.Info().Format("Total preload time: {:.3f} ms for {} plugins (probe: {:.3f} ms, load: {:.3f} ms, initialization: {:.3f} ms)",
+								   ToMilliseconds(totalTime),
+								   plugins.size(),
+								   ToMilliseconds(sum.ProbeTime),
+								   ToMilliseconds(sum.LoadTime),
+								   ToMilliseconds(sum.InitializeTime)
+		);
+
+		const size_t count = std::min(plugins.size(), g_SlowestPluginsCount);
+		std::partial_sort(plugins.begin(), plugins.begin() + count, plugins.end(), [](const auto& left, const auto& right)
+		{
+			return left->GetTotalTime() > right->GetTotalTime();
+		});
+
+		if (count != 0)
+		{
+			KX_SCOPEDLOG.Info().Format("Slowest plugins:");
+		}
+		for (size_t i = 0; i < count; i++)
+		{
+			const PluginTiming* timing = plugins[i];
+			KX_SCOPEDLOG.Info().Format("#{}: '{}', {:.3f} ms (probe: {:.3f} ms, load: {:.3f} ms, initialization: {:.3f} ms)",
+									   i + 1,
+									   timing->Path.GetName(),
+									   ToMilliseconds(timing->GetTotalTime()),
+									   ToMilliseconds(timing->ProbeTime),
+									   ToMilliseconds(timing->LoadTime),
+									   ToMilliseconds(timing->InitializeTime)
+			);
+		}
+		KX_SCOPEDLOG.SetSuccess();
+	}
+	void PreloadHandler::LoadScanIndex()
+	{
+		KX_SCOPEDLOG_FUNC;
+
+		if (!m_UseScanIndex)
+		{
+			KX_SCOPEDLOG.Info().Format("Plugin scan index is disabled in the config file");
+			return;
+		}
+
+		// Any change to the preloader itself or to its configuration invalidates the whole index. The version alone isn't enough,
+		// a rebuilt library can probe differently, so the stamp of the library file is a part of the signature too.
+		const auto moduleStamp = GetFileStamp(kxf::DynamicLibrary::GetCurrentModule().GetFilePath()).value_or(FileStamp());
+		const auto configStamp = GetFileStamp(m_InstallFS.ResolvePath(g_ConfigFileName)).value_or(FileStamp());
+		const kxf::String signature = kxf::Format("{}/{}/{}/{}:{}/{}:{}", GetLibraryName(), GetLibraryVersion().ToString(), xSE_NAME_W,
+												  moduleStamp.Size, moduleStamp.LastWriteTime,
+												  configStamp.Size, configStamp.LastWriteTime
+		);
+		m_ScanIndex = PluginScanIndex(signature.ToUTF8());
+
+		if (auto stream = m_ConfigFS.OpenToRead(g_ScanIndexFileName))
+		{
+			std::vector<std::byte> buffer(stream->GetSize().ToBytes());
+			if (stream->ReadAll(buffer.data(), buffer.size()) && m_ScanIndex.Deserialize(buffer))
+			{
+				KX_SCOPEDLOG.Info().Format("Plugin scan index loaded, {} entries", m_ScanIndex.GetCount());
+			}
+			else
+			{
+				KX_SCOPEDLOG.Info().Format("Plugin scan index is outdated or damaged, all plugins will be rescanned");
+			}
+		}
+		else
+		{
+			KX_SCOPEDLOG.Info().Format("No plugin scan index found, all plugins will be scanned");
+		}
+		KX_SCOPEDLOG.SetSuccess();
+	}
+	void PreloadHandler::SaveScanIndex()
+	{
+		KX_SCOPEDLOG_FUNC;
+
+		if (!m_UseScanIndex)
+		{
+			return;
+		}
+		KX_SCOPEDLOG.Info().Format("Plugin scan index: {} hits, {} misses", m_ScanIndex.GetHitCount(), m_ScanIndex.GetMissCount());
+
+		if (m_ScanIndex.IsModified())
+		{
+			using namespace kxf;
+
+			const auto buffer = m_ScanIndex.Serialize();
+			auto stream = m_ConfigFS.OpenToWrite(g_ScanIndexFileName, IOStreamDisposition::CreateAlways, IOStreamShare::None, FSActionFlag::CreateDirectoryTree|FSActionFlag::Recursive);
+			if (stream && stream->WriteAll(buffer.data(), buffer.size()))
+			{
+				KX_SCOPEDLOG.Info().Format("Plugin scan index saved, {} entries", m_ScanIndex.GetCount());
+			}
+			else
+			{
+				KX_SCOPEDLOG.Warning().Format("Couldn't save plugin scan index: {}", kxf::Win32Error::GetLastError());
+			}
+		}
+		KX_SCOPEDLOG.SetSuccess();
+	}
+	void PreloadHandler::OnPluginLoadFailed(const kxf::FSPath& path)
+	{
+		KX_SCOPEDLOG_ARGS(path.GetName());
+
+		auto traceScope = TraceScope("DiagnoseDependencies", "Plugins");
+
+		// Dependency lookups are cached for the whole loading session, plugins usually share most of their
+		// dependencies (runtime libraries, common frameworks) and each lookup maps the module as a resource.
+		const size_t cachedCount = m_DependencyCache.size();
+		size_t resolvedCount = 0;
+		size_t unresolvedCount = 0;
+
+		const kxf::NtStatus status = Utility::SEHTryExcept([&]()
+		{
+			KX_SCOPEDLOG.Info().Format("Dependency tree of '{}':", path.GetName());
+
+			std::vector<kxf::String> importChain;
+			importChain.emplace_back(path.GetName().ToLower());
+			DiagnoseDependencies(m_InstallFS.ResolvePath(path), importChain, resolvedCount, unresolvedCount);
+		});
+
+		if (status)
+		{
+			KX_SCOPEDLOG.Info().Format("Dependencies checked: {} resolved, {} unresolved, {} modules looked up, {} already known", resolvedCount, unresolvedCount, m_DependencyCache.size() - cachedCount, cachedCount);
+		}
+		else
 		{
 			KX_SCOPEDLOG.Error().Format("Exception occurred while scanning plugin library dependencies: {}", status);
 		}
 
 		KX_SCOPEDLOG.SetSuccess(status.IsSuccess());
 	}
+	DependencyStatus& PreloadHandler::ResolveDependency(const kxf::String& moduleName)
+	{
+		auto [it, inserted] = m_DependencyCache.try_emplace(moduleName.ToLower());
+		if (inserted)
+		{
+			DependencyStatus& dependency = it->second;
+
+			kxf::DynamicLibrary dependencyModule(moduleName, kxf::DynamicLibraryFlag::Resource);
+			if (dependencyModule)
+			{
+				dependency.Path = dependencyModule.GetFilePath();
+				dependency.IsResolved = true;
+			}
+			else
+			{
+				// Remember where the file is if it exists but can't be loaded, so its own dependencies can be checked
+				dependency.Error = kxf::Win32Error::GetLastError();
+				if (dependency.Error != ERROR_FILE_NOT_FOUND && dependency.Error != ERROR_PATH_NOT_FOUND && dependency.Error != ERROR_MOD_NOT_FOUND)
+				{
+					dependency.Path = SearchModulePath(moduleName);
+				}
+			}
+		}
+		return it->second;
+	}
+	void PreloadHandler::DiagnoseDependencies(const kxf::FSPath& path, std::vector<kxf::String>& importChain, size_t& resolvedCount, size_t& unresolvedCount)
+	{
+		kxf::String indent;
+		for (size_t i = 0; i < importChain.size(); i++)
+		{
+			indent += "  ";
+		}
+
+		auto moduleNames = ReadImportedModules(path);
+		if (!moduleNames)
+		{
+			kxf::Log::WarningCategory(LogCategory::Dependencies, "{}<couldn't read the import table of '{}'>", indent, path.GetFullPath());
+			return;
+		}
+
+		for (const kxf::String& moduleName: *moduleNames)
+		{
+			DependencyStatus& dependency = ResolveDependency(moduleName);
+			if (dependency.IsResolved)
+			{
+				resolvedCount++;
+				kxf::Log::InfoCategory(LogCategory::Dependencies, "{}'{}': '{}'", indent, moduleName, dependency.Path.GetFullPath());
+				continue;
+			}
+			unresolvedCount++;
+
+			const kxf::String key = moduleName.ToLower();
+			if (!dependency.Path)
+			{
+				kxf::Log::WarningCategory(LogCategory::Dependencies, "{}'{}': not found, {}", indent, moduleName, dependency.Error);
+			}
+			else if (std::ranges::find(importChain, key) != importChain.end())
+			{
+				kxf::Log::WarningCategory(LogCategory::Dependencies, "{}'{}': can't be loaded, {}. Cyclic import, the module is already in this chain", indent, moduleName, dependency.Error);
+			}
+			else if (dependency.IsDiagnosed)
+			{
+				kxf::Log::WarningCategory(LogCategory::Dependencies, "{}'{}': can't be loaded, {}. Its dependencies were listed earlier", indent, moduleName, dependency.Error);
+			}
+			else
+			{
+				kxf::Log::WarningCategory(LogCategory::Dependencies, "{}'{}': can't be loaded from '{}', {}", indent, moduleName, dependency.Path.GetFullPath(), dependency.Error);
+				dependency.IsDiagnosed = true;
+
+				if (importChain.size() < g_MaxDependencyDepth)
+				{
+					importChain.emplace_back(key);
+					DiagnoseDependencies(dependency.Path, importChain, resolvedCount, unresolvedCount);
+					importChain.pop_back();
+				}
+			}
+		}
+	}
+
+	TraceEventWriter::Scope PreloadHandler::TraceScope(std::string_view name, std::string_view category)
+	{
+		return m_Trace.BeginScope(name, category, ::GetCurrentThreadId());
+	}
+	void PreloadHandler::SaveTrace()
+	{
+		if (!m_WriteTrace)
+		{
+			return;
+		}
+
+		using namespace kxf;
+
+		// Rewritten every time, so the file always has the most complete timeline we've got so far
+		const std::string buffer = m_Trace.Serialize();
+		auto stream = m_ConfigFS.OpenToWrite(g_TraceFileName, IOStreamDisposition::CreateAlways, IOStreamShare::Read, FSActionFlag::CreateDirectoryTree|FSActionFlag::Recursive);
+		if (stream && stream->WriteAll(buffer.data(), buffer.size()))
+		{
+			Log::Info("Trace saved to '{}', {} events ({} dropped)", m_ConfigFS.ResolvePath(g_TraceFileName).GetFullPath(), m_Trace.GetCount(), m_Trace.GetDroppedCount());
+		}
+		else
+		{
+			Log::Warning("Couldn't save trace: {}", Win32Error::GetLastError());
+		}
+	}
 
 	bool PreloadHandler::CheckAllowedProcesses() const
 	{
@@ -502,6 +1390,8 @@ namespace xSE
 	}
 	void PreloadHandler::LoadOriginalLibrary()
 	{
+		auto traceScope = TraceScope("LoadOriginalLibrary", "Startup");
+
 		kxf::FSPath path = GetOriginalLibraryPath();
 		kxf::Log::Info("<{}> Loading original library", path.GetFullPath());
 
@@ -532,6 +1422,11 @@ namespace xSE
 	{
 		if (m_InstallExceptionHandler)
 		{
+			BuildExceptionFilter();
+			WatchModuleRanges();
+			StartExceptionStatistics();
+			StartMinidumpWriter();
+			StartFatalFlushThread();
 			m_VectoredExceptionHandler.Install([](_EXCEPTION_POINTERS* exceptionInfo) -> LONG
 			{
 				if (g_Instance && exceptionInfo)
@@ -540,6 +1435,7 @@ namespace xSE
 				}
 				return EXCEPTION_CONTINUE_SEARCH;
 			}, VectoredExceptionHandler::Mode::ExceptionHandler, VectoredExceptionHandler::Order::First);
+			m_ExceptionHandlerInstallTime = TraceEventWriter::Clock::now();
 			kxf::Log::Info("Installing vectored exception handler: {}", m_VectoredExceptionHandler.IsInstalled() ? "success" : "failed");
 
 			return m_VectoredExceptionHandler.IsInstalled();
@@ -550,100 +1446,410 @@ namespace xSE
 			return false;
 		}
 	}
-	void PreloadHandler::RemoveVectoredExceptionHandler()
-	{
-		kxf::Log::Info("Removing vectored exception handler: {}", m_VectoredExceptionHandler.Remove() ? "success" : "failed (not installed or already removed)");
-	}
-	uint32_t PreloadHandler::OnVectoredContinue(const _EXCEPTION_POINTERS& exceptionInfo)
+	void PreloadHandler::BuildExceptionFilter()
 	{
-		KX_SCOPEDLOG_FUNC;
-
-		KX_SCOPEDLOG.Warning() << DumpExceptionInformation(exceptionInfo);
+		// Built once, so the statistics cover the whole time the handler was installed. Module rules are matched by name
+		// against the module ranges index, so they also apply to modules which are loaded later.
+		if (!m_ExceptionFilter.IsEmpty() || m_ExceptionFilterRules.empty())
+		{
+			return;
+		}
 
-		return EXCEPTION_CONTINUE_SEARCH;
+		m_ExceptionFilter = ExceptionFilter(m_ExceptionFilterRules);
+		kxf::Log::Info("Exception filter: {} rules", m_ExceptionFilter.GetRuleCount());
 	}
-	uint32_t PreloadHandler::OnVectoredException(const _EXCEPTION_POINTERS& exceptionInfo)
+	void PreloadHandler::WatchModuleRanges()
 	{
-		KX_SCOPEDLOG_FUNC;
+		if (m_ModuleRangesWatched)
+		{
+			return;
+		}
+		m_ModuleRangesWatched = true;
 
-		KX_SCOPEDLOG.Warning() << DumpExceptionInformation(exceptionInfo);
+		std::vector<ModuleRange> ranges;
+		for (HMODULE module: EnumLoadedModules())
+		{
+			if (auto range = GetModuleRange(module))
+			{
+				ranges.emplace_back(std::move(*range));
+			}
+		}
+		m_ModuleRanges.Reset(std::move(ranges));
+		kxf::Log::Info("Module ranges: {} modules loaded", m_ModuleRanges.GetModuleCount());
 
-		return EXCEPTION_CONTINUE_SEARCH;
+		// Each change publishes a new snapshot, the exception handler never waits for it
+		m_Application->Bind(kxf::DynamicLibraryEvent::EvtLoaded, [this](kxf::DynamicLibraryEvent& event)
+		{
+			if (auto range = GetModuleRange(static_cast<HMODULE>(event.GetLibrary().GetHandle())))
+			{
+				m_ModuleRanges.Add(std::move(*range));
+			}
+		}, kxf::BindEventFlag::AlwaysSkip);
+		m_Application->Bind(kxf::DynamicLibraryEvent::EvtUnloaded, [this](kxf::DynamicLibraryEvent& event)
+		{
+			if (void* handle = event.GetLibrary().GetHandle())
+			{
+				m_ModuleRanges.Remove(reinterpret_cast<uintptr_t>(handle));
+			}
+		}, kxf::BindEventFlag::AlwaysSkip);
 	}
-	kxf::String PreloadHandler::DumpExceptionInformation(const _EXCEPTION_POINTERS& exceptionInfo) const
+	void PreloadHandler::StartExceptionStatistics()
 	{
-		kxf::String result;
-
-		const auto& context = exceptionInfo.ContextRecord;
-		#if _WIN64
-		result.Format("ContextRecord: [RAX: {:#016x}], [RBX: {:#016x}], [RCX: {:#016x}], [RDX: {:#016x}], [RBP: {:#016x}], [RDI: {:#016x}], [RIP: {:#016x}], "
-					  "[R08: {:#016x}], [R09: {:#016x}], [R10: {:#016x}], [R11: {:#016x}], [R12: {:#016x}], [R13: {:#016x}], [R14: {:#016x}], [R15: {:#016x}].\n",
-					  context->Rax,
-					  context->Rbx,
-					  context->Rcx,
-					  context->Rdx,
-					  context->Rbp,
-					  context->Rdi,
-					  context->Rip,
-					  context->R8,
-					  context->R9,
-					  context->R10,
-					  context->R11,
-					  context->R12,
-					  context->R13,
-					  context->R14,
-					  context->R15);
-		#else
-		result.Format("ContextRecord: [EAX: {:#08x}], [EBX: {:#08x}], [ECX: {:#08x}], [EDX: {:#08x}], [EBP: {:#08x}], [EDI: {:#08x}], [EIP: {:#08x}].\n",
-					  context->Eax,
-					  context->Ebx,
-					  context->Ecx,
-					  context->Edx,
-					  context->Ebp,
-					  context->Edi,
-					  context->Eip);
-		#endif
+		// Created once and kept until exit, so the counters cover the whole session
+		if (!m_AggregateExceptions || m_ExceptionStatistics)
+		{
+			return;
+		}
 
-		const auto& exception = exceptionInfo.ExceptionRecord;
+		m_ExceptionStatistics = std::make_unique<ExceptionStatistics>(m_ExceptionTableSize);
+		kxf::Log::InfoCategory(LogCategory::Exceptions, "Exceptions are aggregated, only the first occurrence of each code and address is captured, table size: {}", m_ExceptionStatistics->GetTableSize());
 
-		auto GetExceptionMessage = [](kxf::NtStatus status)
+		if (m_ExceptionSummaryInterval.IsPositive())
 		{
-			kxf::String exceptionCodeMessage = status.GetMessage();
-			exceptionCodeMessage.Replace("\r\n", "; ");
-			exceptionCodeMessage.Replace("\r", "; ");
-			exceptionCodeMessage.Replace("\n", "; ");
-			exceptionCodeMessage.TrimBoth();
-
-			return exceptionCodeMessage;
-		};
-		result.Format("ExceptionRecord:\n\tExceptionCode: [NtStatus: ({:#08x}) '{}']\n\tExceptionFlags: {:#08x}\n\tExceptionAddress: {:{}#0x}\n\tExceptionRecord: {:{}#0x}",
-					  exception->ExceptionCode,
-					  GetExceptionMessage(exception->ExceptionCode),
-					  exception->ExceptionFlags,
-					  reinterpret_cast<size_t>(exception->ExceptionAddress), sizeof(void*),
-					  reinterpret_cast<size_t>(exception->ExceptionRecord), sizeof(void*)
-		);
+			// Pool threads don't start until the loader lock is released, so the timer can be set from 'DllMain'
+			m_ExceptionSummaryTimer = ::CreateThreadpoolTimer([](PTP_CALLBACK_INSTANCE, void* context, PTP_TIMER)
+			{
+				auto& handler = *static_cast<PreloadHandler*>(context);
+				if (handler.EnterPoolCallback())
+				{
+					kxf::Utility::ScopeGuard atExit = [&]()
+					{
+						handler.LeavePoolCallback();
+					};
+					handler.FlushExceptionCaptures();
+					handler.LogExceptionStatistics();
+				}
+			}, this, nullptr);
 
-		return result;
+			if (m_ExceptionSummaryTimer)
+			{
+				// Negative due time is relative, in 100 ns units
+				const auto interval = m_ExceptionSummaryInterval.GetMilliseconds();
+				ULARGE_INTEGER dueTime = {};
+				dueTime.QuadPart = static_cast<ULONGLONG>(-interval * 10000);
+
+				FILETIME fileTime = {};
+				fileTime.dwLowDateTime = dueTime.LowPart;
+				fileTime.dwHighDateTime = dueTime.HighPart;
+				::SetThreadpoolTimer(m_ExceptionSummaryTimer, &fileTime, static_cast<DWORD>(std::min<int64_t>(interval, std::numeric_limits<DWORD>::max())), 0);
+			}
+		}
 	}
-
-	bool PreloadHandler::InitializeFramework()
+	void PreloadHandler::StartMinidumpWriter()
 	{
-		KX_SCOPEDLOG_FUNC;
-
-		// Register modules
-		using kxf::NativeAPISet;
+		if (!m_WriteMinidump || m_MinidumpWriter.IsRunning())
+		{
+			return;
+		}
 
-		auto& loader = kxf::NativeAPILoader::GetInstance();
-		loader.LoadLibraries(
+		auto options = m_MinidumpOptions;
+		options.Directory = m_ConfigFS.GetLookupDirectory();
+		if (m_MinidumpWriter.Start(std::move(options)))
 		{
-			NativeAPISet::NtDLL,
-			NativeAPISet::Kernel32,
-			NativeAPISet::KernelBase,
-			NativeAPISet::User32,
-			NativeAPISet::ShlWAPI,
-			NativeAPISet::DbgHelp
-		});
+			// Works independently of the vectored exception handler, so it stays in place even if the handler is removed
+			m_PreviousUnhandledExceptionFilter = ::SetUnhandledExceptionFilter(UnhandledExceptionFilterProc);
+			m_UnhandledExceptionFilterInstalled = true;
+
+			kxf::Log::Info("Minidump writer started: type {:#x}, size limit {} bytes, up to {} dumps", static_cast<uint32_t>(m_MinidumpOptions.Type), m_MinidumpOptions.MaxSize, m_MinidumpOptions.MaxCount);
+			UpdatePluginStream();
+		}
+		else
+		{
+			kxf::Log::Warning("Couldn't start minidump writer: {}", kxf::Win32Error::GetLastError());
+		}
+	}
+	void PreloadHandler::StopMinidumpWriter()
+	{
+		if (m_UnhandledExceptionFilterInstalled)
+		{
+			// Put the previous filter back, unless ours was replaced in the meantime (by a crash logger plugin for example).
+			// Then the new one stays, whoever installed it is responsible for calling ours.
+			auto current = ::SetUnhandledExceptionFilter(m_PreviousUnhandledExceptionFilter);
+			if (current != UnhandledExceptionFilterProc)
+			{
+				::SetUnhandledExceptionFilter(current);
+			}
+			m_UnhandledExceptionFilterInstalled = false;
+		}
+		if (m_MinidumpWriter.IsRunning())
+		{
+			kxf::Log::Info("Minidump writer: {} dumps written", m_MinidumpWriter.GetWrittenCount());
+			m_MinidumpWriter.Stop();
+		}
+	}
+	void PreloadHandler::UpdatePluginStream(const PluginTiming* loadingPlugin)
+	{
+		if (!m_MinidumpWriter.IsRunning())
+		{
+			return;
+		}
+
+		// Every plugin we've tried to load so far and the one being loaded right now
+		std::vector<PluginListStream::Entry> entries;
+		for (const auto& [key, timing]: m_PluginTimings)
+		{
+			if (timing.Status || &timing == loadingPlugin)
+			{
+				auto& entry = entries.emplace_back();
+				entry.Name = timing.Path.GetFullPath().ToUTF8();
+				entry.State = ToLoadState(timing.Status);
+				entry.LoadTime = std::chrono::duration_cast<std::chrono::nanoseconds>(timing.LoadTime);
+				entry.InitializeTime = std::chrono::duration_cast<std::chrono::nanoseconds>(timing.InitializeTime);
+			}
+		}
+		m_MinidumpWriter.SetPluginStream(PluginListStream::Encode(entries));
+	}
+	void PreloadHandler::LogExceptionStatistics()
+	{
+		if (!m_ExceptionStatistics || m_ExceptionStatistics->GetTotalCount() == 0)
+		{
+			return;
+		}
+
+		const auto summaries = m_ExceptionStatistics->Summarize();
+		kxf::Log::InfoCategory(LogCategory::Exceptions, "{} exceptions captured by the filter, {} distinct", m_ExceptionStatistics->GetTotalCount(), summaries.size());
+		for (const auto& summary: summaries)
+		{
+			const auto& key = summary.Definition;
+			if (const auto moduleName = key.GetModuleName(); !moduleName.empty())
+			{
+				kxf::Log::InfoCategory(LogCategory::Exceptions, "{:#010x} at {}+{:#x}: {}", key.Code, kxf::String::FromUTF8(moduleName), key.ModuleOffset, summary.Count);
+			}
+			else
+			{
+				kxf::Log::InfoCategory(LogCategory::Exceptions, "{:#010x} at {:#x}: {}", key.Code, key.ModuleOffset, summary.Count);
+			}
+		}
+
+		if (const uint64_t overflowCount = m_ExceptionStatistics->GetOverflowCount(); overflowCount != 0)
+		{
+			kxf::Log::WarningCategory(LogCategory::Exceptions, "{} exceptions weren't counted separately because all {} table entries are in use", overflowCount, m_ExceptionStatistics->GetTableSize());
+		}
+		FlushLog();
+	}
+	void PreloadHandler::LogExceptionFilterStatistics() const
+	{
+		m_ExceptionFilter.EnumStatistics([](const ExceptionFilter::RuleStatistics& statistics)
+		{
+			if (statistics.Matched != 0)
+			{
+				kxf::Log::Info("Exception filter: rule '{}' matched {} exceptions, {} suppressed", statistics.Definition.Description, statistics.Matched, statistics.Suppressed);
+			}
+		});
+	}
+	void PreloadHandler::RemoveVectoredExceptionHandler()
+	{
+		if (m_VectoredExceptionHandler.Remove())
+		{
+			FlushExceptionCaptures();
+			kxf::Log::Info("Removing vectored exception handler: success");
+			m_Trace.AddComplete("VectoredExceptionHandler", "ExceptionHandler", m_ExceptionHandlerInstallTime, TraceEventWriter::Clock::now(), ::GetCurrentThreadId());
+		}
+		else
+		{
+			kxf::Log::Info("Removing vectored exception handler: failed (not installed or already removed)");
+		}
+	}
+	uint32_t PreloadHandler::OnVectoredContinue(const _EXCEPTION_POINTERS& exceptionInfo)
+	{
+		if (ShouldCaptureException(*exceptionInfo.ExceptionRecord))
+		{
+			CaptureException(exceptionInfo);
+		}
+		return EXCEPTION_CONTINUE_SEARCH;
+	}
+	uint32_t PreloadHandler::OnVectoredException(const _EXCEPTION_POINTERS& exceptionInfo)
+	{
+		const EXCEPTION_RECORD& exception = *exceptionInfo.ExceptionRecord;
+		if (ShouldCaptureException(exception))
+		{
+			CaptureException(exceptionInfo);
+
+			// Only capture here, first-chance access violations and the like are routinely handled by the game and plugins.
+			// An exception which can't be continued won't be, so the captures and the log are written out now. This thread
+			// can be holding the heap or the logger lock, so it's done by the flush thread and waited for only for a limited time.
+			if (exception.ExceptionFlags & EXCEPTION_NONCONTINUABLE)
+			{
+				m_FatalFlushThread.Run(g_FatalFlushTimeout);
+			}
+		}
+		return EXCEPTION_CONTINUE_SEARCH;
+	}
+	uint32_t PreloadHandler::OnUnhandledException(const _EXCEPTION_POINTERS& exceptionInfo)
+	{
+		// Nobody has handled the exception and the process is about to terminate, unless the filter installed before ours
+		// decides otherwise. First-chance exceptions with the same codes are routinely handled, so dumps are written only here.
+		m_FatalFlushThread.Run(g_FatalFlushTimeout);
+		if (m_MinidumpWriter.IsRunning())
+		{
+			m_MinidumpWriter.Write(exceptionInfo);
+		}
+
+		if (m_PreviousUnhandledExceptionFilter)
+		{
+			return m_PreviousUnhandledExceptionFilter(const_cast<_EXCEPTION_POINTERS*>(&exceptionInfo));
+		}
+		return EXCEPTION_CONTINUE_SEARCH;
+	}
+	void PreloadHandler::FlushLog()
+	{
+		// The process may not survive the exception we're handling, so everything logged so far should be on the disk
+		if (m_LogBuffer)
+		{
+			m_LogBuffer->Flush();
+		}
+	}
+	void PreloadHandler::StartFatalFlushThread()
+	{
+		if (m_FatalFlushThread.IsRunning())
+		{
+			return;
+		}
+
+		const bool started = m_FatalFlushThread.Start([this]()
+		{
+			FlushExceptionCaptures();
+			FlushLog();
+		});
+		if (!started)
+		{
+			kxf::Log::Warning("Couldn't start the fatal exception flush thread: {}, the log may be incomplete after a crash", kxf::Win32Error::GetLastError());
+		}
+	}
+	bool PreloadHandler::ShouldCaptureException(const EXCEPTION_RECORD& exception) noexcept
+	{
+		if (m_ExceptionFilter.IsEmpty())
+		{
+			return true;
+		}
+
+		const uint32_t code = exception.ExceptionCode;
+		if (m_ExceptionFilter.HasModuleRules())
+		{
+			bool capture = true;
+			const bool found = m_ModuleRanges.Find(reinterpret_cast<uintptr_t>(exception.ExceptionAddress), [&](const ModuleRange& module) noexcept
+			{
+				capture = m_ExceptionFilter.ShouldCapture(code, module.Name);
+			});
+			return found ? capture : m_ExceptionFilter.ShouldCapture(code, {});
+		}
+		return m_ExceptionFilter.ShouldCapture(code, {});
+	}
+	void PreloadHandler::CaptureException(const _EXCEPTION_POINTERS& exceptionInfo) noexcept
+	{
+		// The heap or the logger may be in any state here, so only copy the data to a preallocated slot.
+		// Formatting and logging happen in 'FlushExceptionCaptures'.
+		const EXCEPTION_RECORD& exception = *exceptionInfo.ExceptionRecord;
+		const auto address = reinterpret_cast<uintptr_t>(exception.ExceptionAddress);
+
+		ExceptionStatistics::Key key;
+		key.Code = exception.ExceptionCode;
+		key.ModuleOffset = address;
+		m_ModuleRanges.Find(address, [&](const ModuleRange& module) noexcept
+		{
+			key.SetModule(module.Name, address - module.Begin);
+		});
+
+		// When aggregating, only the first occurrence of each key is captured in full and the rest are only counted
+		if (m_ExceptionStatistics && m_ExceptionStatistics->Record(key) != ExceptionStatistics::RecordResult::First)
+		{
+			return;
+		}
+
+		ExceptionSnapshot* snapshot = m_ExceptionCapture.Acquire();
+		if (!snapshot)
+		{
+			return;
+		}
+		snapshot->ThreadID = ::GetCurrentThreadId();
+
+		snapshot->Code = exception.ExceptionCode;
+		snapshot->Flags = exception.ExceptionFlags;
+		snapshot->Address = address;
+		snapshot->NestedRecord = reinterpret_cast<uintptr_t>(exception.ExceptionRecord);
+		if (const auto moduleName = key.GetModuleName(); !moduleName.empty())
+		{
+			snapshot->SetModule(moduleName, key.ModuleOffset);
+		}
+		snapshot->ParameterCount = std::min<uint32_t>(exception.NumberParameters, ExceptionSnapshot::MaxParameters);
+		std::copy_n(exception.ExceptionInformation, snapshot->ParameterCount, snapshot->Parameters);
+
+		const CONTEXT& context = *exceptionInfo.ContextRecord;
+		#if _WIN64
+		const uint64_t registers[] =
+		{
+			context.Rax, context.Rbx, context.Rcx, context.Rdx, context.Rsi, context.Rdi, context.Rbp, context.Rsp,
+			context.R8, context.R9, context.R10, context.R11, context.R12, context.R13, context.R14, context.R15,
+			context.Rip, context.EFlags
+		};
+		snapshot->Architecture = CPUArchitecture::x64;
+		const uintptr_t stackPointer = context.Rsp;
+		#else
+		const uint64_t registers[] =
+		{
+			context.Eax, context.Ebx, context.Ecx, context.Edx, context.Esi, context.Edi, context.Ebp, context.Esp,
+			context.Eip, context.EFlags
+		};
+		snapshot->Architecture = CPUArchitecture::x86;
+		const uintptr_t stackPointer = context.Esp;
+		#endif
+		std::ranges::copy(registers, snapshot->Registers);
+
+		// Vectored handlers run on the faulting thread, everything between its stack pointer and the stack base is committed.
+		// The context can belong to a different stack (a fiber for example), nothing is copied then.
+		const auto tib = reinterpret_cast<const NT_TIB*>(::NtCurrentTeb());
+		const auto stackBase = reinterpret_cast<uintptr_t>(tib->StackBase);
+		const auto stackLimit = reinterpret_cast<uintptr_t>(tib->StackLimit);
+		if (stackPointer >= stackLimit && stackPointer < stackBase)
+		{
+			snapshot->CopyStack(stackPointer, reinterpret_cast<const void*>(stackPointer), stackBase - stackPointer);
+		}
+
+		m_ExceptionCapture.Commit(*snapshot);
+	}
+	void PreloadHandler::FlushExceptionCaptures()
+	{
+		const size_t count = m_ExceptionCapture.Flush([](const ExceptionSnapshot& snapshot)
+		{
+			kxf::NtStatus status = static_cast<NTSTATUS>(snapshot.Code);
+			kxf::String message = status.GetMessage();
+			message.Replace("\r\n", "; ");
+			message.Replace("\r", "; ");
+			message.Replace("\n", "; ");
+			message.TrimBoth();
+
+			kxf::Log::Warning("Vectored exception handler: [NtStatus: ({:#08x}) '{}']\n{}", snapshot.Code, message, FormatExceptionSnapshot(snapshot));
+		});
+
+		if (const size_t droppedCount = m_ExceptionCapture.GetDroppedCount(); droppedCount != 0)
+		{
+			kxf::Log::Warning("Vectored exception handler: {} exceptions weren't captured because all {} slots were waiting for a flush", droppedCount, m_ExceptionCapture.GetSlotCount());
+		}
+		if (count != 0)
+		{
+			FlushLog();
+		}
+	}
+
+	bool PreloadHandler::InitializeFramework()
+	{
+		KX_SCOPEDLOG_FUNC;
+
+		auto traceScope = TraceScope("InitializeFramework", "Startup");
+
+		// Register modules
+		using kxf::NativeAPISet;
+
+		auto& loader = kxf::NativeAPILoader::GetInstance();
+		loader.LoadLibraries(
+		{
+			NativeAPISet::NtDLL,
+			NativeAPISet::Kernel32,
+			NativeAPISet::KernelBase,
+			NativeAPISet::User32,
+			NativeAPISet::ShlWAPI,
+			NativeAPISet::DbgHelp
+		});
 
 		wxModule::RegisterModules();
 		if (wxModule::InitializeModules() && m_Application->OnInit())
@@ -763,12 +1969,19 @@ namespace xSE
 		return extenderResourceInfo;
 	}
 
-	bool PreloadHandler::OnDLLMain(HMODULE handle, uint32_t event)
+	bool PreloadHandler::OnDLLMain(HMODULE handle, uint32_t event, void* reserved)
 	{
 		switch (event)
 		{
 			case DLL_PROCESS_ATTACH:
 			{
+				if (!m_PluginsLoadAllowed)
+				{
+					// Nothing to do here besides forwarding calls to the original library
+					DisableThreadLibraryCalls(handle);
+					break;
+				}
+
 				if (*m_LoadMethod == LoadMethod::OnProcessAttach || *m_LoadMethod == LoadMethod::ImportAddressHook)
 				{
 					KX_SCOPEDLOG_ARGS(handle, event);
@@ -790,104 +2003,319 @@ namespace xSE
 				{
 					m_WatchThreadAttach = true;
 				}
+				else if (*m_LoadMethod == LoadMethod::OnModuleLoad)
+				{
+					KX_SCOPEDLOG_ARGS(handle, event);
+
+					DisableThreadLibraryCalls(handle);
+					WatchModuleLoad();
+
+					KX_SCOPEDLOG.SetSuccess();
+				}
 
 				break;
 			}
 			case DLL_THREAD_ATTACH:
 			{
-				if (!m_WatchThreadAttach)
+				if (!m_WatchThreadAttach)
+				{
+					break;
+				}
+
+				if (*m_LoadMethod == LoadMethod::OnThreadAttach)
+				{
+					KX_SCOPEDLOG_ARGS(handle, event);
+
+					const size_t threadCounter = ++m_ThreadAttachCount;
+					kxf::Log::Info("Attached thread #{}", threadCounter);
+
+					auto& options = GetLoadMethodOptions<LoadMethod::OnThreadAttach>();
+					if (options.ThreadNumber == threadCounter)
+					{
+						DisableThreadLibraryCalls(handle);
+						LoadPlugins();
+					}
+
+					KX_SCOPEDLOG.SetSuccess();
+				}
+
+				break;
+			}
+			case DLL_PROCESS_DETACH:
+			{
+				KX_SCOPEDLOG_ARGS(handle, event);
+
+				// Non-null if the process is terminating rather than this library being unloaded
+				m_IsProcessTerminating = reserved != nullptr;
+				PreloadHandler::DestroyInstance();
+
+				KX_SCOPEDLOG.SetSuccess();
+				break;
+			}
+		};
+
+		return true;
+	}
+	bool PreloadHandler::DisableThreadLibraryCalls(HMODULE handle)
+	{
+		KX_SCOPEDLOG_ARGS(handle);
+
+		m_WatchThreadAttach = false;
+		if (::DisableThreadLibraryCalls(handle))
+		{
+			KX_SCOPEDLOG.SetSuccess();
+			return true;
+		}
+		else
+		{
+			KX_SCOPEDLOG.Error() << kxf::Win32Error::GetLastError();
+			return false;
+		}
+	}
+
+	bool PreloadHandler::HookImportTable()
+	{
+		KX_SCOPEDLOG_FUNC;
+		using namespace PluginPreloader;
+
+		auto traceScope = TraceScope("HookImportTable", "Hook");
+
+		if (!m_PluginsLoadAllowed)
+		{
+			KX_SCOPEDLOG.Info().Format("Plugins preload disabled for this process, skipping hook installation");
+			KX_SCOPEDLOG.LogReturn(false);
+
+			return false;
+		}
+
+		if (m_HookDelay.IsPositive())
+		{
+			KX_SCOPEDLOG.Info().Format("Hooking is delayed by '{}' ms, waiting...", m_HookDelay.GetMilliseconds());
+			::Sleep(m_HookDelay.GetMilliseconds());
+			KX_SCOPEDLOG.Info().Format("Wait time is out, continuing hooking");
+		}
+
+		KX_SCOPEDLOG.Info().Format("Hooking function '{}' from library '{}' with signature '{}'", m_ImportAddressHook.FunctionName, m_ImportAddressHook.LibraryName, m_ImportAddressHook.Signature);
+		m_ImportAddressHook.SaveOriginal(Detour::FunctionIAT(m_ImportAddressHook.GetHookFunction(), m_ImportAddressHook.LibraryName.nc_str(), m_ImportAddressHook.FunctionName.nc_str()));
+
+		if (m_ImportAddressHook.IsHooked())
+		{
+			KX_SCOPEDLOG.Info().Format("Success [Hooked={:#0{}x}], [Original={:#0{}x}]",
+									   reinterpret_cast<size_t>(m_ImportAddressHook.GetHookFunction()), sizeof(void*),
+									   reinterpret_cast<size_t>(m_ImportAddressHook.GetOriginal()), sizeof(void*)
+			);
+			KX_SCOPEDLOG.LogReturn(true);
+
+			return true;
+		}
+		else
+		{
+			KX_SCOPEDLOG.Error().Format("Unable to hook import table function");
+			KX_SCOPEDLOG.LogReturn(false, false);
+
+			return false;
+		}
+	}
+	bool PreloadHandler::UnhookImportTable()
+	{
+		KX_SCOPEDLOG_FUNC;
+		using namespace PluginPreloader;
+
+		// Put the original function back only if the entry still points to our hook, a plugin could have hooked it while loading
+		Detour::IATPatch patch;
+		patch.LibraryName = m_ImportAddressHook.LibraryName.nc_str();
+		patch.FunctionName = m_ImportAddressHook.FunctionName.nc_str();
+		patch.Function = m_ImportAddressHook.GetOriginal();
+		patch.Expected = m_ImportAddressHook.GetHookFunction();
+
+		if (Detour::PatchIAT(nullptr, patch))
+		{
+			m_ImportAddressHook.SetRestored();
+
+			KX_SCOPEDLOG.Info().Format("Import table entry of '{}' from library '{}' is restored", m_ImportAddressHook.FunctionName, m_ImportAddressHook.LibraryName);
+			KX_SCOPEDLOG.LogReturn(true);
+			return true;
+		}
+		else if (void* previous = patch.Original)
+		{
+			// Some plugin has hooked the same entry while loading, its hook is left in place and the calls are passed through instead
+			KX_SCOPEDLOG.Warning().Format("Import table entry of '{}' was replaced by someone else [{:#0{}x}], the hook will stay as a passthrough", m_ImportAddressHook.FunctionName, reinterpret_cast<size_t>(previous), sizeof(void*));
+		}
+		else
+		{
+			KX_SCOPEDLOG.Error().Format("Unable to restore import table entry, the hook will stay as a passthrough");
+		}
+
+		KX_SCOPEDLOG.LogReturn(false, false);
+		return false;
+	}
+	bool PreloadHandler::WatchModuleLoad()
+	{
+		KX_SCOPEDLOG_FUNC;
+
+		auto traceScope = TraceScope("WatchModuleLoad", "Hook");
+
+		if (!m_PluginsLoadAllowed)
+		{
+			KX_SCOPEDLOG.Info().Format("Plugins preload disabled for this process, skipping module load watch");
+			KX_SCOPEDLOG.LogReturn(false);
+
+			return false;
+		}
+
+		// The module can be loaded before this library, in which case there's nothing to wait for
+		if (auto name = FindLoadedModule(m_OnModuleLoad.ModuleNames))
+		{
+			KX_SCOPEDLOG.Info().Format("Module '{}' is already loaded", *name);
+			LoadPlugins();
+
+			KX_SCOPEDLOG.LogReturn(true);
+			return true;
+		}
+
+		// The load notification is delivered under the loader lock and before the module's 'DllMain' has run,
+		// so the plugins are loaded from a pool thread which can only proceed once the loader is done with it.
+		m_ModuleLoadWork = ::CreateThreadpoolWork([](PTP_CALLBACK_INSTANCE, void* context, PTP_WORK)
+		{
+			auto& handler = *static_cast<PreloadHandler*>(context);
+			if (handler.EnterPoolCallback())
+			{
+				kxf::Utility::ScopeGuard atExit = [&]()
+				{
+					handler.LeavePoolCallback();
+				};
+				handler.LoadPlugins();
+			}
+		}, this, nullptr);
+		if (!m_ModuleLoadWork)
+		{
+			KX_SCOPEDLOG.Error().Format("Unable to create the plugins loading work item: {}", kxf::Win32Error::GetLastError());
+			KX_SCOPEDLOG.LogReturn(false);
+
+			return false;
+		}
+
+		m_Application->Bind(kxf::DynamicLibraryEvent::EvtLoaded, [this](kxf::DynamicLibraryEvent& event)
+		{
+			if (!m_PluginsLoadStarted && !m_ModuleLoadQueued)
+			{
+				const kxf::String name = event.GetBaseName().GetName();
+				if (MatchesModuleName(m_OnModuleLoad.ModuleNames, name) && !m_ModuleLoadQueued.exchange(true))
 				{
-					break;
+					kxf::Log::Info("Module '{}' loaded, queuing plugins loading", name);
+
+					StopWatchingModuleLoad();
+					::SubmitThreadpoolWork(m_ModuleLoadWork);
 				}
+			}
+		}, kxf::BindEventFlag::AlwaysSkip);
 
-				if (*m_LoadMethod == LoadMethod::OnThreadAttach)
+		if (m_OnModuleLoad.Timeout.IsPositive())
+		{
+			// Pool threads don't start until the loader lock is released, so the timer can be set from 'DllMain'
+			m_ModuleLoadTimer = ::CreateThreadpoolTimer([](PTP_CALLBACK_INSTANCE, void* context, PTP_TIMER)
+			{
+				auto& handler = *static_cast<PreloadHandler*>(context);
+				if (handler.EnterPoolCallback())
 				{
-					KX_SCOPEDLOG_ARGS(handle, event);
-
-					const size_t threadCounter = ++m_ThreadAttachCount;
-					kxf::Log::Info("Attached thread #{}", threadCounter);
-
-					auto& options = GetLoadMethodOptions<LoadMethod::OnThreadAttach>();
-					if (options.ThreadNumber == threadCounter)
+					kxf::Utility::ScopeGuard atExit = [&]()
 					{
-						DisableThreadLibraryCalls(handle);
-						LoadPlugins();
+						handler.LeavePoolCallback();
+					};
+					if (!handler.m_PluginsLoadStarted)
+					{
+						kxf::Log::Warning("None of the watched modules was loaded in {} ms, loading plugins anyway", handler.m_OnModuleLoad.Timeout.GetMilliseconds());
+						handler.LoadPlugins();
 					}
-
-					KX_SCOPEDLOG.SetSuccess();
 				}
+			}, this, nullptr);
 
-				break;
+			if (m_ModuleLoadTimer)
+			{
+				// Negative due time is relative, in 100 ns units
+				ULARGE_INTEGER dueTime = {};
+				dueTime.QuadPart = static_cast<ULONGLONG>(-m_OnModuleLoad.Timeout.GetMilliseconds() * 10000);
+
+				FILETIME fileTime = {};
+				fileTime.dwLowDateTime = dueTime.LowPart;
+				fileTime.dwHighDateTime = dueTime.HighPart;
+				::SetThreadpoolTimer(m_ModuleLoadTimer, &fileTime, 0, 0);
 			}
-			case DLL_PROCESS_DETACH:
+			else
 			{
-				KX_SCOPEDLOG_ARGS(handle, event);
-
-				PreloadHandler::DestroyInstance();
-
-				KX_SCOPEDLOG.SetSuccess();
-				break;
+				KX_SCOPEDLOG.Error().Format("Unable to create the timeout timer: {}", kxf::Win32Error::GetLastError());
 			}
-		};
+		}
 
+		KX_SCOPEDLOG.Info().Format("Waiting for any of the modules to load, timeout: {} ms", m_OnModuleLoad.Timeout.GetMilliseconds());
+		KX_SCOPEDLOG.LogReturn(true);
 		return true;
 	}
-	bool PreloadHandler::DisableThreadLibraryCalls(HMODULE handle)
+	void PreloadHandler::StopWatchingModuleLoad()
 	{
-		KX_SCOPEDLOG_ARGS(handle);
-
-		m_WatchThreadAttach = false;
-		if (::DisableThreadLibraryCalls(handle))
+		if (m_ModuleLoadTimer)
 		{
-			KX_SCOPEDLOG.SetSuccess();
-			return true;
+			// Doesn't wait for a callback which is already running, 'LoadPlugins' lets only one of them through anyway
+			::SetThreadpoolTimer(m_ModuleLoadTimer, nullptr, 0, 0);
 		}
-		else
+	}
+	bool PreloadHandler::EnterPoolCallback() noexcept
+	{
+		// Counted before checking the flag, so 'StopPoolCallbacks' either sees this callback running or it sees the flag
+		m_PoolCallbackCount.fetch_add(1, std::memory_order_seq_cst);
+		if (m_PoolCallbacksStopped.load(std::memory_order_seq_cst))
 		{
-			KX_SCOPEDLOG.Error() << kxf::Win32Error::GetLastError();
+			m_PoolCallbackCount.fetch_sub(1, std::memory_order_release);
 			return false;
 		}
+		return true;
 	}
-
-	bool PreloadHandler::HookImportTable()
+	void PreloadHandler::LeavePoolCallback() noexcept
 	{
-		KX_SCOPEDLOG_FUNC;
-		using namespace PluginPreloader;
-
-		if (!m_PluginsLoadAllowed)
+		m_PoolCallbackCount.fetch_sub(1, std::memory_order_release);
+	}
+	void PreloadHandler::StopPoolCallbacks()
+	{
+		// No more timer callbacks are queued, and the ones which start anyway return right away
+		StopWatchingModuleLoad();
+		if (m_ExceptionSummaryTimer)
 		{
-			KX_SCOPEDLOG.Info().Format("Plugins preload disabled for this process, skipping hook installation");
-			KX_SCOPEDLOG.LogReturn(false);
-
-			return false;
+			::SetThreadpoolTimer(m_ExceptionSummaryTimer, nullptr, 0, 0);
 		}
+		m_PoolCallbacksStopped.store(true, std::memory_order_seq_cst);
 
-		if (m_HookDelay.IsPositive())
+		// The pool threads are already gone if the process is terminating, there's nothing to wait for
+		if (m_IsProcessTerminating)
 		{
-			KX_SCOPEDLOG.Info().Format("Hooking is delayed by '{}' ms, waiting...", m_HookDelay.GetMilliseconds());
-			::Sleep(m_HookDelay.GetMilliseconds());
-			KX_SCOPEDLOG.Info().Format("Wait time is out, continuing hooking");
+			return;
 		}
 
-		KX_SCOPEDLOG.Info().Format("Hooking function '{}' from library '{}'", m_ImportAddressHook.FunctionName, m_ImportAddressHook.LibraryName);
-		m_ImportAddressHook.SaveOriginal(Detour::FunctionIAT(&ImportAddressHookHandler::HookFunc, m_ImportAddressHook.LibraryName.nc_str(), m_ImportAddressHook.FunctionName.nc_str()));
-
-		if (m_ImportAddressHook.IsHooked())
+		// This runs under the loader lock, and a running callback can be inside 'LoadLibrary' or waiting for something which needs
+		// the loader lock, waiting for it would deadlock. The pool objects are left alone then, the library is unloaded anyway.
+		if (m_PoolCallbackCount.load(std::memory_order_seq_cst) != 0)
 		{
-			KX_SCOPEDLOG.Info().Format("Success [Hooked={:#0{}x}], [Original={:#0{}x}]",
-									   reinterpret_cast<size_t>(&ImportAddressHookHandler::HookFunc), sizeof(void*),
-									   reinterpret_cast<size_t>(m_ImportAddressHook.GetOriginal()), sizeof(void*)
-			);
-			KX_SCOPEDLOG.LogReturn(true);
+			kxf::Log::Warning("A thread pool callback is still running, not waiting for it while unloading");
+			return;
+		}
 
-			return true;
+		// Whatever starts from now on returns without doing anything, so waiting only cancels the queued callbacks
+		if (m_ModuleLoadTimer)
+		{
+			::WaitForThreadpoolTimerCallbacks(m_ModuleLoadTimer, TRUE);
+			::CloseThreadpoolTimer(m_ModuleLoadTimer);
+			m_ModuleLoadTimer = nullptr;
 		}
-		else
+		if (m_ModuleLoadWork)
 		{
-			KX_SCOPEDLOG.Error().Format("Unable to hook import table function");
-			KX_SCOPEDLOG.LogReturn(false, false);
-
-			return false;
+			::WaitForThreadpoolWorkCallbacks(m_ModuleLoadWork, TRUE);
+			::CloseThreadpoolWork(m_ModuleLoadWork);
+			m_ModuleLoadWork = nullptr;
+		}
+		if (m_ExceptionSummaryTimer)
+		{
+			::WaitForThreadpoolTimerCallbacks(m_ExceptionSummaryTimer, TRUE);
+			::CloseThreadpoolTimer(m_ExceptionSummaryTimer);
+			m_ExceptionSummaryTimer = nullptr;
 		}
 	}
 	bool PreloadHandler::LoadPlugins()
@@ -902,7 +2330,8 @@ namespace xSE
 			return false;
 		}
 
-		if (!m_PluginsLoaded)
+		// Can be called from different threads by some load methods, only the first call does anything
+		if (!m_PluginsLoadStarted.exchange(true))
 		{
 			KX_SCOPEDLOG.Info().Format("Loading plugins");
 			if (m_LoadDelay.IsPositive())
@@ -914,6 +2343,7 @@ namespace xSE
 
 			DoLoadPlugins();
 			m_PluginsLoaded = true;
+			SaveTrace();
 
 			KX_SCOPEDLOG.LogReturn(true);
 			return true;
@@ -924,7 +2354,15 @@ namespace xSE
 	}
 
 	PreloadHandler::PreloadHandler()
+		:m_Trace(::GetCurrentProcessId())
 	{
+		// Tracing is only enabled once the config is loaded, startup spans are recorded from their start times
+		const auto startTime = TraceEventWriter::Clock::now();
+		kxf::Utility::ScopeGuard traceAtExit = [&]()
+		{
+			m_Trace.AddComplete("PreloadHandler", "Startup", startTime, TraceEventWriter::Clock::now(), ::GetCurrentThreadId());
+		};
+
 		m_Application = std::make_shared<Application>(*this);
 		m_InstallFS.SetLookupDirectory(kxf::NativeFileSystem::GetExecutingModuleRootDirectory());
 		m_ConfigFS.SetLookupDirectory(kxf::Shell::GetKnownDirectory(kxf::KnownDirectoryID::Documents) / "My Games" / xSE_CONFIG_FOLDER_NAME_W / xSE_FOLDER_NAME_W);
@@ -942,24 +2380,23 @@ namespace xSE
 				stream = m_InstallFS.OpenToWrite(g_LogFileName, IOStreamDisposition::CreateAlways, IOStreamShare::Read, FSActionFlag::CreateDirectoryTree|FSActionFlag::Recursive);
 			}
 
+			// Log records are written synchronously until the background thread is started, which only happens if this process is allowed to preload
+			if (stream)
+			{
+				auto asyncStream = std::make_unique<AsyncOutputStream>(std::move(stream));
+				m_LogBuffer = asyncStream->GetBuffer();
+
+				stream = std::move(asyncStream);
+			}
+
 			kxf::ScopedLoggerGlobalContext::Initialize(std::make_shared<kxf::ScopedLoggerSingleFileContext>(std::move(stream)));
 		}
 
 		KX_SCOPEDLOG_FUNC;
 		KX_SCOPEDLOG.Info() KX_SCOPEDLOG_VALUE_AS(m_ExecutablePath, m_ExecutablePath.GetFullPath());
 
-		// Init framework
-		if (!m_Application->OnCreate() || !InitializeFramework())
-		{
-			kxf::Log::Info("Error occurred during the initialization process");
-			return;
-		}
-		LogCurrentModuleInfo();
-		auto hostResourceInfo = LogHostProcessInfo();
-		auto extenderResourceInfo = LogScriptExtenderInfo(hostResourceInfo);
-		LogEnvironmentInfo();
-
 		// Load config
+		const auto configStartTime = TraceEventWriter::Clock::now();
 		kxf::Log::Info("Loading configuration from '{}'", m_InstallFS.ResolvePath(g_ConfigFileName).GetFullPath());
 		if (auto readStream = m_InstallFS.OpenToRead(g_ConfigFileName); readStream && m_Config.Load(*readStream))
 		{
@@ -1001,6 +2438,16 @@ namespace xSE
 			}
 		}
 
+		m_WriteTrace = [&]()
+		{
+			return m_Config.QueryElement("xSE/PluginPreloader/WriteTrace").GetValueBool(false);
+		}();
+		if (m_WriteTrace)
+		{
+			m_Trace.Enable();
+			m_Trace.SetThreadName(::GetCurrentThreadId(), "Main");
+		}
+
 		m_OriginalLibraryPath = [&]()
 		{
 			kxf::String path = m_Config.QueryElement("xSE/PluginPreloader/OriginalLibrary").GetValue();
@@ -1014,6 +2461,91 @@ namespace xSE
 			}
 			return path;
 		}();
+		m_LazyBinding = [&]()
+		{
+			return m_Config.QueryElement("xSE/PluginPreloader/LazyBinding").GetValueBool(false);
+		}();
+		m_InstrumentExports = [&]()
+		{
+			return m_Config.QueryElement("xSE/PluginPreloader/ExportCallStatistics/Enabled").GetValueBool(false);
+		}();
+		m_ExportSampleInterval = [&]()
+		{
+			auto value = m_Config.QueryElement("xSE/PluginPreloader/ExportCallStatistics/SampleInterval").GetValueInt(64);
+			return value > 0 ? static_cast<size_t>(value) : 1;
+		}();
+
+		m_AllowedProcessNames = [&]()
+		{
+			std::vector<kxf::String> processes;
+			for (const kxf::XMLNode& itemNode: m_Config.QueryElement("xSE/PluginPreloader/Processes").EnumChildElements("Item"))
+			{
+				if (itemNode.GetAttributeBool("Allow"))
+				{
+					if (processes.emplace_back(itemNode.GetAttribute("Name")).IsEmpty())
+					{
+						processes.pop_back();
+					}
+				}
+			}
+			return processes;
+		}();
+		m_Trace.AddComplete("LoadConfig", "Startup", configStartTime, TraceEventWriter::Clock::now(), ::GetCurrentThreadId());
+
+		auto LoadOriginalLibraryAndFunctions = [&]()
+		{
+			LoadOriginalLibrary();
+			if (m_OriginalLibrary)
+			{
+				LoadOriginalLibraryFunctions();
+			}
+			else
+			{
+				KX_SCOPEDLOG.Critical().Format("Can't load original library, terminating");
+			}
+		};
+		auto LogStartupTime = [&]()
+		{
+			KX_SCOPEDLOG.Info().Format("Startup time: {:.3f} ms", ToMilliseconds(std::chrono::steady_clock::now() - startTime));
+		};
+
+		// Check processes before doing anything else. If we are not allowed to preload inside this process set the flag
+		// and don't load plugins, don't initialize the framework, just load the original library to serve as its proxy.
+		m_PluginsLoadAllowed = CheckAllowedProcesses();
+		if (!m_PluginsLoadAllowed)
+		{
+			KX_SCOPEDLOG.Warning().Format("This process is not allowed to preload plugins: {}", m_ExecutablePath.GetName());
+
+			LoadOriginalLibraryAndFunctions();
+			LogStartupTime();
+
+			KX_SCOPEDLOG.SetSuccess(!m_OriginalLibrary.IsNull());
+			return;
+		}
+
+		m_AsyncLog = [&]()
+		{
+			return m_Config.QueryElement("xSE/PluginPreloader/AsyncLog").GetValueBool(false);
+		}();
+		if (m_LogBuffer && m_AsyncLog)
+		{
+			m_LogBuffer->Start();
+		}
+		else if (!m_AsyncLog)
+		{
+			KX_SCOPEDLOG.Info().Format("Asynchronous logging is disabled, log records are written immediately");
+		}
+
+		// Init framework
+		if (!m_Application->OnCreate() || !InitializeFramework())
+		{
+			kxf::Log::Info("Error occurred during the initialization process");
+			return;
+		}
+		LogCurrentModuleInfo();
+		auto hostResourceInfo = LogHostProcessInfo();
+		auto extenderResourceInfo = LogScriptExtenderInfo(hostResourceInfo);
+		LogEnvironmentInfo();
 
 		m_InstallExceptionHandler = [&]()
 		{
@@ -1023,6 +2555,90 @@ namespace xSE
 		{
 			return m_Config.QueryElement("xSE/PluginPreloader/KeepExceptionHandler").GetValueBool();
 		}();
+		m_ExceptionFilterRules = [&]()
+		{
+			std::vector<ExceptionFilter::Rule> rules;
+			for (const kxf::XMLNode& itemNode: m_Config.QueryElement("xSE/PluginPreloader/ExceptionFilter").EnumChildElements("Item"))
+			{
+				ExceptionFilter::Rule rule;
+
+				// Either a single code or a range
+				auto code = ParseExceptionCode(itemNode.GetAttribute("Code"));
+				auto firstCode = code ? code : ParseExceptionCode(itemNode.GetAttribute("FirstCode"));
+				auto lastCode = code ? code : ParseExceptionCode(itemNode.GetAttribute("LastCode"));
+				if (!firstCode || !lastCode || *firstCode > *lastCode)
+				{
+					KX_SCOPEDLOG.Warning().Format("Exception filter: invalid exception code in the rule #{}, skipping", rules.size() + 1);
+					continue;
+				}
+				rule.FirstCode = *firstCode;
+				rule.LastCode = *lastCode;
+
+				rule.Action = itemNode.GetAttribute("Action") == "Capture" ? ExceptionFilter::FilterAction::Capture : ExceptionFilter::FilterAction::Ignore;
+				rule.RateLimit = static_cast<uint32_t>(std::max<int64_t>(itemNode.GetAttributeInt("RateLimit", 0), 0));
+				const kxf::String moduleName = itemNode.GetAttribute("Module");
+				rule.ModuleName = moduleName.ToUTF8();
+
+				kxf::String description = code ? kxf::Format("{:#010x}", *code) : kxf::Format("{:#010x}-{:#010x}", rule.FirstCode, rule.LastCode);
+				if (!moduleName.IsEmpty())
+				{
+					description += kxf::Format(" in '{}'", moduleName);
+				}
+				rule.Description = description.ToUTF8();
+
+				rules.emplace_back(std::move(rule));
+			}
+
+			if (rules.empty())
+			{
+				rules = GetDefaultExceptionFilterRules();
+			}
+			return rules;
+		}();
+		m_AggregateExceptions = [&]()
+		{
+			return m_Config.QueryElement("xSE/PluginPreloader/ExceptionStatistics/Enabled").GetValueBool(false);
+		}();
+		m_ExceptionTableSize = [&]()
+		{
+			auto value = m_Config.QueryElement("xSE/PluginPreloader/ExceptionStatistics/TableSize").GetValueInt(ExceptionStatistics::DefaultTableSize);
+			return value > 0 ? static_cast<size_t>(value) : ExceptionStatistics::DefaultTableSize;
+		}();
+		m_ExceptionSummaryInterval = [&]()
+		{
+			return kxf::TimeSpan::Milliseconds(m_Config.QueryElement("xSE/PluginPreloader/ExceptionStatistics/SummaryInterval").GetValueInt(600000));
+		}();
+		m_WriteMinidump = [&]()
+		{
+			return m_Config.QueryElement("xSE/PluginPreloader/Minidump/Enabled").GetValueBool(false);
+		}();
+		m_MinidumpOptions = [&]()
+		{
+			MinidumpWriter::Options options;
+
+			const kxf::String typeName = m_Config.QueryElement("xSE/PluginPreloader/Minidump/Type").GetValue("WithIndirectlyReferencedMemory|WithThreadInfo|WithUnloadedModules");
+			if (auto type = ParseMinidumpType(typeName))
+			{
+				options.Type = *type;
+			}
+			else
+			{
+				KX_SCOPEDLOG.Warning().Format("Invalid minidump type '{}', using 'Normal'", typeName);
+			}
+
+			options.MaxSize = static_cast<uint64_t>(std::max<int64_t>(m_Config.QueryElement("xSE/PluginPreloader/Minidump/MaxSize").GetValueInt(256), 0)) * 1024 * 1024;
+			options.MaxCount = static_cast<size_t>(std::max<int64_t>(m_Config.QueryElement("xSE/PluginPreloader/Minidump/MaxCount").GetValueInt(1), 0));
+			return options;
+		}();
+		m_UseScanIndex = [&]()
+		{
+			return m_Config.QueryElement("xSE/PluginPreloader/UseScanIndex").GetValueBool(true);
+		}();
+		m_ProbeThreadCount = [&]()
+		{
+			auto value = m_Config.QueryElement("xSE/PluginPreloader/ProbeThreadCount").GetValueInt(0);
+			return value > 0 ? static_cast<size_t>(value) : WorkerPool::GetDefaultThreadCount();
+		}();
 
 		m_LoadMethod = [&]() -> decltype(m_LoadMethod)
 		{
@@ -1058,8 +2674,21 @@ namespace xSE
 						m_ImportAddressHook.LibraryName = methodNode.GetFirstChildElement("LibraryName").GetValue();
 						m_ImportAddressHook.FunctionName = methodNode.GetFirstChildElement("FunctionName").GetValue();
 
+						m_ImportAddressHook.Signature = methodNode.GetFirstChildElement("Signature").GetValue();
+						if (m_ImportAddressHook.Signature.IsEmpty())
+						{
+							m_ImportAddressHook.Signature = PluginPreloader::ImportAddressHookHandler::GetDefaultSignature();
+						}
+						m_ImportAddressHook.SetHookFunction(PluginPreloader::ImportAddressHookHandler::GetHookFunction(m_ImportAddressHook.Signature));
+
 						KX_SCOPEDLOG.Info().Format("LibraryName = {}", m_ImportAddressHook.LibraryName);
 						KX_SCOPEDLOG.Info().Format("FunctionName = {}", m_ImportAddressHook.FunctionName);
+						KX_SCOPEDLOG.Info().Format("Signature = {}", m_ImportAddressHook.Signature);
+
+						if (!m_ImportAddressHook.GetHookFunction())
+						{
+							KX_SCOPEDLOG.Critical().Format("Unsupported import address hook signature: '{}'", m_ImportAddressHook.Signature);
+						}
 
 						if (!m_ImportAddressHook.IsNull())
 						{
@@ -1067,6 +2696,26 @@ namespace xSE
 						}
 						break;
 					}
+					case LoadMethod::OnModuleLoad:
+					{
+						for (const kxf::XMLNode& itemNode: methodNode.GetFirstChildElement("Modules").EnumChildElements("Item"))
+						{
+							if (auto name = itemNode.GetAttribute("Name"); !name.IsEmpty())
+							{
+								KX_SCOPEDLOG.Info().Format("Module = {}", name);
+								m_OnModuleLoad.ModuleNames.emplace_back(std::move(name));
+							}
+						}
+						m_OnModuleLoad.Timeout = kxf::TimeSpan::Milliseconds(methodNode.GetFirstChildElement("Timeout").GetValueInt(10000));
+
+						KX_SCOPEDLOG.Info().Format("Timeout = {} ms", m_OnModuleLoad.Timeout.GetMilliseconds());
+
+						if (!m_OnModuleLoad.IsNull())
+						{
+							return *method;
+						}
+						break;
+					}
 				};
 			}
 			else
@@ -1102,39 +2751,9 @@ namespace xSE
 			return kxf::TimeSpan::Milliseconds(m_Config.QueryElement("xSE/PluginPreloader/HookDelay").GetValueInt(0));
 		}();
 
-		m_AllowedProcessNames = [&]()
-		{
-			std::vector<kxf::String> processes;
-			for (const kxf::XMLNode& itemNode: m_Config.QueryElement("xSE/PluginPreloader/Processes").EnumChildElements("Item"))
-			{
-				if (itemNode.GetAttributeBool("Allow"))
-				{
-					if (processes.emplace_back(itemNode.GetAttribute("Name")).IsEmpty())
-					{
-						processes.pop_back();
-					}
-				}
-			}
-			return processes;
-		}();
-
-		// Check processes, if we are not allowed to preload inside this process set the flag and don't load plugins but still load the original library.
-		m_PluginsLoadAllowed = CheckAllowedProcesses();
-		if (!m_PluginsLoadAllowed)
-		{
-			KX_SCOPEDLOG.Warning().Format("This process is not allowed to preload plugins: {}", m_ExecutablePath.GetName());
-		}
-
 		// Load the original library
-		LoadOriginalLibrary();
-		if (m_OriginalLibrary)
-		{
-			LoadOriginalLibraryFunctions();
-		}
-		else
-		{
-			KX_SCOPEDLOG.Critical().Format("Can't load original library, terminating");
-		}
+		LoadOriginalLibraryAndFunctions();
+		LogStartupTime();
 
 		KX_SCOPEDLOG.SetSuccess();
 	}
@@ -1144,10 +2763,38 @@ namespace xSE
 
 		if (m_OriginalLibrary)
 		{
+			if (m_LoadMethod == LoadMethod::ImportAddressHook && m_ImportAddressHook.IsTriggered())
+			{
+				KX_SCOPEDLOG.Info().Format("Import address hook: entry restored: {}, {} calls passed through after the preload",
+										   m_ImportAddressHook.IsRestored(),
+										   m_ImportAddressHook.GetPassthroughCount()
+				);
+			}
+
+			StopPoolCallbacks();
+
 			DoUnloadPlugins();
+			LogExportCallStatistics();
 			UnloadOriginalLibrary();
 		}
 		RemoveVectoredExceptionHandler();
+		m_FatalFlushThread.Stop();
+		LogExceptionFilterStatistics();
+		LogExceptionStatistics();
+		StopMinidumpWriter();
+		SaveTrace();
+
+		if (m_LogBuffer)
+		{
+			if (m_LogBuffer->GetDroppedCount() != 0 || m_LogBuffer->GetTruncatedCount() != 0)
+			{
+				KX_SCOPEDLOG.Warning().Format("Asynchronous log: {} records dropped, {} records truncated", m_LogBuffer->GetDroppedCount(), m_LogBuffer->GetTruncatedCount());
+			}
+			KX_SCOPEDLOG.Info().Format("Asynchronous log: buffer was drained by the writing threads {} times", m_LogBuffer->GetInlineDrainCount());
+
+			// Everything logged after this point is written synchronously
+			m_LogBuffer->Shutdown();
+		}
 		
 		KX_SCOPEDLOG.SetSuccess();
 	}
@@ -1,9 +1,19 @@
 #pragma once
 #include "Common.h"
+#include "AsyncLogBuffer.h"
 #include "VectoredExceptionHandler.h"
+#include "ExceptionCapture.h"
+#include "ExceptionFilter.h"
+#include "ExceptionStatistics.h"
+#include "ModuleRangeIndex.h"
+#include "MinidumpWriter.h"
+#include "PluginScanIndex.h"
+#include "TraceEventWriter.h"
+#include "WatchdogThread.h"
 #include "Utility.h"
 #include <kxf/IO/IStream.h>
 #include <kxf/System/NtStatus.h>
+#include <kxf/System/Win32Error.h>
 #include <kxf/System/DynamicLibrary.h>
 #include <kxf/Threading/ReadWriteLock.h>
 #include <kxf/FileSystem/NativeFileSystem.h>
@@ -33,13 +43,44 @@ namespace xSE
 	{
 		OnProcessAttach,
 		OnThreadAttach,
-		ImportAddressHook
+		ImportAddressHook,
+		OnModuleLoad
 	};
 	enum class InitializationMethod
 	{
 		None,
 		Standard,
-		xSEPluginPreload
+		xSEPluginPreload,
+		Combined
+	};
+
+	struct PluginCandidate final
+	{
+		kxf::FSPath Path;
+		InitializationMethod Method = InitializationMethod::None;
+		PluginProbeResult ProbeResult;
+	};
+	struct PluginTiming final
+	{
+		using Clock = std::chrono::steady_clock;
+
+		kxf::FSPath Path;
+		std::optional<PluginStatus> Status;
+		Clock::duration ProbeTime = {};
+		Clock::duration LoadTime = {};
+		Clock::duration InitializeTime = {};
+
+		Clock::duration GetTotalTime() const noexcept
+		{
+			return ProbeTime + LoadTime + InitializeTime;
+		}
+	};
+	struct DependencyStatus final
+	{
+		kxf::FSPath Path;
+		kxf::Win32Error Error = kxf::Win32Error::Success();
+		bool IsResolved = false;
+		bool IsDiagnosed = false;
 	};
 }
 
@@ -55,36 +96,60 @@ namespace xSE::PluginPreloader
 			size_t ThreadNumber = 0;
 	};
 
-	template<class TSignature>
+	class OnModuleLoad final
+	{
+		public:
+			// Module base names, may contain '*' and '?' wildcards
+			std::vector<kxf::String> ModuleNames;
+
+			// Plugins are loaded anyway once it runs out, zero to wait indefinitely
+			kxf::TimeSpan Timeout;
+
+		public:
+			bool IsNull() const
+			{
+				return ModuleNames.empty();
+			}
+	};
+
+	// The hook function is chosen by the signature name from the set instantiated in 'ImportAddressHookHandler',
+	// the original function is called through the same signature.
 	class ImportAddressHook final
 	{
 		private:
-			TSignature* m_OriginalFunction = nullptr;
+			void* m_OriginalFunction = nullptr;
+			void* m_HookFunction = nullptr;
+			std::atomic<bool> m_IsTriggered = false;
+			std::atomic<size_t> m_PassthroughCount = 0;
+			bool m_IsRestored = false;
 
 		public:
 			kxf::String LibraryName;
 			kxf::String FunctionName;
+			kxf::String Signature;
 
 		public:
 			bool IsNull() const
 			{
-				return LibraryName.IsEmpty() || FunctionName.IsEmpty();
+				return LibraryName.IsEmpty() || FunctionName.IsEmpty() || m_HookFunction == nullptr;
 			}
 
-			template<class... Args, class R = std::invoke_result_t<TSignature, Args...>>
+			template<class TSignature, class... Args, class R = std::invoke_result_t<TSignature, Args...>>
 			R CallOriginal(kxf::NtStatus& status, Args&&... arg)
 			{
 				KX_SCOPEDLOG_FUNC;
 				KX_SCOPEDLOG.Info()
-					KX_SCOPEDLOG_VALUE_AS(m_OriginalFunction, reinterpret_cast<void*>(m_OriginalFunction))
+					KX_SCOPEDLOG_VALUE(m_OriginalFunction)
 					KX_SCOPEDLOG_VALUE(LibraryName)
-					KX_SCOPEDLOG_VALUE(FunctionName);
+					KX_SCOPEDLOG_VALUE(FunctionName)
+					KX_SCOPEDLOG_VALUE(Signature);
 
+				auto originalFunction = GetOriginal<TSignature>();
 				if constexpr(std::is_void_v<R>)
 				{
 					status = Utility::SEHTryExcept([&]()
 					{
-						std::invoke(m_OriginalFunction, std::forward<Args>(arg)...);
+						std::invoke(originalFunction, std::forward<Args>(arg)...);
 					});
 					KX_SCOPEDLOG.SetSuccess(status);
 				}
@@ -93,7 +158,7 @@ namespace xSE::PluginPreloader
 					R result;
 					status = Utility::SEHTryExcept([&]()
 					{
-						result = std::invoke(m_OriginalFunction, std::forward<Args>(arg)...);
+						result = std::invoke(originalFunction, std::forward<Args>(arg)...);
 					});
 
 					KX_SCOPEDLOG.LogReturn(result, status.IsSuccess());
@@ -101,11 +166,16 @@ namespace xSE::PluginPreloader
 				}
 			}
 
+			template<class TSignature> requires(std::is_function_v<TSignature>)
 			TSignature* GetOriginal() const noexcept
+			{
+				return reinterpret_cast<TSignature*>(m_OriginalFunction);
+			}
+			void* GetOriginal() const noexcept
 			{
 				return m_OriginalFunction;
 			}
-			void SaveOriginal(TSignature* func) noexcept
+			void SaveOriginal(void* func) noexcept
 			{
 				m_OriginalFunction = func;
 			}
@@ -113,6 +183,46 @@ namespace xSE::PluginPreloader
 			{
 				return m_OriginalFunction != nullptr;
 			}
+
+			void* GetHookFunction() const noexcept
+			{
+				return m_HookFunction;
+			}
+			void SetHookFunction(void* func) noexcept
+			{
+				m_HookFunction = func;
+			}
+
+			// Set once the plugins are loaded, the calls after that go straight to the original function
+			bool IsTriggered() const noexcept
+			{
+				return m_IsTriggered.load(std::memory_order_acquire);
+			}
+			void SetTriggered() noexcept
+			{
+				m_IsTriggered.store(true, std::memory_order_release);
+			}
+
+			// Whether the import table entry points to the original function again
+			bool IsRestored() const noexcept
+			{
+				return m_IsRestored;
+			}
+			void SetRestored() noexcept
+			{
+				m_IsRestored = true;
+			}
+
+			template<class TSignature, class... Args>
+			decltype(auto) CallPassthrough(Args&&... arg)
+			{
+				m_PassthroughCount.fetch_add(1, std::memory_order_relaxed);
+				return std::invoke(GetOriginal<TSignature>(), std::forward<Args>(arg)...);
+			}
+			size_t GetPassthroughCount() const noexcept
+			{
+				return m_PassthroughCount.load(std::memory_order_relaxed);
+			}
 	};
 	class ImportAddressHookHandler;
 }
@@ -127,6 +237,7 @@ namespace xSE
 		private:
 			static PreloadHandler& CreateInstance();
 			static void DestroyInstance();
+			static LONG WINAPI UnhandledExceptionFilterProc(_EXCEPTION_POINTERS* exceptionInfo);
 
 		public:
 			static kxf::String GetLibraryName();
@@ -136,6 +247,7 @@ namespace xSE
 			static void** GetFunctions() noexcept;
 			static size_t GetFunctionsCount() noexcept;
 			static size_t GetFunctionsEffectiveCount() noexcept;
+			static void* ResolveOriginalFunction(size_t index) noexcept;
 
 		private:
 			// General
@@ -145,30 +257,63 @@ namespace xSE
 			kxf::DynamicLibrary m_OriginalLibrary;
 			std::vector<kxf::DynamicLibrary> m_LoadedLibraries;
 			VectoredExceptionHandler m_VectoredExceptionHandler;
+			ExceptionCapture m_ExceptionCapture;
+			ExceptionFilter m_ExceptionFilter;
+			std::unique_ptr<ExceptionStatistics> m_ExceptionStatistics;
+			MinidumpWriter m_MinidumpWriter;
+			WatchdogThread m_FatalFlushThread;
+			LPTOP_LEVEL_EXCEPTION_FILTER m_PreviousUnhandledExceptionFilter = nullptr;
+			bool m_UnhandledExceptionFilterInstalled = false;
+			ModuleRangeIndex m_ModuleRanges;
+			bool m_ModuleRangesWatched = false;
+			PluginScanIndex m_ScanIndex;
+			std::map<kxf::String, DependencyStatus> m_DependencyCache;
+			std::map<kxf::String, PluginTiming> m_PluginTimings;
+			TraceEventWriter m_Trace;
+			std::shared_ptr<AsyncLogBuffer> m_LogBuffer;
+			TraceEventWriter::Clock::time_point m_ExceptionHandlerInstallTime;
 
 			kxf::FSPath m_ExecutablePath;
 			bool m_PluginsLoaded = false;
+			std::atomic<bool> m_PluginsLoadStarted = false;
 			bool m_PluginsLoadAllowed = false;
 			std::atomic<size_t> m_ThreadAttachCount = 0;
 			bool m_WatchThreadAttach = false;
+			PTP_TIMER m_ModuleLoadTimer = nullptr;
+			PTP_WORK m_ModuleLoadWork = nullptr;
+			std::atomic<bool> m_ModuleLoadQueued = false;
+			PTP_TIMER m_ExceptionSummaryTimer = nullptr;
+			std::atomic<size_t> m_PoolCallbackCount = 0;
+			std::atomic<bool> m_PoolCallbacksStopped = false;
+			bool m_IsProcessTerminating = false;
 
 			// Config
 			kxf::XMLDocument m_Config;
 			kxf::FSPath m_OriginalLibraryPath;
+			bool m_LazyBinding = false;
+			bool m_InstrumentExports = false;
+			size_t m_ExportSampleInterval = 64;
 			kxf::TimeSpan m_HookDelay;
 			kxf::TimeSpan m_LoadDelay;
 			bool m_InstallExceptionHandler = true;
 			bool m_KeepExceptionHandler = false;
+			std::vector<ExceptionFilter::Rule> m_ExceptionFilterRules;
+			bool m_AggregateExceptions = false;
+			size_t m_ExceptionTableSize = ExceptionStatistics::DefaultTableSize;
+			kxf::TimeSpan m_ExceptionSummaryInterval;
+			bool m_WriteMinidump = false;
+			MinidumpWriter::Options m_MinidumpOptions;
+			bool m_UseScanIndex = true;
+			size_t m_ProbeThreadCount = 0;
+			bool m_WriteTrace = false;
+			bool m_AsyncLog = false;
 			std::vector<kxf::String> m_AllowedProcessNames;
 
 			std::optional<LoadMethod> m_LoadMethod;
 			PluginPreloader::OnProcessAttach m_OnProcessAttach;
 			PluginPreloader::OnThreadAttach m_OnThreadAttach;
-			#if xSE_PLATFORM_SKSE64 || xSE_PLATFORM_F4SE
-			PluginPreloader::ImportAddressHook<void*(__cdecl)(void*, void*)> m_ImportAddressHook;
-			#elif xSE_PLATFORM_SKSE || xSE_PLATFORM_NVSE
-			PluginPreloader::ImportAddressHook<char*(__stdcall)()> m_ImportAddressHook;
-			#endif
+			PluginPreloader::OnModuleLoad m_OnModuleLoad;
+			PluginPreloader::ImportAddressHook m_ImportAddressHook;
 
 			std::optional<InitializationMethod> m_InitializationMethod;
 
@@ -177,13 +322,27 @@ namespace xSE
 			kxf::FSPath GetOriginalLibraryDefaultPath() const;
 
 			void DoLoadPlugins();
+			std::vector<PluginCandidate> CollectPlugins(const kxf::FSPath& pluginsDirectory, size_t& itemsScanned);
+			std::vector<size_t> SortPluginsByDependencies(const std::vector<PluginCandidate>& plugins) const;
 			void DoUnloadPlugins();
-			PluginStatus DoLoadSinglePlugin(const kxf::FSPath& path);
+			PluginStatus DoLoadSinglePlugin(const kxf::FSPath& path, InitializationMethod initializationMethod);
+			std::vector<PluginProbeResult> ProbePlugins(const std::vector<kxf::FSPath>& paths);
+			std::optional<PluginProbeResult> DoProbePlugin(const kxf::FSPath& path) const;
+			PluginTiming& GetPluginTiming(const kxf::FSPath& path);
+			void LogPluginTimings(PluginTiming::Clock::duration totalTime) const;
+			void LoadScanIndex();
+			void SaveScanIndex();
 			void OnPluginLoadFailed(const kxf::FSPath& path);
+			TraceEventWriter::Scope TraceScope(std::string_view name, std::string_view category);
+			void SaveTrace();
+			DependencyStatus& ResolveDependency(const kxf::String& moduleName);
+			void DiagnoseDependencies(const kxf::FSPath& path, std::vector<kxf::String>& importChain, size_t& resolvedCount, size_t& unresolvedCount);
 
 			bool CheckAllowedProcesses() const;
 			void LoadOriginalLibrary();
 			void LoadOriginalLibraryFunctions();
+			void BindOriginalFunctions();
+			void LogExportCallStatistics() const;
 			void UnloadOriginalLibrary();
 			void ClearOriginalFunctions();
 
@@ -191,7 +350,20 @@ namespace xSE
 			void RemoveVectoredExceptionHandler();
 			uint32_t OnVectoredContinue(const _EXCEPTION_POINTERS& exceptionInfo);
 			uint32_t OnVectoredException(const _EXCEPTION_POINTERS& exceptionInfo);
-			kxf::String DumpExceptionInformation(const _EXCEPTION_POINTERS& exceptionInfo) const;
+			uint32_t OnUnhandledException(const _EXCEPTION_POINTERS& exceptionInfo);
+			void FlushLog();
+			void StartFatalFlushThread();
+			bool ShouldCaptureException(const EXCEPTION_RECORD& exception) noexcept;
+			void CaptureException(const _EXCEPTION_POINTERS& exceptionInfo) noexcept;
+			void FlushExceptionCaptures();
+			void BuildExceptionFilter();
+			void LogExceptionFilterStatistics() const;
+			void WatchModuleRanges();
+			void StartExceptionStatistics();
+			void LogExceptionStatistics();
+			void StartMinidumpWriter();
+			void StopMinidumpWriter();
+			void UpdatePluginStream(const PluginTiming* loadingPlugin = nullptr);
 
 			bool InitializeFramework();
 			void LogEnvironmentInfo() const;
@@ -199,10 +371,16 @@ namespace xSE
 			kxf::ExecutableVersionResource LogHostProcessInfo() const;
 			kxf::ExecutableVersionResource LogScriptExtenderInfo(const kxf::ExecutableVersionResource& hostResourceInfo) const;
 
-			bool OnDLLMain(HMODULE handle, uint32_t event);
+			bool OnDLLMain(HMODULE handle, uint32_t event, void* reserved);
 			bool DisableThreadLibraryCalls(HMODULE handle);
 
 			bool HookImportTable();
+			bool UnhookImportTable();
+			bool WatchModuleLoad();
+			void StopWatchingModuleLoad();
+			bool EnterPoolCallback() noexcept;
+			void LeavePoolCallback() noexcept;
+			void StopPoolCallbacks();
 			bool LoadPlugins();
 
 		public:
@@ -212,7 +390,8 @@ namespace xSE
 		public:
 			bool IsNull() const
 			{
-				return m_OriginalLibrary.IsNull() || !m_LoadMethod.has_value() || !m_InitializationMethod.has_value();
+				// Load and initialization methods aren't read at all in processes which aren't allowed to preload plugins
+				return m_OriginalLibrary.IsNull() || (m_PluginsLoadAllowed && (!m_LoadMethod.has_value() || !m_InitializationMethod.has_value()));
 			}
 			LoadMethod GetLoadMethod() const
 			{
@@ -243,6 +422,10 @@ namespace xSE
 				{
 					return m_ImportAddressHook;
 				}
+				else if constexpr(method == LoadMethod::OnModuleLoad)
+				{
+					return m_OnModuleLoad;
+				}
 				else
 				{
 					static_assert(sizeof(LoadMethod*) == nullptr);
@@ -0,0 +1,198 @@
+#include "Test.h"
+#include "AsyncLogBuffer.h"
+#include <map>
+#include <string>
+#include <thread>
+
+using namespace xSE;
+using namespace std::chrono_literals;
+
+namespace
+{
+	class RecordingSink final
+	{
+		private:
+			std::mutex m_Lock;
+			std::string m_Output;
+			size_t m_CallCount = 0;
+
+		public:
+			AsyncLogBuffer::Sink MakeSink()
+			{
+				return [this](std::span<const std::byte> data)
+				{
+					std::lock_guard lock(m_Lock);
+					m_Output.append(reinterpret_cast<const char*>(data.data()), data.size());
+					m_CallCount++;
+					return true;
+				};
+			}
+			std::string GetOutput()
+			{
+				std::lock_guard lock(m_Lock);
+				return m_Output;
+			}
+			size_t GetCallCount()
+			{
+				std::lock_guard lock(m_Lock);
+				return m_CallCount;
+			}
+	};
+
+	void Write(AsyncLogBuffer& buffer, std::string_view text)
+	{
+		buffer.Write(std::as_bytes(std::span(text.data(), text.size())));
+	}
+
+	// Lines are '<producer> <sequence> <padding>', checks that every producer's lines are all there, whole and in order
+	bool CheckProducerOrder(std::string_view output, size_t producerCount, size_t messageCount)
+	{
+		std::map<size_t, size_t> nextSequence;
+		size_t lineCount = 0;
+		while (!output.empty())
+		{
+			const size_t end = output.find('\n');
+			if (end == std::string_view::npos)
+			{
+				return false;
+			}
+			const std::string line(output.substr(0, end));
+			output.remove_prefix(end + 1);
+
+			size_t producer = 0;
+			size_t sequence = 0;
+			int padding = 0;
+			if (std::sscanf(line.c_str(), "%zu %zu %n", &producer, &sequence, &padding) != 2 || producer >= producerCount)
+			{
+				return false;
+			}
+			if (sequence != nextSequence[producer]++ || line.find_first_not_of('x', padding) != std::string::npos)
+			{
+				return false;
+			}
+			lineCount++;
+		}
+		return lineCount == producerCount * messageCount;
+	}
+	std::string MakeMessage(size_t producer, size_t sequence)
+	{
+		// Every few messages is longer than a slot, these have to stay contiguous
+		std::string message = std::to_string(producer) + ' ' + std::to_string(sequence) + ' ';
+		message.append(sequence % 7 == 0 ? AsyncLogBuffer::SlotSize * 2 + 13 : sequence % 50, 'x');
+		message += '\n';
+		return message;
+	}
+}
+
+XSE_TEST(SynchronousUntilStarted)
+{
+	RecordingSink sink;
+	AsyncLogBuffer buffer(sink.MakeSink());
+
+	XSE_CHECK(!buffer.IsAsync());
+	Write(buffer, "first\n");
+	Write(buffer, "");
+	Write(buffer, "second\n");
+	XSE_CHECK_EQUAL(sink.GetOutput(), "first\nsecond\n");
+	XSE_CHECK_EQUAL(sink.GetCallCount(), 2u);
+}
+
+XSE_TEST(FlushWritesQueuedMessages)
+{
+	RecordingSink sink;
+	AsyncLogBuffer buffer(sink.MakeSink());
+	XSE_REQUIRE(buffer.Start(1h));
+
+	Write(buffer, "one\n");
+	Write(buffer, "two\n");
+	XSE_CHECK(buffer.Flush());
+	XSE_CHECK_EQUAL(sink.GetOutput(), "one\ntwo\n");
+
+	// Back to the synchronous mode, nothing is lost on the way
+	Write(buffer, "three\n");
+	buffer.Shutdown();
+	XSE_CHECK(!buffer.IsAsync());
+	Write(buffer, "four\n");
+	XSE_CHECK_EQUAL(sink.GetOutput(), "one\ntwo\nthree\nfour\n");
+}
+
+XSE_TEST(SetSinkDrainsIntoOldSink)
+{
+	RecordingSink oldSink;
+	RecordingSink newSink;
+	AsyncLogBuffer buffer(oldSink.MakeSink());
+	XSE_REQUIRE(buffer.Start(1h));
+
+	Write(buffer, "before\n");
+	buffer.SetSink(newSink.MakeSink());
+	Write(buffer, "after\n");
+	buffer.Shutdown();
+
+	XSE_CHECK_EQUAL(oldSink.GetOutput(), "before\n");
+	XSE_CHECK_EQUAL(newSink.GetOutput(), "after\n");
+}
+
+XSE_TEST(OversizedMessagesAreTruncated)
+{
+	RecordingSink sink;
+	AsyncLogBuffer buffer(sink.MakeSink(), 16);
+	XSE_REQUIRE(buffer.Start(1h));
+
+	const std::string message(AsyncLogBuffer::SlotSize * 12, 'x');
+	Write(buffer, message);
+	buffer.Shutdown();
+
+	XSE_CHECK_EQUAL(buffer.GetTruncatedCount(), 1u);
+	XSE_CHECK_EQUAL(sink.GetOutput().size(), AsyncLogBuffer::SlotSize * 8);
+}
+
+XSE_TEST(FullBufferIsDrainedByProducer)
+{
+	// The background thread is asleep for the whole test, so only the producer can make room
+	RecordingSink sink;
+	AsyncLogBuffer buffer(sink.MakeSink(), 16);
+	XSE_REQUIRE(buffer.Start(1h));
+
+	for (size_t i = 0; i < 500; i++)
+	{
+		Write(buffer, MakeMessage(0, i));
+	}
+	buffer.Shutdown();
+
+	XSE_CHECK(buffer.GetInlineDrainCount() > 0);
+	XSE_CHECK_EQUAL(buffer.GetDroppedCount(), 0u);
+	XSE_CHECK(CheckProducerOrder(sink.GetOutput(), 1, 500));
+}
+
+XSE_TEST(ConcurrentProducersKeepOrder)
+{
+	constexpr size_t producerCount = 8;
+	constexpr size_t messageCount = 5000;
+
+	for (size_t slotCount: {16, 2048})
+	{
+		RecordingSink sink;
+		AsyncLogBuffer buffer(sink.MakeSink(), slotCount);
+		XSE_REQUIRE(buffer.Start(1ms));
+
+		std::vector<std::thread> producers;
+		for (size_t i = 0; i < producerCount; i++)
+		{
+			producers.emplace_back([&buffer, i]()
+			{
+				for (size_t j = 0; j < messageCount; j++)
+				{
+					Write(buffer, MakeMessage(i, j));
+				}
+			});
+		}
+		for (std::thread& producer: producers)
+		{
+			producer.join();
+		}
+		buffer.Shutdown();
+
+		XSE_CHECK_EQUAL(buffer.GetDroppedCount(), 0u);
+		XSE_CHECK(CheckProducerOrder(sink.GetOutput(), producerCount, messageCount));
+	}
+}
@@ -0,0 +1,88 @@
+#include "Benchmark.h"
+#include "AsyncLogBuffer.h"
+#include <thread>
+
+// Log writes from several threads at once, with the buffer in the synchronous mode (every message goes to the sink
+// under the lock, which is how the log was written before) and with the background thread running. The sink writes
+// to the null device and flushes each time, so every call costs a system call like a write to the log file does.
+using namespace xSE;
+using Testing::BenchmarkOptions;
+
+namespace
+{
+	struct Result final
+	{
+		double NanosecondsPerMessage = 0;
+		double MaxWriteMicroseconds = 0;
+		size_t SinkCalls = 0;
+	};
+
+	Result RunProducers(bool isAsync, size_t producerCount, size_t messageCount)
+	{
+		#if defined(_WIN32)
+		std::FILE* stream = std::fopen("NUL", "wb");
+		#else
+		std::FILE* stream = std::fopen("/dev/null", "wb");
+		#endif
+
+		std::atomic<size_t> sinkCalls = 0;
+		AsyncLogBuffer buffer([&](std::span<const std::byte> data)
+		{
+			sinkCalls.fetch_add(1, std::memory_order_relaxed);
+			const bool result = std::fwrite(data.data(), 1, data.size(), stream) == data.size();
+			return std::fflush(stream) == 0 && result;
+		});
+		if (isAsync)
+		{
+			buffer.Start();
+		}
+
+		const std::string message = "[2024-01-01 12:00:00.000] [Info] [PreloadHandler::LoadPlugins] Loading 'Plugin.dll'\n";
+		std::vector<std::thread> producers;
+		std::vector<AsyncLogBuffer::Clock::duration> maxWriteTimes(producerCount);
+
+		const auto startTime = AsyncLogBuffer::Clock::now();
+		for (size_t i = 0; i < producerCount; i++)
+		{
+			producers.emplace_back([&, i]()
+			{
+				for (size_t j = 0; j < messageCount; j++)
+				{
+					const auto writeStart = AsyncLogBuffer::Clock::now();
+					buffer.Write(std::as_bytes(std::span(message.data(), message.size())));
+					maxWriteTimes[i] = std::max(maxWriteTimes[i], AsyncLogBuffer::Clock::now() - writeStart);
+				}
+			});
+		}
+		for (std::thread& producer: producers)
+		{
+			producer.join();
+		}
+		buffer.Shutdown();
+		const auto elapsed = AsyncLogBuffer::Clock::now() - startTime;
+		std::fclose(stream);
+
+		Result result;
+		result.NanosecondsPerMessage = std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(producerCount * messageCount);
+		result.MaxWriteMicroseconds = std::chrono::duration<double, std::micro>(*std::ranges::max_element(maxWriteTimes)).count();
+		result.SinkCalls = sinkCalls;
+		return result;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options(argc, argv);
+	const size_t messageCount = options.Scale(100000);
+
+	std::printf("%-12s %-6s %16s %18s %12s\n", "mode", "threads", "ns/message", "max write, us", "sink calls");
+	for (size_t producerCount: {1, 2, 4, 8})
+	{
+		for (bool isAsync: {false, true})
+		{
+			const Result result = RunProducers(isAsync, producerCount, messageCount);
+			std::printf("%-12s %-6zu %16.1f %18.1f %12zu\n", isAsync ? "async" : "synchronous", producerCount, result.NanosecondsPerMessage, result.MaxWriteMicroseconds, result.SinkCalls);
+		}
+	}
+	return 0;
+}
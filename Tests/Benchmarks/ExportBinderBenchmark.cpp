@@ -0,0 +1,114 @@
+#include "Benchmark.h"
+#include "ImageBuilder.h"
+#include "ExportManifest.h"
+#include "ExportBinder.h"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+// Bind time of the original library exports: one pass of 'ExportBinder' against a name lookup per export, which is
+// what resolving them one by one through the loader amounts to. The libraries are built from the export manifests.
+// Real DLLs can be given on the command line, the manifest is picked by the file name ('WinHTTP.dll' -> 'WinHTTP').
+using namespace xSE;
+using Testing::BenchmarkOptions;
+using Testing::ImageBuilder;
+
+namespace
+{
+	constexpr std::string_view g_ManifestNames[] = {"WinHTTP", "WinMM", "DInput8", "IpHlpAPI", "X3DAudio17", "bink2w64"};
+
+	void MeasureBind(const BenchmarkOptions& options, std::string_view label, std::span<const std::byte> data, PE::Layout layout, const std::vector<std::string>& names)
+	{
+		std::vector<PE::ExportBindRequest> requests;
+		for (size_t i = 0; i < names.size(); i++)
+		{
+			requests.push_back({names[i], static_cast<uint32_t>(i + 1)});
+		}
+		std::vector<uint32_t> rvas(requests.size());
+		const size_t iterations = options.Scale(20000);
+
+		PE::ExportBindStatistics statistics;
+		const double bindTime = Testing::MeasureNanoseconds(iterations, [&](size_t)
+		{
+			PE::ImageReader image(data, layout);
+			statistics = PE::ExportBinder(image).Bind(requests, rvas);
+			Testing::DoNotOptimize(rvas.data());
+		});
+		const double lookupTime = Testing::MeasureNanoseconds(iterations, [&](size_t)
+		{
+			PE::ImageReader image(data, layout);
+			for (size_t i = 0; i < requests.size(); i++)
+			{
+				const auto entry = image.FindExport(requests[i].Name);
+				rvas[i] = entry ? entry->RVA : 0;
+			}
+			Testing::DoNotOptimize(rvas.data());
+		});
+
+		std::printf("%.*s: %zu exports, %zu by ordinal, %zu by name, %zu forwarded, %zu unresolved\n", static_cast<int>(label.size()), label.data(), requests.size(), statistics.ByOrdinal, statistics.ByName, statistics.Forwarded, statistics.Unresolved);
+		std::printf("  %-54s %12.2f us/library\n", "one pass bind", bindTime / 1000.0);
+		std::printf("  %-54s %12.2f us/library\n", "name lookup per export", lookupTime / 1000.0);
+	}
+
+	std::vector<std::byte> ReadFile(const std::filesystem::path& path)
+	{
+		std::ifstream stream(path, std::ios::binary);
+		std::vector<char> buffer((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+		std::vector<std::byte> data(buffer.size());
+		std::memcpy(data.data(), buffer.data(), buffer.size());
+		return data;
+	}
+	std::string ToLower(std::string value)
+	{
+		for (char& c: value)
+		{
+			c = c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+		}
+		return value;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options(argc, argv);
+
+	for (std::string_view libraryName: {"WinHTTP", "WinMM"})
+	{
+		const auto names = Testing::ReadExportManifest(libraryName);
+		const bool is64Bit = libraryName == "WinHTTP";
+
+		ImageBuilder builder(is64Bit);
+		for (const std::string& name: names)
+		{
+			builder.AddExport(name);
+		}
+		MeasureBind(options, std::string(libraryName) + " (synthetic)", builder.Build(PE::Layout::Image), PE::Layout::Image, names);
+
+		// Same library from another build, with the ordinals moved by a new export near the start
+		ImageBuilder shiftedBuilder(is64Bit);
+		shiftedBuilder.AddExport("NewExportInThisBuild");
+		for (const std::string& name: names)
+		{
+			shiftedBuilder.AddExport(name);
+		}
+		MeasureBind(options, std::string(libraryName) + " (synthetic, shifted ordinals)", shiftedBuilder.Build(PE::Layout::Image), PE::Layout::Image, names);
+	}
+
+	for (const std::string& path: options.Arguments)
+	{
+		const std::string stem = ToLower(std::filesystem::path(path).stem().string());
+		const auto it = std::ranges::find_if(g_ManifestNames, [&](std::string_view name)
+		{
+			return ToLower(std::string(name)) == stem;
+		});
+		if (it == std::end(g_ManifestNames))
+		{
+			std::printf("%s: no export manifest for this library, skipped\n", path.c_str());
+			continue;
+		}
+
+		MeasureBind(options, path, ReadFile(path), PE::Layout::File, Testing::ReadExportManifest(*it));
+	}
+	return 0;
+}
@@ -0,0 +1,99 @@
+#include "Benchmark.h"
+#include "ImageBuilder.h"
+#include "ImportIndex.h"
+#include <random>
+
+// Finding import address table slots for a batch of hooks in executables with large import tables: building the index once
+// and looking every hook up in it, against a walk over the import directory per hook, which is what patching did before.
+using namespace xSE;
+using Testing::BenchmarkOptions;
+using Testing::ImageBuilder;
+
+namespace
+{
+	constexpr size_t g_HookCount = 64;
+
+	struct Hook final
+	{
+		std::string ModuleName;
+		std::string FunctionName;
+	};
+
+	std::optional<uint32_t> FindSlotLinear(const PE::ImageReader& image, std::string_view moduleName, std::string_view functionName)
+	{
+		std::optional<uint32_t> result;
+		image.EnumImports([&](const PE::ImportEntry& entry)
+		{
+			if (entry.Name == functionName && entry.ModuleName.size() == moduleName.size() && std::ranges::equal(entry.ModuleName, moduleName, [](char a, char b)
+			{
+				return (a | 0x20) == (b | 0x20);
+			}))
+			{
+				result = entry.SlotRVA;
+				return false;
+			}
+			return true;
+		});
+		return result;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options(argc, argv);
+	std::mt19937 random(7);
+
+	const std::pair<size_t, size_t> sizes[] = {{8, 50}, {32, 200}, {64, 1000}, {128, 2000}};
+	for (const auto& [moduleCount, functionCount]: sizes)
+	{
+		ImageBuilder builder;
+		std::vector<Hook> hooks;
+		for (size_t i = 0; i < moduleCount; i++)
+		{
+			ImageBuilder::Import import;
+			import.ModuleName = "Module" + std::to_string(i) + ".dll";
+			for (size_t j = 0; j < functionCount; j++)
+			{
+				import.Names.push_back("ImportedFunction" + std::to_string(j));
+			}
+			builder.AddImport(std::move(import));
+		}
+
+		// Hooks are spread over the whole table, a few of them for functions which aren't imported
+		for (size_t i = 0; i < g_HookCount; i++)
+		{
+			const size_t module = random() % moduleCount;
+			const size_t function = random() % (functionCount + functionCount / 16);
+			hooks.push_back({"MODULE" + std::to_string(module) + ".DLL", "ImportedFunction" + std::to_string(function)});
+		}
+
+		const auto data = builder.Build(PE::Layout::Image);
+		const PE::ImageReader image(data, PE::Layout::Image);
+		const size_t iterations = options.Scale(std::max<size_t>(100000 / (moduleCount * functionCount), 20));
+
+		const double buildTime = Testing::MeasureNanoseconds(iterations, [&](size_t)
+		{
+			Testing::DoNotOptimize(PE::ImportIndex(image).GetEntryCount());
+		});
+		const PE::ImportIndex index(image);
+		const double lookupTime = Testing::MeasureNanoseconds(iterations * 100, [&](size_t i)
+		{
+			const Hook& hook = hooks[i % hooks.size()];
+			Testing::DoNotOptimize(index.FindSlot(hook.ModuleName, hook.FunctionName));
+		});
+		const double linearTime = Testing::MeasureNanoseconds(iterations, [&](size_t)
+		{
+			for (const Hook& hook: hooks)
+			{
+				Testing::DoNotOptimize(FindSlotLinear(image, hook.ModuleName, hook.FunctionName));
+			}
+		});
+
+		std::printf("%zu modules x %zu functions, %zu hooks\n", moduleCount, functionCount, hooks.size());
+		Testing::PrintResult("  build the index", buildTime, "image");
+		Testing::PrintResult("  index lookup", lookupTime, "hook");
+		Testing::PrintResult("  index build and lookups for all hooks", buildTime + lookupTime * static_cast<double>(hooks.size()), "batch");
+		Testing::PrintResult("  import directory walk for all hooks", linearTime, "batch");
+	}
+	return 0;
+}
@@ -0,0 +1,95 @@
+#include "Benchmark.h"
+#include "ModuleRangeIndex.h"
+#include <random>
+
+// Cost of attributing an address to a module with thousands of modules loaded: the index lookup against a linear scan
+// over the module list, for addresses inside the modules and between them. Also the cost of publishing a new snapshot
+// when a module is loaded, which is paid on every load event.
+using namespace xSE;
+using Testing::BenchmarkOptions;
+
+namespace
+{
+	std::vector<ModuleRange> MakeModules(size_t count, std::mt19937_64& random)
+	{
+		std::vector<ModuleRange> modules;
+		uint64_t address = 0x7FF000000000;
+		for (size_t i = 0; i < count; i++)
+		{
+			// Modules of 64 KB to 16 MB with gaps between them, like the address space of a heavily modded game
+			const uint64_t size = (1 + random() % 256) * 0x10000;
+			modules.push_back({address, address + size, "Plugin" + std::to_string(i) + ".dll"});
+			address += size + (random() % 16) * 0x10000;
+		}
+		return modules;
+	}
+
+	const ModuleRange* FindLinear(const std::vector<ModuleRange>& modules, uint64_t address) noexcept
+	{
+		for (const ModuleRange& module: modules)
+		{
+			if (module.Contains(address))
+			{
+				return &module;
+			}
+		}
+		return nullptr;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options(argc, argv);
+	std::mt19937_64 random(23);
+
+	for (size_t moduleCount: {10, 100, 1000, 5000, 10000})
+	{
+		const auto modules = MakeModules(moduleCount, random);
+		ModuleRangeIndex index;
+		index.Reset(modules);
+
+		// Half the addresses are in the modules, the rest anywhere in the covered range
+		std::vector<uint64_t> addresses(4096);
+		for (size_t i = 0; i < addresses.size(); i++)
+		{
+			if (i % 2 == 0)
+			{
+				const ModuleRange& module = modules[random() % modules.size()];
+				addresses[i] = module.Begin + random() % (module.End - module.Begin);
+			}
+			else
+			{
+				addresses[i] = modules.front().Begin + random() % (modules.back().End - modules.front().Begin);
+			}
+		}
+
+		const size_t iterations = options.Scale(1000000);
+		const double indexTime = Testing::MeasureNanoseconds(iterations, [&](size_t i)
+		{
+			uint64_t offset = 0;
+			index.Find(addresses[i % addresses.size()], [&](const ModuleRange& module) noexcept
+			{
+				offset = addresses[i % addresses.size()] - module.Begin;
+			});
+			Testing::DoNotOptimize(offset);
+		});
+		const double linearTime = Testing::MeasureNanoseconds(std::max<size_t>(iterations / moduleCount, 100), [&](size_t i)
+		{
+			Testing::DoNotOptimize(FindLinear(modules, addresses[i % addresses.size()]));
+		});
+
+		// Loading a module and unloading it again, two snapshots rebuilt
+		const ModuleRange extra = {modules.back().End + 0x100000, modules.back().End + 0x200000, "Extra.dll"};
+		const double changeTime = Testing::MeasureNanoseconds(std::max<size_t>(options.Scale(100000) / moduleCount, 10), [&](size_t)
+		{
+			index.Add(extra);
+			index.Remove(extra.Begin);
+		});
+
+		std::printf("%zu modules\n", moduleCount);
+		Testing::PrintResult("  index lookup", indexTime, "lookup");
+		Testing::PrintResult("  linear scan", linearTime, "lookup");
+		Testing::PrintResult("  add and remove a module", changeTime, "change");
+	}
+	return 0;
+}
@@ -0,0 +1,142 @@
+#include "Benchmark.h"
+#include "ImageBuilder.h"
+#include "PluginScanIndex.h"
+#include "PortableExecutable.h"
+#include <filesystem>
+#include <fstream>
+
+// Plugin scan with an empty index (every file is read and parsed) against one with a loaded index (a stamp query
+// per file), over a directory of generated plugin libraries. The files stay in the page cache between the runs,
+// so the cold numbers are a lower bound of what a first start after boot costs.
+using namespace xSE;
+using Testing::BenchmarkOptions;
+using Testing::ImageBuilder;
+
+namespace
+{
+	// The image itself is a few kilobytes, the padding stands in for the code sections
+	constexpr size_t g_PluginFileSize = 256 * 1024;
+
+	std::optional<FileStamp> GetFileStamp(const std::filesystem::path& path)
+	{
+		std::error_code error;
+		const auto size = std::filesystem::file_size(path, error);
+		const auto lastWriteTime = std::filesystem::last_write_time(path, error);
+		if (error)
+		{
+			return {};
+		}
+		return FileStamp{size, static_cast<uint64_t>(lastWriteTime.time_since_epoch().count())};
+	}
+
+	PluginProbeResult ProbePlugin(const std::filesystem::path& path)
+	{
+		std::ifstream stream(path, std::ios::binary);
+		std::vector<std::byte> data(std::filesystem::file_size(path));
+		stream.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+		PluginProbeResult result;
+		PE::ImageReader reader(data, PE::Layout::File);
+		if (!reader.IsNull())
+		{
+			result.IsValidImage = true;
+			result.HasPreloadFunction = reader.ContainsExport("F4SEPlugin_Preload");
+			result.HasInitializeFunction = reader.ContainsExport("Initialize");
+			reader.EnumImportedModules([&](std::string_view moduleName)
+			{
+				result.ImportedModules.emplace_back(moduleName);
+				return true;
+			});
+		}
+		return result;
+	}
+
+	size_t ScanPlugins(PluginScanIndex& index, const std::vector<std::filesystem::path>& paths)
+	{
+		size_t preloadCount = 0;
+		for (const auto& path: paths)
+		{
+			const std::string key = path.string();
+			const auto stamp = GetFileStamp(path);
+
+			std::optional<PluginProbeResult> result = stamp ? index.Find(key, *stamp) : std::nullopt;
+			if (!result)
+			{
+				result = ProbePlugin(path);
+				if (stamp)
+				{
+					index.Update(key, *stamp, *result);
+				}
+			}
+			preloadCount += result->HasPreloadFunction ? 1 : 0;
+		}
+		return preloadCount;
+	}
+
+	std::vector<std::filesystem::path> CreatePlugins(const std::filesystem::path& directory, size_t count)
+	{
+		std::vector<std::filesystem::path> paths;
+		for (size_t i = 0; i < count; i++)
+		{
+			ImageBuilder builder;
+			builder.SetModuleName("Plugin" + std::to_string(i) + ".dll");
+			builder.AddExport("F4SEPlugin_Load");
+			builder.AddExport("F4SEPlugin_Query");
+			if (i % 4 == 0)
+			{
+				builder.AddExport("F4SEPlugin_Preload");
+			}
+			for (size_t j = 0; j < 32; j++)
+			{
+				builder.AddExport("Export" + std::to_string(j));
+			}
+			builder.AddImport({"KERNEL32.dll", {"GetModuleHandleW", "GetProcAddress", "VirtualProtect"}, {}});
+			builder.AddImport({"MSVCP140.dll", {"?_Xlength_error@std@@YAXPEBD@Z"}, {}});
+			builder.AddImport({"VCRUNTIME140.dll", {"memcpy", "memset"}, {}});
+
+			auto data = builder.Build(PE::Layout::File);
+			data.resize(std::max(data.size(), g_PluginFileSize));
+
+			paths.emplace_back(directory / ("Plugin" + std::to_string(i) + ".dll"));
+			std::ofstream stream(paths.back(), std::ios::binary|std::ios::trunc);
+			stream.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+		}
+		return paths;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options(argc, argv);
+
+	const auto directory = std::filesystem::temp_directory_path() / ("xSEPluginScanIndexBenchmark-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+	std::filesystem::create_directories(directory);
+
+	for (size_t pluginCount: {10, 100, 1000})
+	{
+		const auto paths = CreatePlugins(directory, options.Quick ? std::min<size_t>(pluginCount, 10) : pluginCount);
+		const size_t runs = options.Quick ? 1 : 5;
+
+		std::vector<std::byte> indexData;
+		const double coldTime = Testing::MeasureNanoseconds(1, [&](size_t)
+		{
+			PluginScanIndex index("benchmark");
+			Testing::DoNotOptimize(ScanPlugins(index, paths));
+			indexData = index.Serialize();
+		}, runs);
+		const double warmTime = Testing::MeasureNanoseconds(1, [&](size_t)
+		{
+			PluginScanIndex index("benchmark");
+			index.Deserialize(indexData);
+			Testing::DoNotOptimize(ScanPlugins(index, paths));
+			Testing::DoNotOptimize(index.IsModified());
+		}, runs);
+
+		std::printf("%zu plugins, index is %zu bytes\n", paths.size(), indexData.size());
+		Testing::PrintResult("  cold scan, empty index", coldTime / static_cast<double>(paths.size()), "plugin");
+		Testing::PrintResult("  warm scan, loaded index", warmTime / static_cast<double>(paths.size()), "plugin");
+	}
+
+	std::filesystem::remove_all(directory);
+	return 0;
+}
@@ -0,0 +1,124 @@
+#include "Benchmark.h"
+#include "ImageBuilder.h"
+#include "PortableExecutable.h"
+#include <fstream>
+#include <iterator>
+#include <random>
+
+// Export lookups over synthetic images of growing size, compared with a linear walk over the name table which is
+// what the lookup did before it became a binary search. Paths of real DLLs on the command line are measured too.
+using namespace xSE;
+using Testing::BenchmarkOptions;
+using Testing::ImageBuilder;
+
+namespace
+{
+	std::string MakeExportName(size_t index)
+	{
+		// Looks like the usual mix of prefixed plugin API names
+		static constexpr std::string_view prefixes[] = {"F4SEPlugin_", "SKSEPlugin_", "Hook", "Get", "Set", "_Internal"};
+		return std::string(prefixes[index % std::size(prefixes)]) + "Function" + std::to_string(index);
+	}
+
+	std::optional<PE::ExportEntry> FindExportLinear(PE::ImageReader& image, std::string_view name)
+	{
+		std::optional<PE::ExportEntry> result;
+		image.EnumExports([&](const PE::ExportEntry& entry)
+		{
+			if (entry.Name == name)
+			{
+				result = entry;
+				return false;
+			}
+			return true;
+		});
+		return result;
+	}
+
+	void MeasureImage(const BenchmarkOptions& options, std::string_view label, std::span<const std::byte> data, std::vector<std::string> names)
+	{
+		PE::ImageReader image(data, PE::Layout::File);
+		if (image.IsNull() || names.empty())
+		{
+			std::printf("%.*s: not an image or no named exports, skipped\n", static_cast<int>(label.size()), label.data());
+			return;
+		}
+
+		std::mt19937 random(42);
+		std::ranges::shuffle(names, random);
+		const size_t iterations = options.Scale(200000);
+		const size_t linearIterations = options.Scale(std::max<size_t>(2000000 / names.size(), 10));
+
+		std::printf("%.*s: %zu named exports\n", static_cast<int>(label.size()), label.data(), names.size());
+		Testing::PrintResult("  parse headers", Testing::MeasureNanoseconds(iterations, [&](size_t)
+		{
+			PE::ImageReader reader(data, PE::Layout::File);
+			Testing::DoNotOptimize(reader);
+		}));
+		Testing::PrintResult("  first lookup (parses the export directory)", Testing::MeasureNanoseconds(options.Scale(20000), [&](size_t i)
+		{
+			PE::ImageReader reader(data, PE::Layout::File);
+			Testing::DoNotOptimize(reader.FindExport(names[i % names.size()]));
+		}));
+		Testing::PrintResult("  FindExport(name), hit", Testing::MeasureNanoseconds(iterations, [&](size_t i)
+		{
+			Testing::DoNotOptimize(image.FindExport(names[i % names.size()]));
+		}));
+		Testing::PrintResult("  FindExport(name), miss", Testing::MeasureNanoseconds(iterations, [&](size_t i)
+		{
+			Testing::DoNotOptimize(image.FindExport(std::string_view(names[i % names.size()]).substr(1)));
+		}));
+		Testing::PrintResult("  FindExport(ordinal)", Testing::MeasureNanoseconds(iterations, [&](size_t i)
+		{
+			Testing::DoNotOptimize(image.FindExport(image.GetExportOrdinalBase() + static_cast<uint32_t>(i % image.GetExportFunctionCount())));
+		}));
+		Testing::PrintResult("  linear name scan, hit", Testing::MeasureNanoseconds(linearIterations, [&](size_t i)
+		{
+			Testing::DoNotOptimize(FindExportLinear(image, names[i % names.size()]));
+		}));
+	}
+
+	std::vector<std::byte> ReadFile(const std::string& path)
+	{
+		std::ifstream stream(path, std::ios::binary);
+		std::vector<char> buffer((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+		std::vector<std::byte> data(buffer.size());
+		std::memcpy(data.data(), buffer.data(), buffer.size());
+		return data;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options(argc, argv);
+
+	for (size_t exportCount: {16, 256, 4096, 32768})
+	{
+		ImageBuilder builder;
+		std::vector<std::string> names;
+		for (size_t i = 0; i < exportCount; i++)
+		{
+			names.emplace_back(MakeExportName(i));
+			builder.AddExport(names.back());
+		}
+
+		const auto data = builder.Build(PE::Layout::File);
+		MeasureImage(options, "synthetic, " + std::to_string(exportCount) + " exports", data, std::move(names));
+	}
+
+	for (const std::string& path: options.Arguments)
+	{
+		const auto data = ReadFile(path);
+
+		std::vector<std::string> names;
+		PE::ImageReader image(data, PE::Layout::File);
+		image.EnumExports([&](const PE::ExportEntry& entry)
+		{
+			names.emplace_back(entry.Name);
+			return true;
+		});
+		MeasureImage(options, path, data, std::move(names));
+	}
+	return 0;
+}
@@ -0,0 +1,167 @@
+#include "Benchmark.h"
+#include <thread>
+
+// Forwarding overhead of the proxy export thunks. The MASM thunks from 'ProxyThunks.asm' can't be built here, so both
+// schemes are reproduced instruction for instruction in GNU assembler (x86-64 only):
+//
+//   shared: the target is stored into the global 'UnconditionalJumpAddress', then the common 'UnconditionalJump'
+//           jumps through it. That's what every export did before, a shared write per call.
+//   thunk:  every export jumps through its own slot of the function table.
+//
+// With several threads calling different exports at once the shared scheme also sends some calls to the wrong
+// function, the number of such calls is reported next to the timings.
+using namespace xSE;
+using Testing::BenchmarkOptions;
+
+namespace
+{
+	constexpr size_t g_ExportCount = 8;
+}
+
+extern "C"
+{
+	void* g_BenchmarkFunctions[g_ExportCount] = {};
+	void* g_BenchmarkJumpAddress = nullptr;
+}
+
+asm(R"(
+	.intel_syntax noprefix
+	.text
+
+	.macro BENCHMARK_PROXY_THUNK index
+		.p2align 4
+		BenchmarkProxyThunk\index:
+			jmp qword ptr [rip + g_BenchmarkFunctions + \index * 8]
+	.endm
+	.macro BENCHMARK_SHARED_PROXY index
+		.p2align 4
+		BenchmarkSharedProxy\index:
+			mov rax, qword ptr [rip + g_BenchmarkFunctions + \index * 8]
+			mov qword ptr [rip + g_BenchmarkJumpAddress], rax
+			jmp BenchmarkUnconditionalJump
+	.endm
+
+	.p2align 4
+	BenchmarkUnconditionalJump:
+		jmp qword ptr [rip + g_BenchmarkJumpAddress]
+
+	.irp index, 0, 1, 2, 3, 4, 5, 6, 7
+		BENCHMARK_PROXY_THUNK \index
+		BENCHMARK_SHARED_PROXY \index
+	.endr
+
+	.section .data.rel.ro, "aw"
+	.p2align 3
+	.globl g_BenchmarkProxyThunks
+	g_BenchmarkProxyThunks:
+	.irp index, 0, 1, 2, 3, 4, 5, 6, 7
+		.quad BenchmarkProxyThunk\index
+	.endr
+	.globl g_BenchmarkSharedProxies
+	g_BenchmarkSharedProxies:
+	.irp index, 0, 1, 2, 3, 4, 5, 6, 7
+		.quad BenchmarkSharedProxy\index
+	.endr
+
+	.text
+	.att_syntax prefix
+)");
+
+using ExportFunc = size_t(*)(size_t);
+extern "C"
+{
+	extern const ExportFunc g_BenchmarkProxyThunks[g_ExportCount];
+	extern const ExportFunc g_BenchmarkSharedProxies[g_ExportCount];
+}
+
+namespace
+{
+	template<size_t index>
+	__attribute__((noinline)) size_t OriginalFunction(size_t value)
+	{
+		// The result tells which function actually got called
+		asm volatile("");
+		return value * g_ExportCount + index;
+	}
+
+	template<size_t... index>
+	void SetOriginalFunctions(std::index_sequence<index...>)
+	{
+		((g_BenchmarkFunctions[index] = reinterpret_cast<void*>(&OriginalFunction<index>)), ...);
+	}
+
+	struct Result final
+	{
+		double Nanoseconds = 0;
+		size_t WrongCalls = 0;
+	};
+
+	Result CallFromThreads(const ExportFunc* functions, size_t threadCount, size_t iterations)
+	{
+		std::vector<size_t> wrongCalls(threadCount);
+		std::vector<double> times(threadCount);
+		std::vector<std::thread> threads;
+		for (size_t i = 0; i < threadCount; i++)
+		{
+			threads.emplace_back([&, i]()
+			{
+				// Every thread calls its own export, as with unrelated API calls from different threads
+				const ExportFunc func = functions[i % g_ExportCount];
+				times[i] = Testing::MeasureNanoseconds(iterations, [&](size_t j)
+				{
+					const size_t result = func(j);
+					if (result != j * g_ExportCount + i % g_ExportCount)
+					{
+						wrongCalls[i]++;
+					}
+				}, 3);
+			});
+		}
+		for (std::thread& thread: threads)
+		{
+			thread.join();
+		}
+
+		Result result;
+		result.Nanoseconds = *std::ranges::max_element(times);
+		for (size_t count: wrongCalls)
+		{
+			result.WrongCalls += count;
+		}
+		return result;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options(argc, argv);
+	const size_t iterations = options.Scale(20000000);
+	SetOriginalFunctions(std::make_index_sequence<g_ExportCount>());
+
+	ExportFunc directFunctions[g_ExportCount] = {};
+	for (size_t i = 0; i < g_ExportCount; i++)
+	{
+		directFunctions[i] = reinterpret_cast<ExportFunc>(g_BenchmarkFunctions[i]);
+	}
+
+	const std::pair<const char*, const ExportFunc*> schemes[] =
+	{
+		{"direct call (no proxy)", directFunctions},
+		{"shared jump address", g_BenchmarkSharedProxies},
+		{"per-export thunk", g_BenchmarkProxyThunks}
+	};
+
+	// With more threads than cores the shared scheme only goes wrong when a thread is preempted between the store
+	// and the jump, so the wrong calls are rare there. The contention on the shared address needs several cores too.
+	for (size_t threadCount = 1; threadCount <= g_ExportCount; threadCount *= 2)
+	{
+		std::printf("%zu thread(s), %u core(s)\n", threadCount, std::thread::hardware_concurrency());
+		for (const auto& [name, functions]: schemes)
+		{
+			const Result result = CallFromThreads(functions, threadCount, iterations);
+			const std::string label = "  " + std::string(name) + (result.WrongCalls != 0 ? ", wrong target " + std::to_string(result.WrongCalls) + " times" : "");
+			Testing::PrintResult(label, result.Nanoseconds, "call");
+		}
+	}
+	return 0;
+}
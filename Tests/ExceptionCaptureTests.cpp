@@ -0,0 +1,267 @@
+#include "Test.h"
+#include "ExceptionCapture.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+using namespace xSE;
+
+namespace
+{
+	// Contexts recorded from access violations in a 64-bit and a 32-bit build, filled the same way 'OnVectoredException' does
+	ExceptionSnapshot MakeRecordedSnapshot64()
+	{
+		ExceptionSnapshot snapshot;
+		snapshot.Sequence = 3;
+		snapshot.ThreadID = 7412;
+		snapshot.Architecture = CPUArchitecture::x64;
+		snapshot.Code = 0xC0000005;
+		snapshot.Address = 0x00007FFB2C4E1A3F;
+		snapshot.ParameterCount = 2;
+		snapshot.Parameters[0] = 1;
+		snapshot.Parameters[1] = 0x10;
+		snapshot.SetModule("ExamplePlugin.dll", 0x11A3F);
+
+		const uint64_t registers[] =
+		{
+			0x0000000000000000, 0x000001F6A3C0B2D0, 0x0000000000000010, 0x00000000DEADBEEF, 0x000001F6A3C0B300, 0x0000000000000001,
+			0x00000089A2BFF6A0, 0x00000089A2BFF5F8, 0x0000000000000040, 0x0000000000000000, 0x00007FFB2C4E0000, 0x0000000000000246,
+			0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x00007FFB2C4E1A3F, 0x0000000000010246
+		};
+		std::ranges::copy(registers, snapshot.Registers);
+
+		const uint64_t stack[] = {0x00007FFB2C4E2210, 0x000001F6A3C0B2D0, 0, 0x00007FF6E1201F44, 0x00000089A2BFF6A0};
+		snapshot.CopyStack(0x00000089A2BFF5F8, stack, sizeof(stack));
+		return snapshot;
+	}
+	ExceptionSnapshot MakeRecordedSnapshot32()
+	{
+		ExceptionSnapshot snapshot;
+		snapshot.Sequence = 12;
+		snapshot.ThreadID = 1290;
+		snapshot.Architecture = CPUArchitecture::x86;
+		snapshot.Code = 0xC0000005;
+		snapshot.Address = 0x6F3A12B4;
+		snapshot.NestedRecord = 0x0019F7C0;
+		snapshot.ParameterCount = 2;
+		snapshot.Parameters[1] = 0x00000004;
+
+		const uint64_t registers[] = {0x00000000, 0x0019F8A0, 0x00000004, 0x00000000, 0x02A31C18, 0x0019F8D4, 0x0019F890, 0x0019F870, 0x6F3A12B4, 0x00010246};
+		std::ranges::copy(registers, snapshot.Registers);
+
+		// Odd number of bytes, the incomplete last word isn't shown
+		const uint32_t stack[] = {0x6F3A2210, 0x0019F8A0, 0x00401F44};
+		snapshot.CopyStack(0x0019F870, stack, sizeof(stack) - 1);
+		return snapshot;
+	}
+}
+
+XSE_TEST(FormatRecordedContext64)
+{
+	const std::string text = FormatExceptionSnapshot(MakeRecordedSnapshot64());
+	const std::string expected =
+		"Exception #3 on thread 7412: code 0xC0000005, flags 0x00000000, address 0x00007FFB2C4E1A3F (ExamplePlugin.dll+0x11A3F)\n"
+		"Parameters: 0x1 0x10\n"
+		"Registers:\n"
+		"\tRAX=0x0000000000000000, RBX=0x000001F6A3C0B2D0, RCX=0x0000000000000010, RDX=0x00000000DEADBEEF, RSI=0x000001F6A3C0B300, RDI=0x0000000000000001\n"
+		"\tRBP=0x00000089A2BFF6A0, RSP=0x00000089A2BFF5F8, R8=0x0000000000000040, R9=0x0000000000000000, R10=0x00007FFB2C4E0000, R11=0x0000000000000246\n"
+		"\tR12=0x0000000000000000, R13=0x0000000000000000, R14=0x0000000000000000, R15=0x0000000000000000, RIP=0x00007FFB2C4E1A3F, EFLAGS=0x0000000000010246\n"
+		"Stack at 0x00000089A2BFF5F8, 40 bytes:\n"
+		"\t+0000: 00007FFB2C4E2210 000001F6A3C0B2D0 0000000000000000 00007FF6E1201F44\n"
+		"\t+0020: 00000089A2BFF6A0";
+	XSE_CHECK_EQUAL(text, expected);
+}
+
+XSE_TEST(FormatRecordedContext32)
+{
+	const std::string text = FormatExceptionSnapshot(MakeRecordedSnapshot32());
+	const std::string expected =
+		"Exception #12 on thread 1290: code 0xC0000005, flags 0x00000000, address 0x6F3A12B4, nested record 0x0019F7C0\n"
+		"Parameters: 0x0 0x4\n"
+		"Registers:\n"
+		"\tEAX=0x00000000, EBX=0x0019F8A0, ECX=0x00000004, EDX=0x00000000, ESI=0x02A31C18, EDI=0x0019F8D4\n"
+		"\tEBP=0x0019F890, ESP=0x0019F870, EIP=0x6F3A12B4, EFLAGS=0x00010246\n"
+		"Stack at 0x0019F870, 8 bytes:\n"
+		"\t+0000: 6F3A2210 0019F8A0";
+	XSE_CHECK_EQUAL(text, expected);
+}
+
+XSE_TEST(SnapshotLimits)
+{
+	ExceptionSnapshot snapshot;
+
+	// The module name is cut to fit, and the offset is kept
+	const std::string longName(ExceptionSnapshot::MaxModuleName * 2, 'a');
+	snapshot.SetModule(longName, 0x1234);
+	XSE_CHECK_EQUAL(std::string_view(snapshot.ModuleName), std::string_view(longName).substr(0, ExceptionSnapshot::MaxModuleName - 1));
+	XSE_CHECK_EQUAL(snapshot.ModuleOffset, 0x1234u);
+
+	// Only the start of the stack is kept
+	std::vector<std::byte> stack(ExceptionSnapshot::MaxStackSize * 4, std::byte(0xCC));
+	stack[ExceptionSnapshot::MaxStackSize - 1] = std::byte(0x11);
+	snapshot.CopyStack(0x1000, stack.data(), stack.size());
+	XSE_CHECK_EQUAL(snapshot.StackSize, ExceptionSnapshot::MaxStackSize);
+	XSE_CHECK(snapshot.Stack[ExceptionSnapshot::MaxStackSize - 1] == std::byte(0x11));
+
+	// Parameter count straight from the exception record, more than the snapshot holds
+	snapshot.ParameterCount = 1000;
+	snapshot.StackSize = 0xFFFFFFFF;
+	const std::string text = FormatExceptionSnapshot(snapshot);
+	XSE_CHECK(text.find(std::string(ExceptionSnapshot::MaxModuleName - 1, 'a') + "+0x1234)") != std::string::npos);
+	std::string parameters = "\nParameters:";
+	for (size_t i = 0; i < ExceptionSnapshot::MaxParameters; i++)
+	{
+		parameters += " 0x0";
+	}
+	XSE_CHECK(text.find(parameters + "\n") != std::string::npos);
+	XSE_CHECK(text.find(", 512 bytes:") != std::string::npos);
+
+	XSE_CHECK_EQUAL(ExceptionSnapshot::GetRegisterNames(CPUArchitecture::x64).size(), 18u);
+	XSE_CHECK_EQUAL(ExceptionSnapshot::GetRegisterNames(CPUArchitecture::x86).size(), 10u);
+}
+
+XSE_TEST(FlushInOrderAndReuseSlots)
+{
+	ExceptionCapture capture(4);
+
+	// Acquiring clears whatever the slot held before
+	for (size_t round = 0; round < 3; round++)
+	{
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			ExceptionSnapshot* snapshot = capture.Acquire();
+			XSE_REQUIRE(snapshot);
+			XSE_CHECK_EQUAL(snapshot->Code, 0u);
+			XSE_CHECK_EQUAL(snapshot->StackSize, 0u);
+
+			snapshot->Code = i + 1;
+			snapshot->CopyStack(0x1000, &round, sizeof(round));
+			capture.Commit(*snapshot);
+		}
+
+		std::vector<uint32_t> codes;
+		std::vector<uint64_t> sequences;
+		XSE_CHECK_EQUAL(capture.Flush([&](const ExceptionSnapshot& snapshot)
+		{
+			codes.push_back(snapshot.Code);
+			sequences.push_back(snapshot.Sequence);
+		}), 3u);
+		XSE_CHECK(codes == std::vector<uint32_t>({1, 2, 3}));
+		XSE_CHECK(std::ranges::is_sorted(sequences));
+	}
+	XSE_CHECK_EQUAL(capture.Flush([](const ExceptionSnapshot&) {}), 0u);
+	XSE_CHECK_EQUAL(capture.GetDroppedCount(), 0u);
+}
+
+XSE_TEST(UncommittedSnapshotsWait)
+{
+	ExceptionCapture capture(2);
+
+	// A snapshot still being written isn't flushed, and neither slot is available until one of them is freed
+	ExceptionSnapshot* writing = capture.Acquire();
+	ExceptionSnapshot* ready = capture.Acquire();
+	XSE_REQUIRE(writing && ready);
+	capture.Commit(*ready);
+
+	XSE_CHECK(capture.Acquire() == nullptr);
+	XSE_CHECK_EQUAL(capture.GetDroppedCount(), 1u);
+	XSE_CHECK_EQUAL(capture.Flush([](const ExceptionSnapshot&) {}), 1u);
+
+	capture.Commit(*writing);
+	XSE_CHECK(capture.Acquire() != nullptr);
+	XSE_CHECK_EQUAL(capture.Flush([](const ExceptionSnapshot&) {}), 1u);
+}
+
+XSE_TEST(FlushFreesSlotsWhenFunctionThrows)
+{
+	ExceptionCapture capture(3);
+	for (size_t i = 0; i < 3; i++)
+	{
+		capture.Commit(*capture.Acquire());
+	}
+
+	size_t calls = 0;
+	bool thrown = false;
+	try
+	{
+		capture.Flush([&](const ExceptionSnapshot&)
+		{
+			if (++calls == 2)
+			{
+				throw std::runtime_error("Logger failed");
+			}
+		});
+	}
+	catch (const std::runtime_error&)
+	{
+		thrown = true;
+	}
+	XSE_CHECK(thrown);
+	XSE_CHECK_EQUAL(calls, 2u);
+
+	// The remaining snapshot is lost, but all the slots can be used again
+	XSE_CHECK_EQUAL(capture.Flush([](const ExceptionSnapshot&) {}), 0u);
+	for (size_t i = 0; i < 3; i++)
+	{
+		XSE_CHECK(capture.Acquire() != nullptr);
+	}
+}
+
+XSE_TEST(ConcurrentCaptureAndFlush)
+{
+	constexpr size_t threadCount = 4;
+	constexpr size_t exceptionCount = 5000;
+
+	ExceptionCapture capture(16);
+	std::atomic<size_t> running = threadCount;
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < threadCount; i++)
+	{
+		threads.emplace_back([&capture, &running, i]()
+		{
+			for (size_t j = 0; j < exceptionCount; j++)
+			{
+				if (ExceptionSnapshot* snapshot = capture.Acquire())
+				{
+					// Every field written by the capturing thread has to be seen by the flush
+					snapshot->ThreadID = static_cast<uint32_t>(i);
+					snapshot->Code = static_cast<uint32_t>(j);
+					snapshot->Parameters[0] = i * exceptionCount + j;
+					snapshot->CopyStack(snapshot->Parameters[0], &snapshot->Parameters[0], sizeof(uint64_t));
+					capture.Commit(*snapshot);
+				}
+			}
+			running.fetch_sub(1);
+		});
+	}
+
+	size_t flushed = 0;
+	size_t corrupted = 0;
+	auto Flush = [&]()
+	{
+		uint64_t lastSequence = 0;
+		flushed += capture.Flush([&](const ExceptionSnapshot& snapshot)
+		{
+			uint64_t stackValue = 0;
+			std::memcpy(&stackValue, snapshot.Stack, sizeof(stackValue));
+
+			const uint64_t value = snapshot.ThreadID * exceptionCount + snapshot.Code;
+			corrupted += snapshot.Parameters[0] != value || snapshot.StackAddress != value || stackValue != value || snapshot.Sequence < lastSequence;
+			lastSequence = snapshot.Sequence;
+		});
+	};
+	while (running.load() != 0)
+	{
+		Flush();
+		std::this_thread::yield();
+	}
+	for (std::thread& thread: threads)
+	{
+		thread.join();
+	}
+	Flush();
+
+	XSE_CHECK_EQUAL(corrupted, 0u);
+	XSE_CHECK_EQUAL(flushed + capture.GetDroppedCount(), threadCount * exceptionCount);
+}
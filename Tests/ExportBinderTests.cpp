@@ -0,0 +1,205 @@
+#include "Test.h"
+#include "ImageBuilder.h"
+#include "ExportManifest.h"
+#include "ExportBinder.h"
+
+// The original libraries are stood in for by images built from the export manifests of the proxied libraries:
+// WinHTTP as a PE32+ image and WinMM as a PE32 one, the same as the builds that proxy them.
+using namespace xSE;
+using Testing::ImageBuilder;
+
+namespace
+{
+	struct Library final
+	{
+		std::string_view Name;
+		bool Is64Bit = true;
+	};
+	constexpr Library g_Libraries[] = {{"WinHTTP", true}, {"WinMM", false}};
+
+	struct BindResult final
+	{
+		PE::ExportBindStatistics Statistics;
+		std::vector<uint32_t> RVAs;
+		std::vector<std::byte> Image;
+	};
+
+	// Requests are the same as 'BindOriginalFunctions' makes: expected ordinal is the manifest position plus one
+	std::vector<PE::ExportBindRequest> MakeRequests(const std::vector<std::string>& names)
+	{
+		std::vector<PE::ExportBindRequest> requests;
+		for (size_t i = 0; i < names.size(); i++)
+		{
+			requests.push_back({names[i], static_cast<uint32_t>(i + 1)});
+		}
+		return requests;
+	}
+	BindResult Bind(const ImageBuilder& builder, std::span<const PE::ExportBindRequest> requests)
+	{
+		BindResult result;
+		result.Image = builder.Build(PE::Layout::Image);
+		result.RVAs.resize(requests.size(), 0xFFFFFFFF);
+
+		PE::ImageReader image(result.Image, PE::Layout::Image);
+		result.Statistics = PE::ExportBinder(image).Bind(requests, result.RVAs);
+		return result;
+	}
+
+	// Every bound RVA has to be the one the name lookup gives
+	bool CheckRVAs(const BindResult& result, std::span<const PE::ExportBindRequest> requests)
+	{
+		PE::ImageReader image(result.Image, PE::Layout::Image);
+		for (size_t i = 0; i < requests.size(); i++)
+		{
+			const auto entry = image.FindExport(requests[i].Name);
+			const uint32_t expectedRVA = entry && !entry->IsForwarded ? entry->RVA : 0;
+			if (result.RVAs[i] != expectedRVA)
+			{
+				Testing::ReportFailure(__FILE__, __LINE__, requests[i].Name, "RVA " + std::to_string(result.RVAs[i]) + " != " + std::to_string(expectedRVA));
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+XSE_TEST(ManifestsAreReadable)
+{
+	for (const Library& library: g_Libraries)
+	{
+		const auto names = Testing::ReadExportManifest(library.Name);
+		XSE_CHECK(names.size() > 50);
+		XSE_CHECK(std::ranges::none_of(names, [](const std::string& name)
+		{
+			return name.empty() || name.front() == '#';
+		}));
+	}
+}
+
+XSE_TEST(BindsEverythingByOrdinal)
+{
+	for (const Library& library: g_Libraries)
+	{
+		const auto names = Testing::ReadExportManifest(library.Name);
+		const auto requests = MakeRequests(names);
+
+		ImageBuilder builder(library.Is64Bit);
+		for (const std::string& name: names)
+		{
+			builder.AddExport(name);
+		}
+
+		const auto result = Bind(builder, requests);
+		XSE_CHECK_EQUAL(result.Statistics.ByOrdinal, names.size());
+		XSE_CHECK_EQUAL(result.Statistics.ByName, 0u);
+		XSE_CHECK(CheckRVAs(result, requests));
+	}
+}
+
+XSE_TEST(AdaptsToShiftedOrdinals)
+{
+	// Another build of the library with a new export in the middle, everything after it moves one ordinal up
+	for (const Library& library: g_Libraries)
+	{
+		const auto names = Testing::ReadExportManifest(library.Name);
+		const auto requests = MakeRequests(names);
+		const size_t insertAt = names.size() / 3;
+
+		ImageBuilder builder(library.Is64Bit);
+		for (size_t i = 0; i < names.size(); i++)
+		{
+			if (i == insertAt)
+			{
+				builder.AddExport("NewExportInThisBuild");
+			}
+			builder.AddExport(names[i]);
+		}
+
+		// Only the first shifted export needs the name lookup, the shift is reused for the rest
+		const auto result = Bind(builder, requests);
+		XSE_CHECK_EQUAL(result.Statistics.ByName, 1u);
+		XSE_CHECK_EQUAL(result.Statistics.ByOrdinal, names.size() - 1);
+		XSE_CHECK(CheckRVAs(result, requests));
+	}
+}
+
+XSE_TEST(AdaptsToOrdinalBase)
+{
+	const auto names = Testing::ReadExportManifest("WinMM");
+	const auto requests = MakeRequests(names);
+
+	ImageBuilder builder(false);
+	builder.SetOrdinalBase(2);
+	for (const std::string& name: names)
+	{
+		builder.AddExport(name);
+	}
+
+	const auto result = Bind(builder, requests);
+	XSE_CHECK_EQUAL(result.Statistics.ByName, 1u);
+	XSE_CHECK_EQUAL(result.Statistics.ByOrdinal, names.size() - 1);
+	XSE_CHECK(CheckRVAs(result, requests));
+}
+
+XSE_TEST(ForwardedAndMissingExports)
+{
+	const auto names = Testing::ReadExportManifest("WinMM");
+	const auto requests = MakeRequests(names);
+	const std::string missing = names[10];
+	const std::string forwarded[] = {names[0], names[names.size() / 2], names.back()};
+
+	// Ordinals are kept as in the manifest, the missing export leaves a gap in the address table
+	ImageBuilder builder(false);
+	for (size_t i = 0; i < names.size(); i++)
+	{
+		const auto ordinal = static_cast<uint32_t>(i + 1);
+		if (names[i] == missing)
+		{
+			continue;
+		}
+		else if (std::ranges::find(forwarded, names[i]) != std::end(forwarded))
+		{
+			builder.AddForwardedExport(names[i], "WINMMBASE." + names[i], ordinal);
+		}
+		else
+		{
+			builder.AddExport(names[i], ordinal);
+		}
+	}
+
+	const auto result = Bind(builder, requests);
+	XSE_CHECK_EQUAL(result.Statistics.Unresolved, 1u);
+	XSE_CHECK_EQUAL(result.Statistics.Forwarded, std::size(forwarded));
+	XSE_CHECK_EQUAL(result.Statistics.ByOrdinal, names.size() - 1 - std::size(forwarded));
+	XSE_CHECK_EQUAL(result.RVAs[10], 0u);
+	XSE_CHECK_EQUAL(result.RVAs[0], 0u);
+	XSE_CHECK(CheckRVAs(result, requests));
+}
+
+XSE_TEST(NamelessExportAtExpectedOrdinal)
+{
+	// The ordinal is taken by a function exported without a name, the name has to be looked up
+	ImageBuilder builder;
+	builder.AddExport("First", 1);
+	builder.AddExport({}, 2);
+	builder.AddExport("Second", 3);
+	builder.AddExport("Third", 4);
+
+	const PE::ExportBindRequest requests[] = {{"First", 1}, {"Second", 2}, {"Third", 3}, {"Unknown", 0}, {"Third", 0}};
+	const auto result = Bind(builder, requests);
+	XSE_CHECK_EQUAL(result.Statistics.ByOrdinal, 2u);
+	XSE_CHECK_EQUAL(result.Statistics.ByName, 2u);
+	XSE_CHECK_EQUAL(result.Statistics.Unresolved, 1u);
+	XSE_CHECK(CheckRVAs(result, requests));
+}
+
+XSE_TEST(ImageWithoutExports)
+{
+	ImageBuilder builder;
+	builder.AddImport({"KERNEL32.dll", {"GetProcAddress"}, {}});
+
+	const PE::ExportBindRequest requests[] = {{"WinHttpOpen", 1}, {"WinHttpConnect", 2}};
+	const auto result = Bind(builder, requests);
+	XSE_CHECK_EQUAL(result.Statistics.Unresolved, 2u);
+	XSE_CHECK(result.RVAs == std::vector<uint32_t>(2, 0));
+}
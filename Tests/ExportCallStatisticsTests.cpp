@@ -0,0 +1,281 @@
+#include "Test.h"
+#include "ExportCallStatistics.h"
+#include <algorithm>
+#include <thread>
+
+using namespace xSE;
+using namespace std::chrono_literals;
+
+namespace
+{
+	using Summary = ExportCallStatistics::Summary;
+
+	// Frame addresses only have to be ordered like a stack growing down, so made-up ones will do
+	constexpr uintptr_t g_OuterFrame = 0x10000;
+	constexpr uintptr_t g_InnerFrame = 0x0F000;
+
+	const Summary* FindSummary(const std::vector<Summary>& summaries, size_t index)
+	{
+		auto it = std::ranges::find(summaries, index, &Summary::Index);
+		return it != summaries.end() ? &*it : nullptr;
+	}
+}
+
+XSE_TEST(SampleIntervalIsPowerOfTwo)
+{
+	XSE_CHECK_EQUAL(ExportCallStatistics(1, 0).GetSampleInterval(), 1u);
+	XSE_CHECK_EQUAL(ExportCallStatistics(1, 1).GetSampleInterval(), 1u);
+	XSE_CHECK_EQUAL(ExportCallStatistics(1, 3).GetSampleInterval(), 4u);
+	XSE_CHECK_EQUAL(ExportCallStatistics(1, 64).GetSampleInterval(), 64u);
+	XSE_CHECK_EQUAL(ExportCallStatistics(1, 65).GetSampleInterval(), 128u);
+}
+
+XSE_TEST(SamplesEveryNthCallPerExport)
+{
+	ExportCallStatistics statistics(3, 4);
+
+	size_t tokens = 0;
+	for (size_t i = 0; i < 10; i++)
+	{
+		const size_t token = statistics.BeginCall(1, g_OuterFrame);
+		XSE_CHECK_EQUAL(token != 0, i % 4 == 0);
+		tokens += token != 0;
+		statistics.EndCall(token, g_OuterFrame);
+	}
+	statistics.EndCall(statistics.BeginCall(2, g_OuterFrame), g_OuterFrame);
+
+	// Out of range indices aren't counted at all
+	XSE_CHECK_EQUAL(statistics.BeginCall(3, g_OuterFrame), 0u);
+
+	const auto summaries = statistics.Summarize();
+	XSE_REQUIRE(summaries.size() == 2);
+	const Summary* summary = FindSummary(summaries, 1);
+	XSE_REQUIRE(summary);
+	XSE_CHECK_EQUAL(summary->Calls, 10u);
+	XSE_CHECK_EQUAL(summary->Samples, tokens);
+	XSE_CHECK_EQUAL(summary->Samples, 3u);
+	XSE_CHECK(FindSummary(summaries, 2) && FindSummary(summaries, 2)->Samples == 1);
+	XSE_CHECK(!FindSummary(summaries, 0));
+}
+
+XSE_TEST(HistogramBucketOfSlowCall)
+{
+	ExportCallStatistics statistics(1, 1);
+
+	const size_t token = statistics.BeginCall(0, g_OuterFrame);
+	XSE_REQUIRE(token != 0);
+	std::this_thread::sleep_for(3ms);
+	statistics.EndCall(token, g_OuterFrame);
+
+	// 3 ms is at least 2^21 ns, so the call lands in bucket 22 or later
+	const auto summaries = statistics.Summarize();
+	XSE_REQUIRE(summaries.size() == 1);
+	const Summary& summary = summaries.front();
+	XSE_CHECK_EQUAL(summary.Samples, 1u);
+	XSE_CHECK(summary.MaxTime >= 3ms);
+	XSE_CHECK_EQUAL(summary.TotalTime, summary.MaxTime);
+
+	size_t bucket = 0;
+	for (size_t i = 0; i < summary.Histogram.size(); i++)
+	{
+		XSE_CHECK(summary.Histogram[i] <= 1);
+		bucket = summary.Histogram[i] != 0 ? i : bucket;
+	}
+	XSE_CHECK(bucket >= 22);
+}
+
+XSE_TEST(PercentilesFromHistogram)
+{
+	Summary summary;
+	summary.Samples = 100;
+	summary.Histogram[4] = 50;
+	summary.Histogram[10] = 45;
+	summary.Histogram[20] = 5;
+	summary.MaxTime = 900us;
+	summary.TotalTime = 2ms;
+
+	XSE_CHECK_EQUAL(summary.GetMeanTime(), std::chrono::duration_cast<ExportCallStatistics::Clock::duration>(20us));
+	XSE_CHECK(summary.GetPercentile(0.0) == 16ns);
+	XSE_CHECK(summary.GetPercentile(0.5) == 16ns);
+	XSE_CHECK(summary.GetPercentile(0.51) == 1024ns);
+	XSE_CHECK(summary.GetPercentile(0.95) == 1024ns);
+
+	// Upper bound of the bucket is above the maximum, so the maximum is the answer
+	XSE_CHECK(summary.GetPercentile(0.99) == 900us);
+	XSE_CHECK(summary.GetPercentile(1.0) == 900us);
+
+	// The last bucket is open-ended
+	Summary slow;
+	slow.Samples = 1;
+	slow.Histogram.back() = 1;
+	slow.MaxTime = 10s;
+	XSE_CHECK(slow.GetPercentile(0.5) == 10s);
+
+	XSE_CHECK(Summary().GetMeanTime() == ExportCallStatistics::Clock::duration::zero());
+}
+
+XSE_TEST(NestedCalls)
+{
+	ExportCallStatistics statistics(2, 1);
+
+	const size_t outer = statistics.BeginCall(0, g_OuterFrame);
+	const size_t inner = statistics.BeginCall(1, g_InnerFrame);
+	XSE_CHECK_EQUAL(outer, 1u);
+	XSE_CHECK_EQUAL(inner, 2u);
+	statistics.EndCall(inner, g_InnerFrame);
+	statistics.EndCall(outer, g_OuterFrame);
+
+	for (const Summary& summary: statistics.Summarize())
+	{
+		XSE_CHECK_EQUAL(summary.Samples, 1u);
+	}
+}
+
+XSE_TEST(CallsAbandonedBelowReturningCall)
+{
+	// The inner call never returns (an exception went through it), the outer one does
+	ExportCallStatistics statistics(2, 1);
+
+	const size_t outer = statistics.BeginCall(0, g_OuterFrame);
+	const size_t inner = statistics.BeginCall(1, g_InnerFrame);
+	statistics.EndCall(outer, g_OuterFrame);
+
+	// Too late, it's gone with the outer call
+	statistics.EndCall(inner, g_InnerFrame);
+
+	const auto summaries = statistics.Summarize();
+	XSE_CHECK_EQUAL(FindSummary(summaries, 0)->Samples, 1u);
+	XSE_CHECK_EQUAL(FindSummary(summaries, 1)->Samples, 0u);
+
+	// Nothing is left pending, so the next call starts from the bottom of the stack again
+	const size_t next = statistics.BeginCall(0, g_OuterFrame);
+	XSE_CHECK_EQUAL(next, 1u);
+	statistics.EndCall(next, g_OuterFrame);
+}
+
+XSE_TEST(CallsAbandonedBelowNewCall)
+{
+	// A call at the same or deeper frame is abandoned if a new call starts at or above it (the stack was unwound past it)
+	ExportCallStatistics statistics(2, 1);
+
+	const size_t abandoned = statistics.BeginCall(0, g_InnerFrame);
+	const size_t sameFrame = statistics.BeginCall(0, g_InnerFrame);
+	XSE_CHECK_EQUAL(sameFrame, 1u);
+
+	const size_t next = statistics.BeginCall(1, g_OuterFrame);
+	XSE_CHECK_EQUAL(next, 1u);
+
+	// Stale tokens don't match the frame anymore
+	statistics.EndCall(abandoned, g_InnerFrame);
+	statistics.EndCall(sameFrame, g_InnerFrame);
+	statistics.EndCall(next, g_OuterFrame);
+
+	const auto summaries = statistics.Summarize();
+	XSE_CHECK_EQUAL(FindSummary(summaries, 0)->Calls, 2u);
+	XSE_CHECK_EQUAL(FindSummary(summaries, 0)->Samples, 0u);
+	XSE_CHECK_EQUAL(FindSummary(summaries, 1)->Samples, 1u);
+}
+
+XSE_TEST(UnknownTokensAreIgnored)
+{
+	ExportCallStatistics statistics(1, 1);
+	statistics.EndCall(0, g_OuterFrame);
+	statistics.EndCall(5, g_OuterFrame);
+
+	const size_t token = statistics.BeginCall(0, g_OuterFrame);
+	statistics.EndCall(token, g_InnerFrame);
+	statistics.EndCall(token + 1, g_OuterFrame);
+
+	// Ending the call from another thread does nothing either
+	std::thread([&]()
+	{
+		statistics.EndCall(token, g_OuterFrame);
+	}).join();
+
+	XSE_CHECK_EQUAL(statistics.Summarize().front().Samples, 0u);
+	statistics.EndCall(token, g_OuterFrame);
+	XSE_CHECK_EQUAL(statistics.Summarize().front().Samples, 1u);
+}
+
+XSE_TEST(PendingCallsLimit)
+{
+	ExportCallStatistics statistics(1, 1);
+
+	std::vector<size_t> tokens;
+	for (size_t i = 0; i <= ExportCallStatistics::MaxPendingCalls; i++)
+	{
+		tokens.push_back(statistics.BeginCall(0, g_OuterFrame - i * 0x100));
+	}
+	XSE_CHECK_EQUAL(tokens.back(), 0u);
+	XSE_CHECK_EQUAL(tokens[ExportCallStatistics::MaxPendingCalls - 1], ExportCallStatistics::MaxPendingCalls);
+
+	for (size_t i = tokens.size(); i-- != 0;)
+	{
+		statistics.EndCall(tokens[i], g_OuterFrame - i * 0x100);
+	}
+
+	const Summary summary = statistics.Summarize().front();
+	XSE_CHECK_EQUAL(summary.Calls, ExportCallStatistics::MaxPendingCalls + 1);
+	XSE_CHECK_EQUAL(summary.Samples, ExportCallStatistics::MaxPendingCalls);
+}
+
+XSE_TEST(TotalsAcrossThreads)
+{
+	constexpr size_t threadCount = 8;
+	constexpr size_t callCount = 10000;
+
+	ExportCallStatistics statistics(4, 16);
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < threadCount; i++)
+	{
+		threads.emplace_back([&statistics, i]()
+		{
+			for (size_t j = 0; j < callCount; j++)
+			{
+				const size_t index = (i + j) % statistics.GetExportCount();
+				statistics.EndCall(statistics.BeginCall(index, g_OuterFrame), g_OuterFrame);
+			}
+		});
+	}
+
+	// Reading while the threads are counting has to be safe
+	while (statistics.GetThreadCount() != threadCount)
+	{
+		statistics.Summarize();
+		std::this_thread::yield();
+	}
+	for (std::thread& thread: threads)
+	{
+		thread.join();
+	}
+
+	const auto summaries = statistics.Summarize();
+	XSE_REQUIRE(summaries.size() == 4);
+	for (const Summary& summary: summaries)
+	{
+		XSE_CHECK_EQUAL(summary.Calls, threadCount * callCount / 4);
+		XSE_CHECK_EQUAL(summary.Samples, threadCount * ((callCount / 4 + 15) / 16));
+
+		uint64_t histogramTotal = 0;
+		for (uint64_t count: summary.Histogram)
+		{
+			histogramTotal += count;
+		}
+		XSE_CHECK_EQUAL(histogramTotal, summary.Samples);
+	}
+}
+
+XSE_TEST(SeveralInstancesOnOneThread)
+{
+	ExportCallStatistics first(1, 1);
+	ExportCallStatistics second(1, 1);
+	for (size_t i = 0; i < 3; i++)
+	{
+		first.EndCall(first.BeginCall(0, g_OuterFrame), g_OuterFrame);
+		second.EndCall(second.BeginCall(0, g_OuterFrame), g_OuterFrame);
+	}
+
+	XSE_CHECK_EQUAL(first.Summarize().front().Calls, 3u);
+	XSE_CHECK_EQUAL(first.Summarize().front().Samples, 3u);
+	XSE_CHECK_EQUAL(second.Summarize().front().Calls, 3u);
+}
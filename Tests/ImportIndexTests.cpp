@@ -0,0 +1,143 @@
+#include "Test.h"
+#include "ImageBuilder.h"
+#include "ImportIndex.h"
+
+using namespace xSE;
+using Testing::ImageBuilder;
+
+namespace
+{
+	bool EqualsNoCase(std::string_view left, std::string_view right) noexcept
+	{
+		return std::ranges::equal(left, right, [](char a, char b)
+		{
+			auto ToLower = [](char c)
+			{
+				return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+			};
+			return ToLower(a) == ToLower(b);
+		});
+	}
+
+	// Reference lookup, the first matching slot in the order of the import directory
+	std::optional<uint32_t> FindSlotLinear(const PE::ImageReader& image, std::string_view moduleName, std::string_view name, uint32_t ordinal)
+	{
+		std::optional<uint32_t> result;
+		image.EnumImports([&](const PE::ImportEntry& entry)
+		{
+			if (EqualsNoCase(entry.ModuleName, moduleName) && entry.Name == name && entry.Ordinal == ordinal)
+			{
+				result = entry.SlotRVA;
+				return false;
+			}
+			return true;
+		});
+		return result;
+	}
+}
+
+XSE_TEST(FindsEveryImport)
+{
+	for (bool is64Bit: {false, true})
+	{
+		for (PE::Layout layout: {PE::Layout::File, PE::Layout::Image})
+		{
+			ImageBuilder builder(is64Bit);
+			builder.AddImport({"KERNEL32.dll", {"GetProcAddress", "LoadLibraryW", "CreateFileW"}, {}});
+			builder.AddImport({"WS2_32.dll", {}, {3, 23, 115}});
+			builder.AddImport({"USER32.dll", {"MessageBoxW"}, {}});
+
+			const auto data = builder.Build(layout);
+			PE::ImageReader image(data, layout);
+			PE::ImportIndex index(image);
+
+			XSE_CHECK_EQUAL(index.GetModuleCount(), 3u);
+			XSE_CHECK_EQUAL(index.GetEntryCount(), 7u);
+
+			// Module names are matched case-insensitively, function names aren't
+			XSE_CHECK(index.FindSlot("kernel32.DLL", "CreateFileW") == FindSlotLinear(image, "KERNEL32.dll", "CreateFileW", 0));
+			XSE_CHECK(index.FindSlot("KERNEL32.dll", "GetProcAddress").has_value());
+			XSE_CHECK(!index.FindSlot("KERNEL32.dll", "getprocaddress").has_value());
+			XSE_CHECK(index.FindSlot("ws2_32.dll", 23u) == FindSlotLinear(image, "WS2_32.dll", {}, 23));
+			XSE_CHECK(!index.FindSlot("WS2_32.dll", 24u).has_value());
+			XSE_CHECK(!index.FindSlot("USER32.dll", "CreateFileW").has_value());
+			XSE_CHECK(!index.FindSlot("GDI32.dll", "MessageBoxW").has_value());
+			XSE_CHECK(!index.FindSlot("USER32.dll", "").has_value());
+		}
+	}
+}
+
+XSE_TEST(DuplicateImportKeepsFirstSlot)
+{
+	// Same module in two descriptors, and a function listed twice in one of them
+	ImageBuilder builder;
+	builder.AddImport({"KERNEL32.dll", {"Sleep", "GetTickCount", "Sleep"}, {}});
+	builder.AddImport({"USER32.dll", {"MessageBoxW"}, {}});
+	builder.AddImport({"kernel32.dll", {"GetTickCount", "ExitProcess"}, {}});
+
+	const auto data = builder.Build(PE::Layout::Image);
+	PE::ImageReader image(data, PE::Layout::Image);
+	PE::ImportIndex index(image);
+
+	XSE_CHECK_EQUAL(index.GetModuleCount(), 2u);
+	XSE_CHECK(index.FindSlot("KERNEL32.dll", "Sleep") == FindSlotLinear(image, "KERNEL32.dll", "Sleep", 0));
+	XSE_CHECK(index.FindSlot("KERNEL32.dll", "GetTickCount") == FindSlotLinear(image, "KERNEL32.dll", "GetTickCount", 0));
+	XSE_CHECK(index.FindSlot("KERNEL32.dll", "ExitProcess") == FindSlotLinear(image, "kernel32.dll", "ExitProcess", 0));
+}
+
+XSE_TEST(MatchesLinearLookupOnLargeTable)
+{
+	ImageBuilder builder;
+	for (size_t i = 0; i < 20; i++)
+	{
+		ImageBuilder::Import import;
+		import.ModuleName = "Module" + std::to_string(i) + ".dll";
+		for (size_t j = 0; j < 200; j++)
+		{
+			import.Names.push_back("Function" + std::to_string((j * 7919) % 1000));
+		}
+		import.Ordinals = {1, 2, static_cast<uint16_t>(i + 3)};
+		builder.AddImport(std::move(import));
+	}
+
+	const auto data = builder.Build(PE::Layout::Image);
+	PE::ImageReader image(data, PE::Layout::Image);
+	PE::ImportIndex index(image);
+	XSE_CHECK_EQUAL(index.GetEntryCount(), 20u * 203u);
+
+	size_t mismatches = 0;
+	for (size_t i = 0; i < 21; i++)
+	{
+		const std::string moduleName = "module" + std::to_string(i) + ".DLL";
+		for (size_t j = 0; j < 1000; j += 13)
+		{
+			const std::string name = "Function" + std::to_string(j);
+			mismatches += index.FindSlot(moduleName, name) != FindSlotLinear(image, moduleName, name, 0);
+		}
+		for (uint16_t ordinal = 0; ordinal < 25; ordinal++)
+		{
+			mismatches += index.FindSlot(moduleName, uint32_t(ordinal)) != FindSlotLinear(image, moduleName, {}, ordinal);
+		}
+	}
+	XSE_CHECK_EQUAL(mismatches, 0u);
+}
+
+XSE_TEST(EmptyAndMalformedImports)
+{
+	XSE_CHECK(PE::ImportIndex().IsEmpty());
+
+	ImageBuilder withoutImports;
+	withoutImports.AddExport("Function");
+	const auto data = withoutImports.Build(PE::Layout::File);
+	XSE_CHECK(PE::ImportIndex(PE::ImageReader(data, PE::Layout::File)).IsEmpty());
+
+	// The descriptor without a name is left out, the rest is indexed as usual
+	ImageBuilder builder;
+	builder.AddImport({"Broken.dll", {"Function"}, {}, true});
+	builder.AddImport({"KERNEL32.dll", {"Function"}, {}});
+	const auto malformed = builder.Build(PE::Layout::File);
+	PE::ImportIndex index(PE::ImageReader(malformed, PE::Layout::File));
+	XSE_CHECK_EQUAL(index.GetModuleCount(), 1u);
+	XSE_CHECK_EQUAL(index.GetEntryCount(), 1u);
+	XSE_CHECK(index.FindSlot("KERNEL32.dll", "Function").has_value());
+}
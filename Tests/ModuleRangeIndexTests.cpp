@@ -0,0 +1,192 @@
+#include "Test.h"
+#include "ModuleRangeIndex.h"
+#include <thread>
+
+using namespace xSE;
+
+namespace
+{
+	std::string FindName(const ModuleRangeIndex& index, uint64_t address)
+	{
+		std::string name;
+		index.Find(address, [&](const ModuleRange& module)
+		{
+			name = module.Name;
+		});
+		return name;
+	}
+}
+
+XSE_TEST(EmptyIndex)
+{
+	ModuleRangeIndex index;
+	XSE_CHECK_EQUAL(index.GetModuleCount(), 0u);
+	XSE_CHECK(!index.Find(0x10000, [](const ModuleRange&) {}));
+	XSE_CHECK(!index.Remove(0x10000));
+
+	index.Reset({});
+	XSE_CHECK(!index.Find(0, [](const ModuleRange&) {}));
+}
+
+XSE_TEST(RangeBoundaries)
+{
+	ModuleRangeIndex index;
+	index.Reset(
+	{
+		{0x7FF600000000, 0x7FF600050000, "Game.exe"},
+		{0x180000000, 0x180020000, "Plugin.dll"},
+
+		// Right after the previous one, and an empty range
+		{0x180020000, 0x180021000, "Adjacent.dll"},
+		{0x190000000, 0x190000000, "Empty.dll"},
+		{0xFFFFFFFFFFFF0000, 0xFFFFFFFFFFFFFFFF, "Top.dll"}
+	});
+	XSE_CHECK_EQUAL(index.GetModuleCount(), 5u);
+
+	XSE_CHECK_EQUAL(FindName(index, 0x180000000), "Plugin.dll");
+	XSE_CHECK_EQUAL(FindName(index, 0x18001FFFF), "Plugin.dll");
+	XSE_CHECK_EQUAL(FindName(index, 0x180020000), "Adjacent.dll");
+	XSE_CHECK_EQUAL(FindName(index, 0x180020FFF), "Adjacent.dll");
+	XSE_CHECK_EQUAL(FindName(index, 0x7FF600012345), "Game.exe");
+	XSE_CHECK_EQUAL(FindName(index, 0xFFFFFFFFFFFFFFFE), "Top.dll");
+
+	// The end is exclusive
+	XSE_CHECK_EQUAL(FindName(index, 0x180021000), "");
+	XSE_CHECK_EQUAL(FindName(index, 0x7FF600050000), "");
+	XSE_CHECK_EQUAL(FindName(index, 0xFFFFFFFFFFFFFFFF), "");
+
+	XSE_CHECK_EQUAL(FindName(index, 0), "");
+	XSE_CHECK_EQUAL(FindName(index, 0x17FFFFFFF), "");
+	XSE_CHECK_EQUAL(FindName(index, 0x190000000), "");
+	XSE_CHECK_EQUAL(FindName(index, 0x1A0000000), "");
+}
+
+XSE_TEST(AddAndRemove)
+{
+	ModuleRangeIndex index;
+	index.Add({0x20000, 0x30000, "Second.dll"});
+	index.Add({0x10000, 0x18000, "First.dll"});
+	XSE_CHECK_EQUAL(index.GetModuleCount(), 2u);
+	XSE_CHECK_EQUAL(FindName(index, 0x10000), "First.dll");
+
+	// Same base address, a module unloaded and something else loaded in its place
+	index.Add({0x10000, 0x20000, "Replacement.dll"});
+	XSE_CHECK_EQUAL(index.GetModuleCount(), 2u);
+	XSE_CHECK_EQUAL(FindName(index, 0x1C000), "Replacement.dll");
+
+	XSE_CHECK(!index.Remove(0x10001));
+	XSE_CHECK(index.Remove(0x10000));
+	XSE_CHECK(!index.Remove(0x10000));
+	XSE_CHECK_EQUAL(FindName(index, 0x10000), "");
+	XSE_CHECK_EQUAL(FindName(index, 0x20000), "Second.dll");
+
+	// Reset drops the added modules
+	index.Reset({{0x40000, 0x50000, "Other.dll"}});
+	XSE_CHECK_EQUAL(index.GetModuleCount(), 1u);
+	XSE_CHECK_EQUAL(FindName(index, 0x20000), "");
+}
+
+XSE_TEST(ModuleOrderDoesNotMatter)
+{
+	std::vector<ModuleRange> modules;
+	for (uint64_t i = 0; i < 1000; i++)
+	{
+		const uint64_t begin = 0x10000000 + ((i * 7919) % 1000) * 0x100000;
+		modules.push_back({begin, begin + 0x80000, "Module" + std::to_string(begin) + ".dll"});
+	}
+
+	ModuleRangeIndex index;
+	index.Reset(modules);
+
+	size_t mismatches = 0;
+	for (const ModuleRange& module: modules)
+	{
+		mismatches += FindName(index, module.Begin) != module.Name;
+		mismatches += FindName(index, module.End - 1) != module.Name;
+		mismatches += !FindName(index, module.End).empty();
+	}
+	XSE_CHECK_EQUAL(mismatches, 0u);
+}
+
+XSE_TEST(ConcurrentChangesAndLookups)
+{
+	// Readers look up addresses while a writer keeps loading and unloading modules. The modules loaded at the start
+	// have to be found all the time, the others either found with the right name or not found at all. The replaced
+	// snapshots are freed while the readers run, the sanitizer builds catch it if one is freed too early.
+	constexpr size_t readerCount = 3;
+	constexpr size_t stableCount = 64;
+	constexpr size_t changeCount = 5000;
+
+	auto MakeModule = [](uint64_t i)
+	{
+		const uint64_t begin = 0x100000000 + i * 0x10000;
+		return ModuleRange{begin, begin + 0x8000, "Module" + std::to_string(i) + ".dll"};
+	};
+
+	ModuleRangeIndex index;
+	std::vector<ModuleRange> stable;
+	for (size_t i = 0; i < stableCount; i++)
+	{
+		stable.push_back(MakeModule(i * 2));
+	}
+	index.Reset(stable);
+
+	std::atomic<bool> done = false;
+	std::atomic<size_t> errors = 0;
+	std::atomic<size_t> lookups = 0;
+	std::vector<std::thread> readers;
+	for (size_t i = 0; i < readerCount; i++)
+	{
+		readers.emplace_back([&, i]()
+		{
+			for (uint64_t j = i; !done.load(std::memory_order_relaxed); j++)
+			{
+				const uint64_t moduleIndex = j % (stableCount * 2);
+				const ModuleRange expected = MakeModule(moduleIndex);
+
+				bool nameMatches = false;
+				const bool found = index.Find(expected.Begin + j % 0x8000, [&](const ModuleRange& module) noexcept
+				{
+					nameMatches = module.Name == expected.Name && module.Begin == expected.Begin && module.End == expected.End;
+				});
+				if ((moduleIndex % 2 == 0 && !found) || (found && !nameMatches) || index.Find(expected.End, [](const ModuleRange&) noexcept {}))
+				{
+					errors.fetch_add(1, std::memory_order_relaxed);
+				}
+				lookups.fetch_add(1, std::memory_order_relaxed);
+			}
+		});
+	}
+
+	for (size_t i = 0; i < changeCount; i++)
+	{
+		const uint64_t moduleIndex = (i % stableCount) * 2 + 1;
+		if (i % 3 == 2)
+		{
+			index.Remove(MakeModule(moduleIndex).Begin);
+		}
+		else
+		{
+			index.Add(MakeModule(moduleIndex));
+		}
+	}
+
+	// Let the readers see the final state too
+	const size_t lookupsBefore = lookups.load();
+	while (lookups.load() < lookupsBefore + readerCount * 100)
+	{
+		std::this_thread::yield();
+	}
+	done = true;
+	for (std::thread& reader: readers)
+	{
+		reader.join();
+	}
+
+	XSE_CHECK_EQUAL(errors.load(), 0u);
+	XSE_CHECK(index.GetModuleCount() >= stableCount);
+	for (const ModuleRange& module: stable)
+	{
+		XSE_CHECK_EQUAL(FindName(index, module.Begin), module.Name);
+	}
+}
@@ -0,0 +1,145 @@
+#include "Test.h"
+#include "ImageBuilder.h"
+#include "PluginDependencyGraph.h"
+#include "PortableExecutable.h"
+
+using namespace xSE;
+using Testing::ImageBuilder;
+
+namespace
+{
+	using Order = std::vector<size_t>;
+
+	std::string MakePluginName(size_t index)
+	{
+		std::string name = "p";
+		name += std::to_string(index);
+		name += ".dll";
+		return name;
+	}
+}
+
+XSE_TEST(IndependentNodesKeepTheirOrder)
+{
+	PluginDependencyGraph graph;
+	graph.AddNode("c.dll", {"KERNEL32.dll"});
+	graph.AddNode("a.dll", {});
+	graph.AddNode("b.dll", {"USER32.dll"});
+
+	const auto result = graph.Sort();
+	XSE_CHECK(result.Order == Order({0, 1, 2}));
+	XSE_CHECK(result.Cycles.empty());
+}
+
+XSE_TEST(DependenciesGoFirst)
+{
+	PluginDependencyGraph graph;
+	graph.AddNode("Plugin.dll", {"KERNEL32.dll", "Library.DLL"});
+	graph.AddNode("Other.dll", {});
+	graph.AddNode("library.dll", {"Base.dll"});
+	graph.AddNode("Base.dll", {});
+
+	// Names are matched case-insensitively, unknown imports are left to the system loader
+	XSE_CHECK(graph.GetDependencies(0) == Order({2}));
+	XSE_CHECK(graph.GetDependencies(2) == Order({3}));
+
+	// 'Other.dll' is ready from the start and has a lower index than 'Base.dll'
+	const auto result = graph.Sort();
+	XSE_CHECK(result.Order == Order({1, 3, 2, 0}));
+}
+
+XSE_TEST(TieBreakByLowestIndex)
+{
+	PluginDependencyGraph graph;
+	graph.AddNode("d.dll", {"a.dll"});
+	graph.AddNode("c.dll", {});
+	graph.AddNode("b.dll", {});
+	graph.AddNode("a.dll", {"b.dll"});
+
+	XSE_CHECK(graph.Sort().Order == Order({1, 2, 3, 0}));
+}
+
+XSE_TEST(CyclesAreGroupedInOriginalOrder)
+{
+	PluginDependencyGraph graph;
+	graph.AddNode("x.dll", {"c.dll"});
+	graph.AddNode("b.dll", {"c.dll"});
+	graph.AddNode("a.dll", {"b.dll", "base.dll"});
+	graph.AddNode("c.dll", {"a.dll"});
+	graph.AddNode("base.dll", {"base.dll"});
+	graph.AddNode("e.dll", {"f.dll"});
+	graph.AddNode("f.dll", {"e.dll"});
+
+	const auto result = graph.Sort();
+	XSE_REQUIRE(result.Cycles.size() == 2);
+	XSE_CHECK(std::ranges::count(result.Cycles, Order({1, 2, 3})) == 1);
+	XSE_CHECK(std::ranges::count(result.Cycles, Order({5, 6})) == 1);
+
+	// Importing itself isn't a cycle. The 'b, a, c' group waits for 'base.dll' and 'x.dll' waits for the group.
+	XSE_CHECK(result.Order == Order({4, 1, 2, 3, 0, 5, 6}));
+}
+
+XSE_TEST(DuplicateNamesResolveToFirst)
+{
+	PluginDependencyGraph graph;
+	graph.AddNode("Plugin.dll", {"Shared.dll"});
+	graph.AddNode("Shared.dll", {});
+	graph.AddNode("shared.dll", {});
+
+	XSE_CHECK(graph.GetDependencies(0) == Order({1}));
+	XSE_CHECK(graph.Sort().Order == Order({1, 0, 2}));
+}
+
+XSE_TEST(LongChain)
+{
+	constexpr size_t count = 2000;
+
+	PluginDependencyGraph graph;
+	for (size_t i = 0; i < count; i++)
+	{
+		graph.AddNode(MakePluginName(i), {MakePluginName(i + 1)});
+	}
+
+	const auto result = graph.Sort();
+	XSE_REQUIRE(result.Order.size() == count);
+	XSE_CHECK_EQUAL(result.Order.front(), count - 1);
+	XSE_CHECK_EQUAL(result.Order.back(), 0u);
+}
+
+XSE_TEST(ImportDescriptorWithoutName)
+{
+	// A zero name RVA must not be read as the string at the image base ('MZ'), the descriptor is skipped instead
+	for (bool is64Bit: {false, true})
+	{
+		ImageBuilder builder(is64Bit);
+		builder.AddImport({"Library.dll", {"Function"}, {}});
+		builder.AddImport({"Broken.dll", {"Function"}, {7}, true});
+		builder.AddImport({"KERNEL32.dll", {"GetProcAddress"}, {}});
+
+		const auto data = builder.Build(PE::Layout::File);
+		PE::ImageReader image(data, PE::Layout::File);
+		XSE_REQUIRE(!image.IsNull());
+
+		std::vector<std::string> modules;
+		image.EnumImportedModules([&](std::string_view moduleName)
+		{
+			modules.emplace_back(moduleName);
+			return true;
+		});
+		XSE_CHECK(modules == std::vector<std::string>({"Library.dll", "KERNEL32.dll"}));
+
+		size_t importCount = 0;
+		image.EnumImports([&](const PE::ImportEntry& entry)
+		{
+			XSE_CHECK(!entry.ModuleName.empty());
+			importCount++;
+			return true;
+		});
+		XSE_CHECK_EQUAL(importCount, 2u);
+
+		PluginDependencyGraph graph;
+		graph.AddNode("Plugin.dll", std::vector<std::string>(modules.begin(), modules.end()));
+		graph.AddNode("Library.dll", {});
+		XSE_CHECK(graph.Sort().Order == Order({1, 0}));
+	}
+}
@@ -0,0 +1,122 @@
+#include "Test.h"
+#include "PluginListStream.h"
+#include <cstring>
+
+using namespace xSE;
+using namespace std::chrono_literals;
+
+namespace
+{
+	using Entry = PluginListStream::Entry;
+	using LoadState = PluginListStream::LoadState;
+
+	std::vector<Entry> MakeEntries()
+	{
+		return
+		{
+			{"EngineFixes.dll", LoadState::Initialized, 1250us, 3ms},
+			{"Plugin.dll", LoadState::Loaded, 800us, 0ns},
+
+			// Name lengths which need all the paddings, and a non-ASCII one
+			{"abc", LoadState::FailedLoad, 0ns, 0ns},
+			{"abcdef", LoadState::FailedInitialize, 2ms, 15ms},
+			{"\xD0\x9F\xD0\xBB\xD0\xB0\xD0\xB3\xD0\xB8\xD0\xBD.dll", LoadState::Loading, 40us, 0ns},
+			{"", LoadState::Loaded, 1ns, 1ns}
+		};
+	}
+
+	void WriteUInt32(std::vector<std::byte>& data, size_t offset, uint32_t value)
+	{
+		for (size_t i = 0; i < sizeof(value); i++)
+		{
+			data[offset + i] = static_cast<std::byte>(value >> (i * 8));
+		}
+	}
+}
+
+XSE_TEST(RoundTrip)
+{
+	const auto entries = MakeEntries();
+	const auto data = PluginListStream::Encode(entries);
+	XSE_CHECK_EQUAL(data.size() % 4, 0u);
+
+	const auto decoded = PluginListStream::Decode(data);
+	XSE_REQUIRE(decoded);
+	XSE_CHECK(*decoded == entries);
+
+	const auto empty = PluginListStream::Decode(PluginListStream::Encode({}));
+	XSE_REQUIRE(empty);
+	XSE_CHECK(empty->empty());
+}
+
+XSE_TEST(EncodedLayout)
+{
+	const Entry entries[] = {{"abcde", LoadState::Initialized, 0x0102ns, 0x0304ns}};
+	const auto data = PluginListStream::Encode(entries);
+
+	const uint8_t expected[] =
+	{
+		// Signature 'xSPL', version, entry count, reserved
+		'x', 'S', 'P', 'L', 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0,
+
+		// State, load time, initialization time, name length, name padded to eight bytes
+		2, 0, 0, 0, 0x02, 0x01, 0, 0, 0, 0, 0, 0, 0x04, 0x03, 0, 0, 0, 0, 0, 0, 5, 0, 0, 0,
+		'a', 'b', 'c', 'd', 'e', 0, 0, 0
+	};
+	XSE_REQUIRE(data.size() == sizeof(expected));
+	XSE_CHECK(std::memcmp(data.data(), expected, sizeof(expected)) == 0);
+}
+
+XSE_TEST(TruncatedInput)
+{
+	// Every prefix is rejected, whether it ends in the header, in an entry header or in a name
+	const auto data = PluginListStream::Encode(MakeEntries());
+	size_t accepted = 0;
+	for (size_t size = 0; size < data.size(); size++)
+	{
+		accepted += PluginListStream::Decode(std::span(data).first(size)).has_value();
+	}
+	XSE_CHECK_EQUAL(accepted, 0u);
+}
+
+XSE_TEST(BadHeader)
+{
+	const auto valid = PluginListStream::Encode(MakeEntries());
+
+	auto badSignature = valid;
+	badSignature[0] = std::byte('X');
+	XSE_CHECK(!PluginListStream::Decode(badSignature));
+
+	for (uint32_t version: {0u, PluginListStream::Version + 1, 0xFFFFFFFFu})
+	{
+		auto badVersion = valid;
+		WriteUInt32(badVersion, 4, version);
+		XSE_CHECK(!PluginListStream::Decode(badVersion));
+	}
+
+	// More entries than the data could hold, rejected before anything is allocated for them
+	auto badCount = valid;
+	WriteUInt32(badCount, 8, 0xFFFFFFFF);
+	XSE_CHECK(!PluginListStream::Decode(badCount));
+}
+
+XSE_TEST(BadEntry)
+{
+	const auto valid = PluginListStream::Encode(MakeEntries());
+
+	auto badState = valid;
+	WriteUInt32(badState, 16, static_cast<uint32_t>(LoadState::FailedInitialize) + 1);
+	XSE_CHECK(!PluginListStream::Decode(badState));
+
+	// Name running past the end of the data
+	auto badLength = valid;
+	WriteUInt32(badLength, 16 + 20, 0xFFFFFFFF);
+	XSE_CHECK(!PluginListStream::Decode(badLength));
+
+	// Fewer entries than written: the rest is ignored
+	auto fewerEntries = valid;
+	WriteUInt32(fewerEntries, 8, 1);
+	const auto decoded = PluginListStream::Decode(fewerEntries);
+	XSE_REQUIRE(decoded && decoded->size() == 1);
+	XSE_CHECK(decoded->front() == MakeEntries().front());
+}
@@ -0,0 +1,98 @@
+#include "Test.h"
+#include "PluginScanIndex.h"
+
+using namespace xSE;
+
+namespace
+{
+	PluginProbeResult MakePluginResult()
+	{
+		PluginProbeResult result;
+		result.IsValidImage = true;
+		result.HasPreloadFunction = true;
+		result.ImportedModules = {"KERNEL32.dll", "f4se_1_10_163.dll"};
+		return result;
+	}
+}
+
+XSE_TEST(FindRequiresMatchingStamp)
+{
+	PluginScanIndex index("sig");
+	index.Update("Data/F4SE/Plugins/a.dll", {100, 5}, MakePluginResult());
+
+	XSE_CHECK(index.Find("Data/F4SE/Plugins/a.dll", {100, 5}) == MakePluginResult());
+	XSE_CHECK(!index.Find("Data/F4SE/Plugins/a.dll", {100, 6}).has_value());
+	XSE_CHECK(!index.Find("Data/F4SE/Plugins/a.dll", {101, 5}).has_value());
+	XSE_CHECK(!index.Find("Data/F4SE/Plugins/b.dll", {100, 5}).has_value());
+	XSE_CHECK_EQUAL(index.GetHitCount(), 1u);
+	XSE_CHECK_EQUAL(index.GetMissCount(), 3u);
+}
+
+XSE_TEST(RoundTripKeepsOnlyUsedEntries)
+{
+	PluginScanIndex index("sig");
+	index.Update("a.dll", {1, 1}, MakePluginResult());
+	index.Update("b.dll", {2, 2}, {});
+	const auto data = index.Serialize();
+
+	PluginScanIndex loaded("sig");
+	XSE_REQUIRE(loaded.Deserialize(data));
+	XSE_CHECK_EQUAL(loaded.GetCount(), 2u);
+
+	// 'b.dll' is never asked for because it's gone, the index has to be rewritten without it
+	XSE_CHECK(loaded.Find("a.dll", {1, 1}) == MakePluginResult());
+	XSE_CHECK(loaded.IsModified());
+
+	PluginScanIndex reloaded("sig");
+	XSE_REQUIRE(reloaded.Deserialize(loaded.Serialize()));
+	XSE_CHECK_EQUAL(reloaded.GetCount(), 1u);
+	XSE_CHECK(reloaded.Find("a.dll", {1, 1}).has_value());
+	XSE_CHECK(!reloaded.IsModified());
+}
+
+XSE_TEST(RejectsOtherSignatureAndDamagedData)
+{
+	PluginScanIndex index("game 1.10.163, preload.xml 1234");
+	index.Update("a.dll", {1, 1}, MakePluginResult());
+	auto data = index.Serialize();
+
+	PluginScanIndex otherSignature("game 1.10.163, preload.xml 1235");
+	XSE_CHECK(!otherSignature.Deserialize(data));
+	XSE_CHECK_EQUAL(otherSignature.GetCount(), 0u);
+
+	for (size_t size = 0; size < data.size(); size++)
+	{
+		PluginScanIndex truncated(index.GetSignature());
+		XSE_CHECK(!truncated.Deserialize(std::span(data.data(), size)));
+		XSE_CHECK_EQUAL(truncated.GetCount(), 0u);
+	}
+
+	data.push_back(std::byte{0});
+	PluginScanIndex trailing(index.GetSignature());
+	XSE_CHECK(!trailing.Deserialize(data));
+}
+
+XSE_TEST(FailedProbeIsNotCached)
+{
+	// The plugin was indexed on an earlier launch, then updated and couldn't be read this time
+	PluginScanIndex index("sig");
+	index.Update("a.dll", {1, 1}, MakePluginResult());
+	index.Update("b.dll", {2, 2}, MakePluginResult());
+
+	PluginScanIndex loaded("sig");
+	XSE_REQUIRE(loaded.Deserialize(index.Serialize()));
+	XSE_CHECK(loaded.Find("a.dll", {1, 1}).has_value());
+	XSE_CHECK(!loaded.Find("b.dll", {3, 3}).has_value());
+	loaded.Discard("b.dll");
+	loaded.Discard("c.dll");
+	XSE_CHECK(loaded.IsModified());
+
+	// Probed again on the next launch, with the same stamp it had when the probe failed
+	PluginScanIndex reloaded("sig");
+	XSE_REQUIRE(reloaded.Deserialize(loaded.Serialize()));
+	XSE_CHECK_EQUAL(reloaded.GetCount(), 1u);
+	XSE_CHECK(!reloaded.Find("b.dll", {3, 3}).has_value());
+	XSE_CHECK(!reloaded.Find("b.dll", {2, 2}).has_value());
+	XSE_CHECK(!reloaded.Find("c.dll", {1, 1}).has_value());
+	XSE_CHECK(reloaded.Find("a.dll", {1, 1}) == MakePluginResult());
+}
@@ -0,0 +1,211 @@
+#include "Test.h"
+#include "ImageBuilder.h"
+#include "PortableExecutable.h"
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+using namespace xSE;
+using Testing::ImageBuilder;
+
+namespace
+{
+	constexpr PE::Layout g_Layouts[] = {PE::Layout::File, PE::Layout::Image};
+
+	ImageBuilder MakeExportsImage(bool is64Bit)
+	{
+		ImageBuilder builder(is64Bit);
+		builder.SetOrdinalBase(10);
+		builder.AddExport("Initialize");
+		builder.AddExport("F4SEPlugin_Load");
+		builder.AddExport("F4SEPlugin_Preload");
+		builder.AddExport("F4SEPlugin_Query");
+		builder.AddForwardedExport("HeapAlloc", "NTDLL.RtlAllocateHeap");
+		builder.AddExport({}, 20);
+		builder.AddExport("_private");
+		builder.AddExport("zeta", 25);
+		return builder;
+	}
+}
+
+XSE_TEST(HeadersOfBothFormats)
+{
+	for (bool is64Bit: {false, true})
+	{
+		for (PE::Layout layout: g_Layouts)
+		{
+			const auto data = MakeExportsImage(is64Bit).Build(layout);
+			PE::ImageReader image(data, layout);
+
+			XSE_REQUIRE(!image.IsNull());
+			XSE_CHECK_EQUAL(image.Is64Bit(), is64Bit);
+			XSE_CHECK_EQUAL(image.GetMachine(), is64Bit ? 0x8664 : 0x14C);
+			XSE_CHECK_EQUAL(image.GetLayout(), layout);
+			XSE_CHECK(image.GetDirectory(PE::DirectoryID::Export));
+			XSE_CHECK(!image.GetDirectory(PE::DirectoryID::Import));
+		}
+	}
+}
+
+XSE_TEST(FindExportByName)
+{
+	for (PE::Layout layout: g_Layouts)
+	{
+		auto data = MakeExportsImage(true).Build(layout);
+		PE::ImageReader image(data, layout);
+
+		XSE_CHECK_EQUAL(image.GetExportOrdinalBase(), 10u);
+		XSE_CHECK_EQUAL(image.GetExportNameCount(), 7u);
+		XSE_CHECK_EQUAL(image.GetExportFunctionCount(), 16u);
+
+		const auto preload = image.FindExport("F4SEPlugin_Preload");
+		XSE_REQUIRE(preload.has_value());
+		XSE_CHECK_EQUAL(preload->Name, "F4SEPlugin_Preload");
+		XSE_CHECK_EQUAL(preload->Ordinal, 12u);
+		XSE_CHECK_EQUAL(preload->RVA, ImageBuilder::GetFunctionRVA(12, 10));
+		XSE_CHECK(!preload->IsForwarded);
+
+		// First and last in the sorted order, names are compared as plain bytes so '_' goes after the capitals
+		XSE_CHECK(image.FindExport("F4SEPlugin_Load").has_value());
+		XSE_CHECK(image.FindExport("zeta").has_value());
+		XSE_CHECK(image.FindExport("_private").has_value());
+
+		XSE_CHECK(!image.FindExport("F4SEPlugin_preload").has_value());
+		XSE_CHECK(!image.FindExport("F4SEPlugin_Preload2").has_value());
+		XSE_CHECK(!image.FindExport("A").has_value());
+		XSE_CHECK(!image.FindExport("zz").has_value());
+		XSE_CHECK(!image.FindExport("").has_value());
+		XSE_CHECK(image.ContainsExport("Initialize"));
+	}
+}
+
+XSE_TEST(FindExportByOrdinal)
+{
+	auto data = MakeExportsImage(false).Build(PE::Layout::File);
+	PE::ImageReader image(data, PE::Layout::File);
+
+	const auto byOrdinal = image.FindExport(12u);
+	XSE_REQUIRE(byOrdinal.has_value());
+	XSE_CHECK_EQUAL(byOrdinal->RVA, ImageBuilder::GetFunctionRVA(12, 10));
+	XSE_CHECK(byOrdinal->Name.empty());
+
+	// Exported only by ordinal
+	const auto nameless = image.FindExport(20u);
+	XSE_REQUIRE(nameless.has_value());
+	XSE_CHECK_EQUAL(nameless->RVA, ImageBuilder::GetFunctionRVA(20, 10));
+
+	// Below the base, in a gap of the address table and past its end
+	XSE_CHECK(!image.FindExport(9u).has_value());
+	XSE_CHECK(!image.FindExport(22u).has_value());
+	XSE_CHECK(image.FindExport(25u).has_value());
+	XSE_CHECK(!image.FindExport(26u).has_value());
+}
+
+XSE_TEST(ForwardedExports)
+{
+	for (PE::Layout layout: g_Layouts)
+	{
+		auto data = MakeExportsImage(true).Build(layout);
+		PE::ImageReader image(data, layout);
+
+		const auto forwarded = image.FindExport("HeapAlloc");
+		XSE_REQUIRE(forwarded.has_value());
+		XSE_CHECK(forwarded->IsForwarded);
+		XSE_CHECK_EQUAL(image.GetStringAt(forwarded->RVA), "NTDLL.RtlAllocateHeap");
+
+		const auto byOrdinal = image.FindExport(forwarded->Ordinal);
+		XSE_REQUIRE(byOrdinal.has_value());
+		XSE_CHECK(byOrdinal->IsForwarded);
+	}
+}
+
+XSE_TEST(EnumExportsInNameOrder)
+{
+	auto data = MakeExportsImage(true).Build(PE::Layout::Image);
+	PE::ImageReader image(data, PE::Layout::Image);
+
+	std::vector<std::string> names;
+	const size_t count = image.EnumExports([&](const PE::ExportEntry& entry)
+	{
+		names.emplace_back(entry.Name);
+		return true;
+	});
+	XSE_CHECK_EQUAL(count, 7u);
+	XSE_CHECK(std::ranges::is_sorted(names));
+	XSE_CHECK(std::ranges::find(names, "HeapAlloc") != names.end());
+
+	// Stops as soon as the function returns false
+	size_t visited = 0;
+	image.EnumExports([&](const PE::ExportEntry&)
+	{
+		return ++visited != 2;
+	});
+	XSE_CHECK_EQUAL(visited, 2u);
+}
+
+XSE_TEST(ImageWithoutExports)
+{
+	ImageBuilder builder;
+	builder.AddImport({"KERNEL32.dll", {"GetCommandLineA"}, {}});
+
+	auto data = builder.Build(PE::Layout::File);
+	PE::ImageReader image(data, PE::Layout::File);
+	XSE_REQUIRE(!image.IsNull());
+	XSE_CHECK_EQUAL(image.GetExportNameCount(), 0u);
+	XSE_CHECK(!image.FindExport("GetCommandLineA").has_value());
+	XSE_CHECK(!image.FindExport(1u).has_value());
+	XSE_CHECK_EQUAL(image.EnumExports([](const PE::ExportEntry&) { return true; }), 0u);
+}
+
+XSE_TEST(RejectsNonImages)
+{
+	std::vector<std::byte> empty;
+	XSE_CHECK(PE::ImageReader(empty, PE::Layout::File).IsNull());
+
+	std::vector<std::byte> garbage(4096, std::byte{0x5A});
+	XSE_CHECK(PE::ImageReader(garbage, PE::Layout::File).IsNull());
+
+	// Valid DOS header pointing past the end
+	auto data = MakeExportsImage(true).Build(PE::Layout::File);
+	data[0x3C] = std::byte{0xFF};
+	data[0x3D] = std::byte{0xFF};
+	XSE_CHECK(PE::ImageReader(data, PE::Layout::File).IsNull());
+}
+
+XSE_TEST(TruncatedImagesAreSafe)
+{
+	const auto data = MakeExportsImage(true).Build(PE::Layout::File);
+
+	// Every prefix either fails to parse or gives a subset of the exports, reads never go past the end
+	for (size_t size = 0; size <= data.size(); size += 7)
+	{
+		std::span<const std::byte> truncated(data.data(), size);
+		PE::ImageReader image(truncated, PE::Layout::File);
+
+		// Names cut off by the end of the data come out empty
+		const size_t count = image.EnumExports([](const PE::ExportEntry&)
+		{
+			return true;
+		});
+		XSE_CHECK(count <= 7);
+		if (image.FindExport("zeta"))
+		{
+			XSE_CHECK(size > 0x400);
+		}
+	}
+}
+
+XSE_TEST(CorruptedExportDirectory)
+{
+	auto data = MakeExportsImage(true).Build(PE::Layout::Image);
+	const uint32_t directoryRVA = PE::ImageReader(data, PE::Layout::Image).GetDirectory(PE::DirectoryID::Export).RVA;
+
+	// Name count way past the end of the image, the tables have to be rejected as a whole
+	const uint32_t nameCount = 0x10000000;
+	std::memcpy(data.data() + directoryRVA + 24, &nameCount, sizeof(nameCount));
+
+	PE::ImageReader image(data, PE::Layout::Image);
+	XSE_REQUIRE(!image.IsNull());
+	XSE_CHECK_EQUAL(image.GetExportNameCount(), 0u);
+	XSE_CHECK(!image.FindExport("zeta").has_value());
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Helpers for the benchmark executables. They're registered with CTest with '--quick', which scales the work down
+// so the gate only checks that they still run; run them directly for the actual numbers.
+namespace xSE::Testing
+{
+	class BenchmarkOptions final
+	{
+		public:
+			bool Quick = false;
+
+			// Everything else on the command line, such as paths of input files
+			std::vector<std::string> Arguments;
+
+		public:
+			BenchmarkOptions(int argc, char** argv)
+			{
+				for (int i = 1; i < argc; i++)
+				{
+					if (std::string_view(argv[i]) == "--quick")
+					{
+						Quick = true;
+					}
+					else
+					{
+						Arguments.emplace_back(argv[i]);
+					}
+				}
+			}
+
+		public:
+			size_t Scale(size_t count) const noexcept
+			{
+				return Quick ? std::max<size_t>(count / 100, 1) : count;
+			}
+	};
+
+	template<class T>
+	void DoNotOptimize(const T& value) noexcept
+	{
+		#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r,m"(value) : "memory");
+		#else
+		const volatile void* sink = &value;
+		(void)sink;
+		#endif
+	}
+
+	// Best time per iteration out of several runs, in nanoseconds
+	template<class TFunc>
+	double MeasureNanoseconds(size_t iterations, TFunc&& func, size_t runs = 5)
+	{
+		using Clock = std::chrono::steady_clock;
+
+		double best = 0;
+		for (size_t run = 0; run < runs; run++)
+		{
+			const auto start = Clock::now();
+			for (size_t i = 0; i < iterations; i++)
+			{
+				func(i);
+			}
+			const auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / static_cast<double>(std::max<size_t>(iterations, 1));
+			best = run == 0 ? elapsed : std::min(best, elapsed);
+		}
+		return best;
+	}
+
+	inline void PrintResult(std::string_view name, double nanoseconds, std::string_view unit = "op")
+	{
+		std::printf("%-56.*s %12.1f ns/%.*s\n", static_cast<int>(name.size()), name.data(), nanoseconds, static_cast<int>(unit.size()), unit.data());
+	}
+}
@@ -0,0 +1,24 @@
+#include "ExportManifest.h"
+#include <fstream>
+
+namespace xSE::Testing
+{
+	std::vector<std::string> ReadExportManifest(std::string_view libraryName)
+	{
+		std::ifstream stream(std::string(XSE_PROXY_FUNCTIONS_DIR) + '/' + std::string(libraryName) + ".exports");
+
+		std::vector<std::string> names;
+		std::string line;
+		while (std::getline(stream, line))
+		{
+			const size_t first = line.find_first_not_of(" \t\r");
+			if (first == std::string::npos || line[first] == '#')
+			{
+				continue;
+			}
+			const size_t last = line.find_last_not_of(" \t\r");
+			names.emplace_back(line.substr(first, last - first + 1));
+		}
+		return names;
+	}
+}
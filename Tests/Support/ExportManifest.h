@@ -0,0 +1,11 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Reads 'Source/ProxyFunctions/<Library>.exports', the list of the proxied library exports in ordinal order
+// (the format is described in 'Tools/GenerateProxyFunctions.py'). Returns an empty list if the file can't be read.
+namespace xSE::Testing
+{
+	std::vector<std::string> ReadExportManifest(std::string_view libraryName);
+}
@@ -0,0 +1,249 @@
+#include "ImageBuilder.h"
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <set>
+#include <span>
+
+namespace
+{
+	constexpr uint32_t g_HeadersSize = 0x400;
+	constexpr uint32_t g_SectionRVA = 0x1000;
+	constexpr uint32_t g_SectionAlignment = 0x1000;
+	constexpr uint32_t g_FileAlignment = 0x200;
+	constexpr uint32_t g_NTHeadersOffset = 0x80;
+
+	uint32_t AlignUp(uint32_t value, uint32_t alignment) noexcept
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	class Writer final
+	{
+		private:
+			std::vector<std::byte>& m_Data;
+			uint32_t m_BaseRVA = 0;
+
+		public:
+			Writer(std::vector<std::byte>& data, uint32_t baseRVA = 0) noexcept
+				:m_Data(data), m_BaseRVA(baseRVA)
+			{
+			}
+
+		public:
+			uint32_t GetRVA() const noexcept
+			{
+				return m_BaseRVA + static_cast<uint32_t>(m_Data.size());
+			}
+			uint32_t Reserve(size_t size)
+			{
+				const uint32_t rva = GetRVA();
+				m_Data.resize(m_Data.size() + size);
+				return rva;
+			}
+			void Align(size_t alignment)
+			{
+				m_Data.resize((m_Data.size() + alignment - 1) / alignment * alignment);
+			}
+			uint32_t AddString(std::string_view value)
+			{
+				const uint32_t rva = GetRVA();
+				const auto bytes = std::as_bytes(std::span(value));
+				m_Data.insert(m_Data.end(), bytes.begin(), bytes.end());
+				m_Data.push_back(std::byte(0));
+				return rva;
+			}
+
+			template<class T>
+			void Put(uint32_t rva, T value) noexcept
+			{
+				std::memcpy(m_Data.data() + (rva - m_BaseRVA), &value, sizeof(value));
+			}
+	};
+}
+
+namespace xSE::Testing
+{
+	std::vector<std::byte> ImageBuilder::Build(PE::Layout layout) const
+	{
+		std::vector<std::byte> section;
+		Writer writer(section, g_SectionRVA);
+
+		PE::DataDirectory exportDirectory;
+		if (!m_Exports.empty())
+		{
+			// Ordinals: the explicit ones are kept, the rest get the lowest free ones in the order of addition
+			std::vector<uint32_t> ordinals(m_Exports.size());
+			std::set<uint32_t> usedOrdinals;
+			for (size_t i = 0; i < m_Exports.size(); i++)
+			{
+				ordinals[i] = m_Exports[i].Ordinal;
+				usedOrdinals.insert(m_Exports[i].Ordinal);
+			}
+
+			uint32_t nextOrdinal = m_OrdinalBase;
+			for (uint32_t& ordinal: ordinals)
+			{
+				if (ordinal == 0)
+				{
+					while (usedOrdinals.contains(nextOrdinal))
+					{
+						nextOrdinal++;
+					}
+					ordinal = nextOrdinal++;
+				}
+			}
+			const uint32_t functionCount = *std::ranges::max_element(ordinals) - m_OrdinalBase + 1;
+
+			// The name pointer table is sorted as plain byte strings
+			std::map<std::string, uint32_t> names;
+			for (size_t i = 0; i < m_Exports.size(); i++)
+			{
+				if (!m_Exports[i].Name.empty())
+				{
+					names.emplace(m_Exports[i].Name, ordinals[i]);
+				}
+			}
+
+			const uint32_t directoryRVA = writer.Reserve(40);
+			const uint32_t moduleNameRVA = writer.AddString(m_ModuleName);
+			writer.Align(4);
+			const uint32_t functionsRVA = writer.Reserve(functionCount * sizeof(uint32_t));
+			const uint32_t namesRVA = writer.Reserve(names.size() * sizeof(uint32_t));
+			const uint32_t nameOrdinalsRVA = writer.Reserve(names.size() * sizeof(uint16_t));
+
+			uint32_t nameIndex = 0;
+			for (const auto& [name, ordinal]: names)
+			{
+				writer.Put<uint32_t>(namesRVA + nameIndex * sizeof(uint32_t), writer.AddString(name));
+				writer.Put<uint16_t>(nameOrdinalsRVA + nameIndex * sizeof(uint16_t), static_cast<uint16_t>(ordinal - m_OrdinalBase));
+				nameIndex++;
+			}
+
+			// Forwarder strings have to be inside the directory range, that's how they're told apart from code
+			for (size_t i = 0; i < m_Exports.size(); i++)
+			{
+				const uint32_t functionRVA = m_Exports[i].Forwarder.empty() ? GetFunctionRVA(ordinals[i], m_OrdinalBase) : writer.AddString(m_Exports[i].Forwarder);
+				writer.Put<uint32_t>(functionsRVA + (ordinals[i] - m_OrdinalBase) * sizeof(uint32_t), functionRVA);
+			}
+
+			writer.Put<uint32_t>(directoryRVA + 12, moduleNameRVA);
+			writer.Put<uint32_t>(directoryRVA + 16, m_OrdinalBase);
+			writer.Put<uint32_t>(directoryRVA + 20, functionCount);
+			writer.Put<uint32_t>(directoryRVA + 24, static_cast<uint32_t>(names.size()));
+			writer.Put<uint32_t>(directoryRVA + 28, functionsRVA);
+			writer.Put<uint32_t>(directoryRVA + 32, namesRVA);
+			writer.Put<uint32_t>(directoryRVA + 36, nameOrdinalsRVA);
+			exportDirectory = {directoryRVA, writer.GetRVA() - directoryRVA};
+		}
+
+		PE::DataDirectory importDirectory;
+		if (!m_Imports.empty())
+		{
+			const size_t thunkSize = m_Is64Bit ? sizeof(uint64_t) : sizeof(uint32_t);
+			const uint64_t ordinalFlag = m_Is64Bit ? uint64_t(1) << 63 : uint64_t(1) << 31;
+
+			writer.Align(8);
+			const uint32_t descriptorsRVA = writer.Reserve((m_Imports.size() + 1) * PE::ImageReader::ImportDescriptorSize);
+			for (size_t i = 0; i < m_Imports.size(); i++)
+			{
+				const Import& import = m_Imports[i];
+				const uint32_t moduleNameRVA = import.WithoutName ? 0 : writer.AddString(import.ModuleName);
+
+				std::vector<uint64_t> thunks;
+				for (const std::string& name: import.Names)
+				{
+					writer.Align(2);
+					const uint32_t hintNameRVA = writer.Reserve(sizeof(uint16_t));
+					writer.AddString(name);
+					thunks.push_back(hintNameRVA);
+				}
+				for (uint16_t ordinal: import.Ordinals)
+				{
+					thunks.push_back(ordinalFlag|ordinal);
+				}
+
+				// Lookup and address tables have the same contents until the loader binds the imports
+				uint32_t tableRVAs[2] = {};
+				for (uint32_t& tableRVA: tableRVAs)
+				{
+					writer.Align(8);
+					tableRVA = writer.Reserve((thunks.size() + 1) * thunkSize);
+					for (size_t j = 0; j < thunks.size(); j++)
+					{
+						if (m_Is64Bit)
+						{
+							writer.Put<uint64_t>(static_cast<uint32_t>(tableRVA + j * thunkSize), thunks[j]);
+						}
+						else
+						{
+							writer.Put<uint32_t>(static_cast<uint32_t>(tableRVA + j * thunkSize), static_cast<uint32_t>(thunks[j]));
+						}
+					}
+				}
+
+				const uint32_t descriptorRVA = static_cast<uint32_t>(descriptorsRVA + i * PE::ImageReader::ImportDescriptorSize);
+				writer.Put<uint32_t>(descriptorRVA, tableRVAs[0]);
+				writer.Put<uint32_t>(descriptorRVA + 12, moduleNameRVA);
+				writer.Put<uint32_t>(descriptorRVA + 16, tableRVAs[1]);
+			}
+			importDirectory = {descriptorsRVA, static_cast<uint32_t>((m_Imports.size() + 1) * PE::ImageReader::ImportDescriptorSize)};
+		}
+
+		const uint32_t virtualSize = std::max<uint32_t>(static_cast<uint32_t>(section.size()), 1);
+		const uint32_t rawSize = AlignUp(virtualSize, g_FileAlignment);
+		const uint32_t imageSize = g_SectionRVA + AlignUp(virtualSize, g_SectionAlignment);
+		section.resize(rawSize);
+
+		// Headers
+		std::vector<std::byte> headers(g_HeadersSize);
+		Writer headersWriter(headers);
+		headersWriter.Put<uint16_t>(0, 0x5A4D);
+		headersWriter.Put<uint32_t>(0x3C, g_NTHeadersOffset);
+		headersWriter.Put<uint32_t>(g_NTHeadersOffset, 0x00004550);
+
+		const uint16_t optionalHeaderSize = m_Is64Bit ? 240 : 224;
+		const uint32_t fileHeader = g_NTHeadersOffset + 4;
+		headersWriter.Put<uint16_t>(fileHeader, m_Is64Bit ? 0x8664 : 0x14C);
+		headersWriter.Put<uint16_t>(fileHeader + 2, 1);
+		headersWriter.Put<uint16_t>(fileHeader + 16, optionalHeaderSize);
+		headersWriter.Put<uint16_t>(fileHeader + 18, 0x2022);
+
+		const uint32_t optionalHeader = fileHeader + 20;
+		headersWriter.Put<uint16_t>(optionalHeader, m_Is64Bit ? 0x20B : 0x10B);
+		if (m_Is64Bit)
+		{
+			headersWriter.Put<uint64_t>(optionalHeader + 24, 0x180000000);
+		}
+		else
+		{
+			headersWriter.Put<uint32_t>(optionalHeader + 28, 0x10000000);
+		}
+		headersWriter.Put<uint32_t>(optionalHeader + 32, g_SectionAlignment);
+		headersWriter.Put<uint32_t>(optionalHeader + 36, g_FileAlignment);
+		headersWriter.Put<uint32_t>(optionalHeader + 56, imageSize);
+		headersWriter.Put<uint32_t>(optionalHeader + 60, g_HeadersSize);
+
+		const uint32_t directoryCount = optionalHeader + (m_Is64Bit ? 108 : 92);
+		headersWriter.Put<uint32_t>(directoryCount, static_cast<uint32_t>(PE::ImageReader::MaxDirectoryCount));
+		headersWriter.Put<uint32_t>(directoryCount + 4, exportDirectory.RVA);
+		headersWriter.Put<uint32_t>(directoryCount + 8, exportDirectory.Size);
+		headersWriter.Put<uint32_t>(directoryCount + 12, importDirectory.RVA);
+		headersWriter.Put<uint32_t>(directoryCount + 16, importDirectory.Size);
+
+		const uint32_t sectionHeader = optionalHeader + optionalHeaderSize;
+		std::memcpy(headers.data() + sectionHeader, ".rdata", 6);
+		headersWriter.Put<uint32_t>(sectionHeader + 8, virtualSize);
+		headersWriter.Put<uint32_t>(sectionHeader + 12, g_SectionRVA);
+		headersWriter.Put<uint32_t>(sectionHeader + 16, rawSize);
+		headersWriter.Put<uint32_t>(sectionHeader + 20, g_HeadersSize);
+		headersWriter.Put<uint32_t>(sectionHeader + 36, 0x40000040);
+
+		// The file has the section right after the headers, the mapped image has it at its RVA
+		const uint32_t sectionOffset = layout == PE::Layout::Image ? g_SectionRVA : g_HeadersSize;
+		std::vector<std::byte> result(layout == PE::Layout::Image ? imageSize : g_HeadersSize + rawSize);
+		std::ranges::copy(headers, result.begin());
+		std::ranges::copy(section, result.begin() + sectionOffset);
+		return result;
+	}
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include "PortableExecutable.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Builds small PE images in memory for the parser tests: PE32 or PE32+ with a single section holding the export
+// and import directories. Exports which aren't forwarded get made-up RVAs past the end of the image.
+namespace xSE::Testing
+{
+	class ImageBuilder final
+	{
+		public:
+			// RVA of the export with the ordinal base, the following ordinals are 16 bytes apart
+			static constexpr uint32_t FunctionRVABase = 0x100000;
+
+			struct Export final
+			{
+				// Empty for the functions exported only by ordinal
+				std::string Name;
+
+				// Assigned in the order of addition if zero
+				uint32_t Ordinal = 0;
+
+				// 'Library.Function', the export is forwarded if it's not empty
+				std::string Forwarder;
+			};
+			struct Import final
+			{
+				std::string ModuleName;
+				std::vector<std::string> Names;
+				std::vector<uint16_t> Ordinals;
+
+				// Writes a malformed descriptor with a zero name RVA but valid thunks
+				bool WithoutName = false;
+			};
+
+		private:
+			bool m_Is64Bit = true;
+			std::string m_ModuleName = "test.dll";
+			uint32_t m_OrdinalBase = 1;
+			std::vector<Export> m_Exports;
+			std::vector<Import> m_Imports;
+
+		public:
+			ImageBuilder(bool is64Bit = true) noexcept
+				:m_Is64Bit(is64Bit)
+			{
+			}
+
+		public:
+			static uint32_t GetFunctionRVA(uint32_t ordinal, uint32_t ordinalBase = 1) noexcept
+			{
+				return FunctionRVABase + (ordinal - ordinalBase) * 16;
+			}
+
+			ImageBuilder& SetModuleName(std::string name)
+			{
+				m_ModuleName = std::move(name);
+				return *this;
+			}
+			ImageBuilder& SetOrdinalBase(uint32_t ordinalBase) noexcept
+			{
+				m_OrdinalBase = ordinalBase;
+				return *this;
+			}
+			ImageBuilder& AddExport(std::string name, uint32_t ordinal = 0)
+			{
+				m_Exports.push_back({std::move(name), ordinal, {}});
+				return *this;
+			}
+			ImageBuilder& AddForwardedExport(std::string name, std::string forwarder, uint32_t ordinal = 0)
+			{
+				m_Exports.push_back({std::move(name), ordinal, std::move(forwarder)});
+				return *this;
+			}
+			ImageBuilder& AddImport(Import import)
+			{
+				m_Imports.emplace_back(std::move(import));
+				return *this;
+			}
+
+			std::vector<std::byte> Build(PE::Layout layout) const;
+	};
+}
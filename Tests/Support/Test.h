@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <type_traits>
+
+// Minimal test harness. Every test executable links 'TestMain.cpp', which runs all the registered tests
+// (or only those whose names contain the command line argument) and returns non-zero if any check failed.
+namespace xSE::Testing
+{
+	using TestFunction = void(*)();
+
+	class Registrar final
+	{
+		public:
+			Registrar(std::string_view name, TestFunction func);
+	};
+
+	void ReportFailure(const char* file, int line, std::string_view expression, std::string_view details = {});
+
+	template<class T>
+	std::string ToString(const T& value)
+	{
+		if constexpr(std::is_enum_v<T>)
+		{
+			return std::to_string(static_cast<std::underlying_type_t<T>>(value));
+		}
+		else if constexpr(requires(std::ostream& stream, const T& item) { stream << item; })
+		{
+			std::ostringstream stream;
+			stream << value;
+			return stream.str();
+		}
+		else
+		{
+			return "<value>";
+		}
+	}
+
+	template<class TLeft, class TRight>
+	bool CheckEqual(const char* file, int line, const char* expression, const TLeft& left, const TRight& right)
+	{
+		if (left == right)
+		{
+			return true;
+		}
+		ReportFailure(file, line, expression, ToString(left) + " != " + ToString(right));
+		return false;
+	}
+}
+
+#define XSE_TEST(name)	\
+	static void name();	\
+	static const xSE::Testing::Registrar name##_Registrar(#name, &name);	\
+	static void name()
+
+#define XSE_CHECK(expression)	\
+	((expression) ? true : (xSE::Testing::ReportFailure(__FILE__, __LINE__, #expression), false))
+
+#define XSE_CHECK_EQUAL(left, right)	\
+	xSE::Testing::CheckEqual(__FILE__, __LINE__, #left " == " #right, (left), (right))
+
+// Stops the current test if the check fails, for the checks the rest of the test depends on
+#define XSE_REQUIRE(expression)	\
+	if (!XSE_CHECK(expression))	\
+	{	\
+		return;	\
+	}
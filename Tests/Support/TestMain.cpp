@@ -0,0 +1,79 @@
+#include "Test.h"
+#include <cstdio>
+#include <exception>
+#include <vector>
+
+namespace
+{
+	struct TestCase final
+	{
+		std::string_view Name;
+		xSE::Testing::TestFunction Function = nullptr;
+	};
+
+	std::vector<TestCase>& GetTestCases()
+	{
+		static std::vector<TestCase> testCases;
+		return testCases;
+	}
+
+	size_t g_FailureCount = 0;
+}
+
+namespace xSE::Testing
+{
+	Registrar::Registrar(std::string_view name, TestFunction func)
+	{
+		GetTestCases().push_back({name, func});
+	}
+
+	void ReportFailure(const char* file, int line, std::string_view expression, std::string_view details)
+	{
+		g_FailureCount++;
+		if (details.empty())
+		{
+			std::fprintf(stderr, "%s(%d): check failed: %.*s\n", file, line, static_cast<int>(expression.size()), expression.data());
+		}
+		else
+		{
+			std::fprintf(stderr, "%s(%d): check failed: %.*s (%.*s)\n", file, line, static_cast<int>(expression.size()), expression.data(), static_cast<int>(details.size()), details.data());
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const std::string_view filter = argc > 1 ? argv[1] : "";
+
+	size_t failedTests = 0;
+	size_t testCount = 0;
+	for (const TestCase& testCase: GetTestCases())
+	{
+		if (!filter.empty() && testCase.Name.find(filter) == std::string_view::npos)
+		{
+			continue;
+		}
+		testCount++;
+
+		const size_t failuresBefore = g_FailureCount;
+		try
+		{
+			testCase.Function();
+		}
+		catch (const std::exception& e)
+		{
+			xSE::Testing::ReportFailure(__FILE__, __LINE__, testCase.Name, e.what());
+		}
+		catch (...)
+		{
+			xSE::Testing::ReportFailure(__FILE__, __LINE__, testCase.Name, "unknown exception");
+		}
+
+		const bool passed = g_FailureCount == failuresBefore;
+		failedTests += passed ? 0 : 1;
+		std::printf("[%s] %.*s\n", passed ? "  OK  " : "FAILED", static_cast<int>(testCase.Name.size()), testCase.Name.data());
+	}
+
+	std::printf("%zu tests, %zu failed\n", testCount, failedTests);
+	return failedTests == 0 && testCount != 0 ? 0 : 1;
+}
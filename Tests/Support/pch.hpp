@@ -0,0 +1,19 @@
+#pragma once
+
+// Replaces 'Source/pch.hpp' for the platform-neutral components built on other platforms. The real one pulls in
+// Windows headers and KxFramework, which these components don't use, but they rely on it for the standard headers.
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
@@ -0,0 +1,304 @@
+#include "Test.h"
+#include "TraceEventWriter.h"
+#include <algorithm>
+#include <thread>
+
+using namespace xSE;
+using namespace std::chrono_literals;
+
+namespace
+{
+	// Strict enough JSON reader to tell whether the trace loads, collects every decoded string along the way
+	class JSONReader final
+	{
+		private:
+			std::string_view m_Text;
+			size_t m_Offset = 0;
+
+		public:
+			std::vector<std::string> Strings;
+
+		private:
+			void SkipSpace() noexcept
+			{
+				while (m_Offset < m_Text.size() && (m_Text[m_Offset] == ' ' || m_Text[m_Offset] == '\n' || m_Text[m_Offset] == '\r' || m_Text[m_Offset] == '\t'))
+				{
+					m_Offset++;
+				}
+			}
+			bool Consume(char c) noexcept
+			{
+				SkipSpace();
+				if (m_Offset < m_Text.size() && m_Text[m_Offset] == c)
+				{
+					m_Offset++;
+					return true;
+				}
+				return false;
+			}
+			bool ReadString()
+			{
+				if (!Consume('"'))
+				{
+					return false;
+				}
+
+				std::string value;
+				while (m_Offset < m_Text.size())
+				{
+					const char c = m_Text[m_Offset++];
+					if (c == '"')
+					{
+						Strings.emplace_back(std::move(value));
+						return true;
+					}
+					else if (static_cast<unsigned char>(c) < 0x20)
+					{
+						return false;
+					}
+					else if (c != '\\')
+					{
+						value += c;
+						continue;
+					}
+
+					if (m_Offset >= m_Text.size())
+					{
+						return false;
+					}
+					switch (const char escape = m_Text[m_Offset++])
+					{
+						case '"':
+						case '\\':
+						case '/':
+						{
+							value += escape;
+							break;
+						}
+						case 'n':
+						{
+							value += '\n';
+							break;
+						}
+						case 'r':
+						{
+							value += '\r';
+							break;
+						}
+						case 't':
+						{
+							value += '\t';
+							break;
+						}
+						case 'u':
+						{
+							if (m_Text.size() - m_Offset < 4)
+							{
+								return false;
+							}
+							const auto code = std::stoul(std::string(m_Text.substr(m_Offset, 4)), nullptr, 16);
+							if (code > 0x7F)
+							{
+								return false;
+							}
+							value += static_cast<char>(code);
+							m_Offset += 4;
+							break;
+						}
+						default:
+						{
+							return false;
+						}
+					};
+				}
+				return false;
+			}
+			bool ReadNumber() noexcept
+			{
+				SkipSpace();
+				const size_t start = m_Offset;
+				while (m_Offset < m_Text.size() && std::string_view("-+.eE0123456789").find(m_Text[m_Offset]) != std::string_view::npos)
+				{
+					m_Offset++;
+				}
+				return m_Offset != start;
+			}
+			bool ReadValue()
+			{
+				SkipSpace();
+				if (m_Offset >= m_Text.size())
+				{
+					return false;
+				}
+
+				if (Consume('{'))
+				{
+					if (Consume('}'))
+					{
+						return true;
+					}
+					do
+					{
+						if (!ReadString() || !Consume(':') || !ReadValue())
+						{
+							return false;
+						}
+					}
+					while (Consume(','));
+					return Consume('}');
+				}
+				else if (Consume('['))
+				{
+					if (Consume(']'))
+					{
+						return true;
+					}
+					do
+					{
+						if (!ReadValue())
+						{
+							return false;
+						}
+					}
+					while (Consume(','));
+					return Consume(']');
+				}
+				else if (m_Text[m_Offset] == '"')
+				{
+					return ReadString();
+				}
+				return ReadNumber();
+			}
+
+		public:
+			JSONReader(std::string_view text) noexcept
+				:m_Text(text)
+			{
+			}
+
+		public:
+			bool Read()
+			{
+				if (ReadValue())
+				{
+					SkipSpace();
+					return m_Offset == m_Text.size();
+				}
+				return false;
+			}
+			bool Contains(std::string_view value) const
+			{
+				return std::ranges::find(Strings, value) != Strings.end();
+			}
+	};
+}
+
+XSE_TEST(DisabledWriterRecordsNothing)
+{
+	TraceEventWriter writer(100);
+	writer.AddComplete("Load", "Plugin", writer.GetStartTime(), writer.GetStartTime() + 1ms, 1);
+	writer.AddInstant("Triggered", "Hook", 1);
+	writer.SetThreadName(1, "Main");
+	{
+		auto scope = writer.BeginScope("Probe", "Plugin", 1);
+	}
+
+	XSE_CHECK(!writer.IsEnabled());
+	XSE_CHECK_EQUAL(writer.GetCount(), 0u);
+
+	const std::string json = writer.Serialize();
+	JSONReader reader(json);
+	XSE_CHECK(reader.Read());
+}
+
+XSE_TEST(SerializesLoadableTrace)
+{
+	TraceEventWriter writer(4242);
+	writer.Enable();
+
+	const auto startTime = writer.GetStartTime() + 1234567ns;
+	writer.SetThreadName(7, "Main thread");
+	writer.AddComplete("Plugin.dll", "Load", startTime, startTime + 2500us, 7);
+	writer.AddInstant("Triggered", "Hook", 8);
+	{
+		auto scope = writer.BeginScope("Probe", "Scan", 9);
+	}
+	XSE_CHECK_EQUAL(writer.GetCount(), 4u);
+
+	const std::string json = writer.Serialize();
+	JSONReader reader(json);
+	XSE_REQUIRE(reader.Read());
+	XSE_CHECK(reader.Contains("traceEvents"));
+	XSE_CHECK(reader.Contains("thread_name"));
+	XSE_CHECK(reader.Contains("Main thread"));
+	XSE_CHECK(reader.Contains("Plugin.dll"));
+	XSE_CHECK(reader.Contains("Probe"));
+
+	// Microseconds with the nanoseconds kept as a fraction
+	XSE_CHECK(json.find("\"pid\":4242,\"tid\":7,\"ts\":1234.567,\"name\":\"Plugin.dll\",\"cat\":\"Load\",\"dur\":2500.000}") != std::string::npos);
+	XSE_CHECK(json.find("\"droppedEvents\":0") != std::string::npos);
+}
+
+XSE_TEST(EscapesNames)
+{
+	TraceEventWriter writer;
+	writer.Enable();
+
+	const std::string name = "C:\\Games\\Fallout 4\\Data\\F4SE\\Plugins\\\"quoted\".dll\n\t\x01\x1F end \xD0\x9F";
+	writer.AddComplete(name, "Load", writer.GetStartTime(), writer.GetStartTime(), 1);
+
+	const std::string json = writer.Serialize();
+	JSONReader reader(json);
+	XSE_REQUIRE(reader.Read());
+	XSE_CHECK(reader.Contains(name));
+}
+
+XSE_TEST(DropsEventsAboveLimit)
+{
+	TraceEventWriter writer;
+	writer.Enable(3);
+	for (size_t i = 0; i < 5; i++)
+	{
+		writer.AddInstant("Event", "Test", 1);
+	}
+
+	XSE_CHECK_EQUAL(writer.GetCount(), 3u);
+	XSE_CHECK_EQUAL(writer.GetDroppedCount(), 2u);
+
+	const std::string json = writer.Serialize();
+	XSE_CHECK(JSONReader(json).Read());
+	XSE_CHECK(json.find("\"droppedEvents\":2") != std::string::npos);
+}
+
+XSE_TEST(ConcurrentWriters)
+{
+	constexpr size_t threadCount = 8;
+	constexpr size_t eventCount = 1000;
+
+	TraceEventWriter writer;
+	writer.Enable(threadCount * eventCount);
+
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < threadCount; i++)
+	{
+		threads.emplace_back([&writer, i]()
+		{
+			for (size_t j = 0; j < eventCount; j++)
+			{
+				auto scope = writer.BeginScope("Thread" + std::to_string(i), "Test", static_cast<uint32_t>(i));
+			}
+		});
+	}
+	for (std::thread& thread: threads)
+	{
+		thread.join();
+	}
+
+	XSE_CHECK_EQUAL(writer.GetCount(), threadCount * eventCount);
+	XSE_CHECK_EQUAL(writer.GetDroppedCount(), 0u);
+
+	const std::string json = writer.Serialize();
+	JSONReader reader(json);
+	XSE_REQUIRE(reader.Read());
+	XSE_CHECK_EQUAL(static_cast<size_t>(std::ranges::count(reader.Strings, "Thread3")), eventCount);
+}
@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+"""
+Generates everything that depends on the export list of a proxied library from a single manifest.
+
+Every 'Source/ProxyFunctions/<Library>.exports' file lists the exports of the library, one name per line, in ordinal order.
+Empty lines and lines starting with '#' are ignored. For each manifest the script writes:
+
+	- 'Source/ProxyFunctions/<Library>.h': export indices enum, exports count and names, used by 'LoadOriginalLibraryFunctions'
+	  and to size 'g_OriginalFunctions' table.
+	- 'Source/ProxyFunctions/<Library>.inc': forwarding thunks list, included by 'ProxyThunks.asm'.
+	- 'Exports/<Library>.def': module definition file.
+
+Additionally 'Source/ProxyFunctions/ProxyLibrary.h' and 'ProxyLibrary.inc' select one of the libraries for C++ and assembly code
+depending on 'xSE_PROXY_LIBRARY_<Library>' define, which is set from 'xSEProxyLibrary' MSBuild property.
+
+Usage:
+	GenerateProxyFunctions.py          Regenerates all files.
+	GenerateProxyFunctions.py --check  Only verifies that the files are up to date, exits with code 1 if they aren't.
+"""
+
+import argparse
+import pathlib
+import re
+import sys
+
+RootDirectory = pathlib.Path(__file__).resolve().parent.parent
+ManifestDirectory = RootDirectory / "Source" / "ProxyFunctions"
+ExportsDirectory = RootDirectory / "Exports"
+
+IdentifierPattern = re.compile(r"^[A-Za-z_][A-Za-z0-9_]*$")
+
+def ReadManifest(path):
+	names = []
+	for lineNumber, line in enumerate(path.read_text(encoding = "utf-8").splitlines(), 1):
+		line = line.strip()
+		if not line or line.startswith("#"):
+			continue
+
+		if not IdentifierPattern.match(line):
+			raise ValueError(f"{path.name}:{lineNumber}: '{line}' is not a valid export name")
+		if line in names:
+			raise ValueError(f"{path.name}:{lineNumber}: '{line}' is listed more than once")
+		names.append(line)
+
+	if not names:
+		raise ValueError(f"{path.name}: no exports listed")
+	return names
+
+def GenerateHeader(library, names):
+	lines = [
+		f"// Generated by 'Tools/GenerateProxyFunctions.py' from '{library}.exports', don't edit manually",
+		"#pragma once",
+		"",
+		f"namespace xSE::PluginPreloader::Library::{library}",
+		"{",
+		"\tenum Enum",
+		"\t{",
+		",\n".join(f"\t\t{name}" for name in names),
+		"\t};",
+		"",
+		f"\tconstexpr const char* FileName = \"{library}.dll\";",
+		f"\tconstexpr size_t Count = {len(names)};",
+		"\tconstexpr const char* Names[Count] =",
+		"\t{",
+		",\n".join(f"\t\t\"{name}\"" for name in names),
+		"\t};",
+		"};",
+		""
+	]
+	return "\n".join(lines)
+
+def GenerateThunks(library, names):
+	lines = [f"; Forwarding thunks for {library} exports, index is the position in the 'Library::{library}' enum (the ordinal minus one)"]
+	lines += [f"ProxyThunk {name}, {index}" for index, name in enumerate(names)]
+	return "\n".join(lines) + "\n"
+
+def GenerateModuleDefinition(library, names):
+	lines = [f"LIBRARY   {library}", "EXPORTS"]
+	lines += [f"\t{name}    @{index + 1}" for index, name in enumerate(names)]
+	return "\n".join(lines) + "\n"
+
+def GenerateSelectionHeader(libraries):
+	lines = [
+		"// Generated by 'Tools/GenerateProxyFunctions.py', don't edit manually",
+		"// Selects the proxied library with 'xSE_PROXY_LIBRARY_<Library>' define, see 'xSEProxyLibrary' property in the project file.",
+		"#pragma once",
+		""
+	]
+	for index, library in enumerate(libraries):
+		lines += [
+			f"#{'if' if index == 0 else 'elif'} xSE_PROXY_LIBRARY_{library}",
+			f"#include \"{library}.h\"",
+			"namespace xSE::PluginPreloader",
+			"{",
+			f"\tnamespace ProxyLibrary = Library::{library};",
+			"}",
+			""
+		]
+	lines += ["#else", "#error \"Proxy library is not selected\"", "#endif", ""]
+	return "\n".join(lines)
+
+def GenerateSelectionThunks(libraries):
+	lines = ["; Generated by 'Tools/GenerateProxyFunctions.py', don't edit manually"]
+	for index, library in enumerate(libraries):
+		lines += [f"{'IFDEF' if index == 0 else 'ELSEIFDEF'} xSE_PROXY_LIBRARY_{library}", f"\tinclude ProxyFunctions\\{library}.inc"]
+	lines += ["ELSE", "\t.err <Proxy library is not selected>", "ENDIF"]
+	return "\n".join(lines) + "\n"
+
+def CollectOutputs():
+	libraries = {}
+	for path in sorted(ManifestDirectory.glob("*.exports")):
+		libraries[path.stem] = ReadManifest(path)
+
+	outputs = {}
+	for library, names in libraries.items():
+		outputs[ManifestDirectory / f"{library}.h"] = GenerateHeader(library, names)
+		outputs[ManifestDirectory / f"{library}.inc"] = GenerateThunks(library, names)
+		outputs[ExportsDirectory / f"{library}.def"] = GenerateModuleDefinition(library, names)
+
+	outputs[ManifestDirectory / "ProxyLibrary.h"] = GenerateSelectionHeader(libraries)
+	outputs[ManifestDirectory / "ProxyLibrary.inc"] = GenerateSelectionThunks(libraries)
+	return outputs
+
+def Main():
+	parser = argparse.ArgumentParser(description = "Generates proxy export tables from 'Source/ProxyFunctions/*.exports' manifests")
+	parser.add_argument("--check", action = "store_true", help = "verify that the generated files are up to date without writing them")
+	arguments = parser.parse_args()
+
+	try:
+		outputs = CollectOutputs()
+	except ValueError as error:
+		print(f"Error: {error}", file = sys.stderr)
+		return 2
+
+	staleCount = 0
+	for path, content in outputs.items():
+		current = path.read_text(encoding = "utf-8") if path.exists() else None
+		if current == content:
+			continue
+
+		staleCount += 1
+		if arguments.check:
+			print(f"Out of date: {path.relative_to(RootDirectory)}")
+		else:
+			with open(path, "w", encoding = "utf-8", newline = "\n") as stream:
+				stream.write(content)
+			print(f"Updated: {path.relative_to(RootDirectory)}")
+
+	if arguments.check and staleCount != 0:
+		return 1
+	return 0
+
+if __name__ == "__main__":
+	sys.exit(Main())